@@ -0,0 +1,31 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "problem.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum { SCENARIO_RHS, SCENARIO_COST } scenario_kind_t;
+
+// One line of a scenario file: "b v1 ... vn" replaces the RHS, "c v1 ... vm" the costs
+typedef struct scenario {
+    scenario_kind_t kind;
+    uint32_t size;   // Number of values (n for a RHS, m for the costs)
+    double* values;  // New RHS or costs (capacity max(n, m))
+} scenario_t;
+
+uint32_t scenario_init(scenario_t* scenario_ptr, uint32_t n, uint32_t m);
+
+// Reads the next scenario of stream. Returns 0 at the end of the stream (*end_ptr set)
+// or if the scenario is malformed
+uint32_t scenario_read(FILE* stream, uint32_t n, uint32_t m, scenario_t* scenario_ptr, uint32_t* end_ptr);
+
+void scenario_free(scenario_t* scenario_ptr);
+
+// Solves the LP, then every scenario of stream in order. The changes add up, each scenario starting
+// from the optimal basis and factorization of the previous one: the dual simplex reoptimizes a new RHS
+// and the primal simplex new costs, without PhaseI. The problem is not presolved
+uint32_t problem_solve_batch(problem_t* problem_ptr, FILE* stream);
+
+#endif
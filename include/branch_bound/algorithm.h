@@ -1,32 +1,61 @@
 #ifndef BRANCH_BOUND_H
 #define BRANCH_BOUND_H
 
-#include "branch_bound/stack.h"
+#include "branch_bound/queue.h"
 #include "solution.h"
 #include "problem.h"
 #include "branch_bound/node.h"
+#include "branch_bound/arena.h"
+#include "branch_bound/worker.h"
+#include "simplex/workspace.h"
 
-#define MAX_N 500
-#define MAX_M 500
+// Nodes between two progress lines of the branch and bound
+#define BB_LOG_PERIOD 1000
 
-uint32_t init(const problem_t* problem_ptr, pstack_t* stack_ptr, bb_arena_t* arena_ptr, var_arr_t* var_arr_ptr);
+typedef uint32_t (*solve_fn)(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                             const gsl_vector* b, const var_arr_t* var_arr_ptr, int32_t* B, int32_t* N,
+                             var_state_t* state, const options_t* opts_ptr, simplex_workspace_t* workspace_ptr,
+                             solution_t* solution_ptr, uint32_t* iter_n_ptr);
 
-typedef uint32_t (*solve_fn)(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const gsl_matrix* A,
-                             const gsl_vector* b, int32_t* B, int32_t* N, solution_t* solution_ptr,
-                             uint32_t* iter_n_ptr);
-
-uint32_t solve_relaxation(solve_fn solver, uint32_t is_max, bb_node_t* node_ptr, int32_t* N, solution_t* solution_ptr,
+// Solves the relaxation of the node loaded in the arena, from the basis B, N of the arena
+uint32_t solve_relaxation(solve_fn solver, uint32_t is_max, bb_arena_t* arena_ptr, uint32_t n, uint32_t m, int32_t* N,
+                          const options_t* opts_ptr, simplex_workspace_t* workspace_ptr, solution_t* solution_ptr,
                           uint32_t* iter_n_ptr);
 
-// Choses a non-integer variable to start branching from.
-// Returns -2 on error, -1 if the solution contains only
-// integers or the index of the first non-integer
-// variable on success
-int32_t select_branch_var(const var_arr_t* var_arr_ptr, const solution_t* current_sol_ptr);
-
-uint32_t update(solution_t* best_solution, solution_t* current_solution, bb_node_t* current_node, pstack_t* stack_ptr);
-
-// Branch and bound method on linear problem p
+// Bound on the value of the child of the node loaded in the worker that moves the variable var from value in the
+// direction, after at most BB_STRONG_ITER dual simplex iterations from basis_ptr, the optimal basis of the node.
+// *z_ptr is -INFINITY when the child is infeasible
+uint32_t bb_strong_branch(bb_worker_t* worker_ptr, const bb_basis_t* basis_ptr, uint32_t var, double value,
+                          bb_direction_t direction, double* z_ptr);
+
+// Choses the non-integer variable to branch on, the one with the best product score of the gains of its children.
+// The gains come from the pseudocosts once they are reliable; before that the most promising candidates are
+// strong branched, which also feeds their pseudocosts. Returns -1 if the solution contains only integers or the
+// index of the variable on success
+int32_t select_branch_var(bb_worker_t* worker_ptr, const solution_t* current_sol_ptr);
+
+// Estimated value of the best integer solution below the child in the direction on branch_var of a node with
+// relaxation solution_ptr: its value minus the pseudocost degradation of the child, PC_down * f or PC_up * (1 - f),
+// and the cheaper degradation of every other fractional integer variable. A variable without an observation in
+// a direction it needs costs |c_j| * min(f, 1 - f) instead
+double bb_estimate(bb_pseudocost_t* pseudocost_ptr, const var_arr_t* var_arr_ptr, const gsl_vector* c,
+                   const solution_t* solution_ptr, uint32_t branch_var, bb_direction_t direction);
+
+// Replaces the node, whose relaxation is solution_ptr, by its two children on the variable branch_var. The plunge
+// keeps the child on the side the variable rounds to in node_ptr and sets *is_diving_ptr, the other children go
+// to the open nodes of the worker
+uint32_t bb_branch(bb_worker_t* worker_ptr, bb_node_t* node_ptr, const var_arr_t* var_arr_ptr, const gsl_vector* c,
+                   const solution_t* solution_ptr, int32_t branch_var, uint32_t* is_diving_ptr);
+
+// Solves the relaxation of the node on the arena of the worker, then prunes it, offers it as the incumbent or
+// branches on it
+uint32_t bb_solve_node(bb_worker_t* worker_ptr, bb_node_t* node_ptr, solution_t* current_ptr,
+                       uint32_t* is_diving_ptr);
+
+// Explores nodes, its own or stolen from the other workers, until no node is open in the search
+void* bb_worker_run(void* arg);
+
+// Branch and bound method on linear problem p, with one worker per thread of the parallel pool
 uint32_t branch_and_bound(problem_t* problem_ptr, solution_t* solution_ptr);
 
-#endif
\ No newline at end of file
+#endif
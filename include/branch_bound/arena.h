@@ -2,38 +2,59 @@
 #define BB_ARENA_H
 
 #include "problem.h"
+#include "sparse.h"
+#include "variable.h"
+#include "branch_bound/node.h"
 
 #include <stdio.h>
 #include <stdint.h>
 #include <gsl/gsl_vector.h>
-#include <gsl/gsl_matrix.h>
 
+// Working copy of the relaxation that the nodes are solved on. A node is loaded by undoing the bound changes of
+// the previous one and replaying its own
 typedef struct bb_arena {
     double* data;
     size_t max_n;
     size_t max_m;
     double* c_base;
-    double* A_base;
     double* b_base;
+    csc_matrix_t A;
 
     int32_t* B;
+    var_state_t* state;
+
+    var_arr_t var_arr;     // Variables with the bounds of the loaded node
+    variable_t* root;      // Variables with the bounds of the root (size max_m)
+    uint32_t* touched;     // Variables whose bounds the loaded node changed (size max_m)
+    uint8_t* is_touched;   // Boolean value of every variable in touched (size max_m)
+    uint32_t touched_n;    // Number of variables in touched
 } bb_arena_t;
 
 uint32_t bb_arena_init(bb_arena_t* arena_ptr, size_t max_n, size_t max_m);
 
-void bb_arena_copy_problem(bb_arena_t* arena_ptr, const problem_t* problem_ptr);
+uint32_t bb_arena_copy_problem(bb_arena_t* arena_ptr, const problem_t* problem_ptr);
 
 // Creates view to cost vector c of size (m + n). arena_ptr must not be null
 gsl_vector_view bb_arena_get_c_view(const bb_arena_t* arena_ptr, size_t m, size_t n);
 
-// Creates view to constraint matrix A of size (n x (m + n)). arena_ptr must not be null
-gsl_matrix_view bb_arena_get_A_view(const bb_arena_t* arena_ptr, size_t n, size_t m);
+// Returns the sparse constraint matrix A, resized to n x m. arena_ptr must not be null
+csc_matrix_t* bb_arena_get_A_view(bb_arena_t* arena_ptr, size_t n, size_t m);
 
 // Creates view to RHS vector b of size n. arena_ptr must not be null
 gsl_vector_view bb_arena_get_b_view(const bb_arena_t* arena_ptr, size_t n);
 
 int32_t* bb_arena_get_B_view(const bb_arena_t* arena_ptr, size_t n);
 
+// Returns the simplex state of the variables (size max_m + max_n). arena_ptr must not be null
+var_state_t* bb_arena_get_state_view(const bb_arena_t* arena_ptr);
+
+// Returns the variables with the bounds of the loaded node. arena_ptr must not be null
+var_arr_t* bb_arena_get_var_arr_view(bb_arena_t* arena_ptr);
+
+// Loads the bounds of the node into the variables: the changes of the previous node are undone, the ones of
+// node_ptr replayed in order, so it costs the depth of the two nodes rather than the number of variables
+void bb_arena_load_node(bb_arena_t* arena_ptr, const bb_node_t* node_ptr);
+
 void bb_arena_free(bb_arena_t* arena_ptr);
 
 #endif
\ No newline at end of file
@@ -1,39 +1,64 @@
 #ifndef BB_NODE_H
 #define BB_NODE_H
 
-#include "branch_bound/arena.h"
 #include "variable.h"
-#include "problem.h"
 
-#include <gsl/gsl_vector.h>
-#include <gsl/gsl_matrix.h>
+#include <stdint.h>
 
-struct bb_node_state {
-    uint32_t n;
-    uint32_t m;
-};
+// Relative distance from the incumbent under which a bound cannot improve it
+#define BB_PRUNE_TOL 1e-9
 
-void bb_node_state_init(struct bb_node_state* state_ptr, uint32_t n, uint32_t m);
+// Bound a branching puts on a variable
+typedef struct bb_bound_change {
+    double bound;    // New bound of the variable
+    uint32_t var;    // Index of the variable
+    char direction;  // 'L' for a lower bound, 'U' for an upper bound
+} bb_bound_change_t;
 
+// Final basis of a relaxation, shared by the children of its node, which restart the dual simplex from it.
+// It is freed when the last reference is released
+typedef struct bb_basis {
+    uint32_t ref_n;       // Nodes and workers referencing the basis (atomic)
+    int32_t* B;           // Basic variables (size n)
+    int32_t* N;           // Nonbasic variables (size m - n)
+    var_state_t* state;   // States of the variables (size m)
+} bb_basis_t;
+
+// Open node of the branch and bound tree. Values are in the max sense, like the z of the relaxations.
+// The node only keeps the bound changes of the branchings from the root, in order, which replayed on the
+// bounds of the root give its relaxation
 typedef struct bb_node {
-    struct bb_node_state state;
-    gsl_vector_view c_view;
-    gsl_matrix_view A_view;
-    gsl_vector_view b_view;
-    int32_t* B_view;
-    struct bb_node_state parent_state;
+    double bound;                 // Optimal value of the parent relaxation, which the node cannot exceed
+    double estimate;              // Estimated value of the best integer solution below the node
+    uint32_t depth;               // Number of branchings from the root
+    double distance;              // Distance the last branching moves its variable from the parent relaxation
+    bb_bound_change_t* changes;   // Bound change of every branching from the root (size depth)
+    bb_basis_t* basis_ptr;        // Optimal basis of the parent relaxation, NULL for the root
 } bb_node_t;
 
-uint32_t bb_node_init_root(bb_node_t* node_ptr, uint32_t n, uint32_t m, const bb_arena_t* arena_ptr);
+// Copies the basis B, N, state into a new basis with one reference, held by the caller
+bb_basis_t* bb_basis_create(uint32_t n, uint32_t m, const int32_t* B, const int32_t* N, const var_state_t* state);
+
+bb_basis_t* bb_basis_retain(bb_basis_t* basis_ptr);
+
+// Drops a reference, freeing the basis with the last one. NULL is ignored
+void bb_basis_release(bb_basis_t* basis_ptr);
+
+// Copies the basis into B, N, state
+void bb_basis_load(const bb_basis_t* basis_ptr, uint32_t n, uint32_t m, int32_t* B, int32_t* N, var_state_t* state);
+
+// Creates the root node, which changes no bound
+void bb_node_init_root(bb_node_t* node_ptr, double bound);
 
-uint32_t bb_node_init(bb_node_t* node_ptr, uint32_t n, uint32_t m, const bb_arena_t* arena_ptr,
-                      struct bb_node_state parent_state);
+// Creates the child of parent_ptr that adds a bound on the variable with index branch_var_index and restarts
+// from basis_ptr, the optimal basis of the parent, which it takes a reference to.
+// Direction can either be 'L' (Lower bound, x >= ceil(value)) or 'U' (Upper bound, x <= floor(value))
+uint32_t bb_node_branch(bb_node_t* child_ptr, const bb_node_t* parent_ptr, uint32_t branch_var_index, double value,
+                        char direction, double bound, double estimate, bb_basis_t* basis_ptr);
 
-// Adds a bound on the variable with index branch_var_index.
-// Direction can either be 'L' (Lower bound) or 'U' (Upper bound)
-uint32_t bb_node_branch(bb_node_t* node_ptr, const bb_arena_t* arena_ptr, int32_t branch_var_index, double bound,
-                        char direction, var_arr_t* var_arr_ptr);
+// Boolean value to know if a node bounded by bound cannot improve the incumbent (-INFINITY when there is none)
+uint32_t bb_node_is_pruned(double bound, double incumbent);
 
-uint32_t bb_node_revert_to_parent(bb_node_t* node_ptr, const bb_arena_t* arena_ptr);
+void bb_node_free(bb_node_t* node_ptr);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,52 @@
+#ifndef BB_PSEUDOCOST_H
+#define BB_PSEUDOCOST_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+// Gains observed in a direction of a variable before its pseudocost is trusted over strong branching
+#define BB_RELIABILITY 4
+// Dual simplex iterations of the relaxation of a strong branching child
+#define BB_STRONG_ITER 20
+// Unreliable candidates strong branched at a node, the most promising ones by pseudocost
+#define BB_STRONG_CANDIDATES 8
+// Smallest gain of a direction in the product score, so that a zero gain does not hide the other direction
+#define BB_SCORE_EPS 1e-6
+
+// Direction of a branching: down is the upper bound x <= floor(value) ('U'), up the lower bound x >= ceil(value)
+typedef enum { BB_DOWN, BB_UP } bb_direction_t;
+
+// Pseudocosts of the branch and bound: the average gain per unit of change in each direction of every variable,
+// that is the decrease of the relaxation value divided by the distance the branching moved the variable.
+// Shared by the workers, guarded by lock
+typedef struct bb_pseudocost {
+    double* gain[2];        // Sum of the unit gains of every variable, down and up (size var_n)
+    uint32_t* count[2];     // Number of unit gains summed (size var_n)
+    double total_gain[2];   // Sum of the unit gains of all the variables, for the ones without any yet
+    uint32_t total_count[2];
+    uint32_t var_n;
+    pthread_mutex_t lock;
+} bb_pseudocost_t;
+
+uint32_t bb_pseudocost_init(bb_pseudocost_t* pseudocost_ptr, uint32_t var_n);
+
+// Records the decrease gain of the relaxation value after moving the variable var by distance in direction
+void bb_pseudocost_update(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction, double gain,
+                          double distance);
+
+// Average unit gain of the variable in the direction. Without observations it is the average over every variable,
+// or 1 when nothing was observed yet
+double bb_pseudocost_get(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction);
+
+// Boolean value to know if the variable has at least one observation in the direction
+uint32_t bb_pseudocost_is_initialized(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction);
+
+// Boolean value to know if both directions of the variable have BB_RELIABILITY observations
+uint32_t bb_pseudocost_is_reliable(bb_pseudocost_t* pseudocost_ptr, uint32_t var);
+
+// Product score of a candidate from the gains of its two children
+double bb_score(double down_gain, double up_gain);
+
+void bb_pseudocost_free(bb_pseudocost_t* pseudocost_ptr);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef BB_QUEUE_H
+#define BB_QUEUE_H
+
+#include "options.h"
+#include "branch_bound/node.h"
+
+#include <stdint.h>
+
+// Open nodes the queue has room for before it first grows
+#define BB_QUEUE_INITIAL_CAPACITY 64
+
+// Open nodes of the branch and bound tree, in a binary max-heap on the key of the node selection rule:
+// the bound for NODE_SELECT_BOUND and NODE_SELECT_PLUNGE, the estimate for NODE_SELECT_ESTIMATE.
+// Ties go to the deepest node, which is the closest to an integer solution
+typedef struct bb_queue {
+    bb_node_t* nodes;    // Heap of the open nodes, the one to explore next at the top
+    uint32_t size;       // Number of open nodes
+    uint32_t capacity;   // Number of nodes the heap has room for
+    node_select_t rule;  // Node selection rule the heap is ordered by
+} bb_queue_t;
+
+uint32_t bb_queue_init(bb_queue_t* queue_ptr, node_select_t rule);
+uint32_t bb_queue_empty(const bb_queue_t* queue_ptr);
+uint32_t bb_queue_size(const bb_queue_t* queue_ptr);
+
+// Adds the node to the queue, which takes ownership of its bounds
+uint32_t bb_queue_push(bb_queue_t* queue_ptr, bb_node_t bb_node);
+
+// Removes the node to explore next into bb_node_ptr, which takes ownership of its bounds
+uint32_t bb_queue_pop(bb_queue_t* queue_ptr, bb_node_t* bb_node_ptr);
+
+// Best bound among the open nodes, -INFINITY when there are none
+double bb_queue_bound(const bb_queue_t* queue_ptr);
+
+// Frees the open nodes that cannot improve the incumbent. Returns their number
+uint32_t bb_queue_prune(bb_queue_t* queue_ptr, double incumbent);
+
+void bb_queue_free(bb_queue_t* queue_ptr);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef BB_WORKER_H
+#define BB_WORKER_H
+
+#include "problem.h"
+#include "solution.h"
+#include "branch_bound/arena.h"
+#include "branch_bound/queue.h"
+#include "branch_bound/pseudocost.h"
+#include "simplex/workspace.h"
+
+#include <stdint.h>
+#include <pthread.h>
+
+struct bb_search;
+
+// Thread of the tree search, with its own copy of the relaxation and its own open nodes
+typedef struct bb_worker {
+    uint32_t id;                   // Index of the worker in the search
+    bb_queue_t queue;              // Open nodes of the worker, which the idle workers steal from
+    pthread_mutex_t lock;          // Guards queue
+    bb_arena_t arena;              // Working copy of the relaxation the nodes are solved on
+    simplex_workspace_t workspace; // Factor, pricing weights and vectors of the relaxations
+    int32_t* N;                    // Nonbasis of the relaxations (size m - n)
+    bb_basis_t* basis_ptr;         // Basis the arena holds, if a node restarts from it
+    uint32_t is_factored;          // Boolean value to know if the factor of the workspace holds basis_ptr as well
+    double node_bound;             // Bound of the node being solved, -INFINITY when idle (atomic)
+    pthread_t thread;
+    struct bb_search* search_ptr;
+} bb_worker_t;
+
+// State shared by the workers of a tree search. The counters and the incumbent value are atomics, the
+// incumbent solution is guarded by best_lock
+typedef struct bb_search {
+    const problem_t* problem_ptr;
+    bb_worker_t* workers;
+    uint32_t worker_n;
+    double incumbent;             // Value of the best integer solution, -INFINITY without one (atomic)
+    solution_t best;              // Best integer solution
+    bb_pseudocost_t pseudocost;   // Unit gains of the branchings, shared by the workers
+    pthread_mutex_t best_lock;    // Guards best
+    uint32_t open_n;              // Nodes queued or being solved by some worker (atomic)
+    uint32_t node_n;              // Nodes solved (atomic)
+    uint32_t iter_n;              // Dual simplex iterations of the nodes (atomic)
+    uint32_t is_failed;           // Boolean value set by a worker that failed, which stops the others (atomic)
+} bb_search_t;
+
+// Creates the search with worker_n workers, each with its own copy of the relaxation of problem_ptr
+uint32_t bb_search_init(bb_search_t* search_ptr, const problem_t* problem_ptr, uint32_t worker_n);
+
+double bb_search_incumbent(const bb_search_t* search_ptr);
+
+// Makes the integer solution solution_ptr the incumbent if it is better, taking it over. Returns 1 if it was
+uint32_t bb_search_offer(bb_search_t* search_ptr, solution_t* solution_ptr);
+
+// Best bound among the open nodes of every worker and the nodes being solved
+double bb_search_bound(bb_search_t* search_ptr);
+
+void bb_search_free(bb_search_t* search_ptr);
+
+// Creates the worker id of the search, with its own copy of the relaxation
+uint32_t bb_worker_init(bb_worker_t* worker_ptr, bb_search_t* search_ptr, uint32_t id);
+void bb_worker_free(bb_worker_t* worker_ptr);
+
+// Optimal basis of the last relaxation the worker solved, which the arena and the factor hold, stored on first use
+// so that the children of the node can restart from it. NULL if it cannot be allocated
+bb_basis_t* bb_worker_basis(bb_worker_t* worker_ptr);
+
+// Adds a node to the open nodes of the worker, which takes ownership of its bound changes
+uint32_t bb_worker_push(bb_worker_t* worker_ptr, bb_node_t bb_node);
+
+// Takes the next open node of the worker, or else steals the best one of another worker
+uint32_t bb_worker_pop(bb_worker_t* worker_ptr, bb_node_t* bb_node_ptr);
+
+#endif
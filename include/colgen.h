@@ -0,0 +1,63 @@
+#ifndef COLGEN_H
+#define COLGEN_H
+
+#include "problem.h"
+#include "solution.h"
+#include "sparse.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Most columns an oracle can return per round
+#define COLGEN_ROUND_COLUMNS 50
+// Reduced cost a column needs to enter the master
+#define COLGEN_TOL 1e-7
+// Consecutive rounds a generated column can stay nonbasic at 0 before it is purged from the master
+#define COLGEN_MAX_AGE 5
+
+// Columns returned by a pricing oracle, with lower bound 0
+typedef struct colgen_columns {
+    csc_matrix_t A;  // Entries of the columns on the n rows of the master
+    double* c;       // Cost of every column (size COLGEN_ROUND_COLUMNS)
+    double* ub;      // Upper bound of every column, VARIABLE_INF for none (size COLGEN_ROUND_COLUMNS)
+} colgen_columns_t;
+
+uint32_t colgen_columns_init(colgen_columns_t* columns_ptr, uint32_t n);
+
+// Appends a column with length nonzeros on the master rows (sorted). Returns 0 when the round is full
+uint32_t colgen_columns_push(colgen_columns_t* columns_ptr, double c, double ub, const uint32_t* rows,
+                             const double* values, uint32_t length);
+
+void colgen_columns_free(colgen_columns_t* columns_ptr);
+
+// Pricing oracle. y (size n) are the duals of the master rows in the sense of the problem: a column a with cost c
+// improves the master when c - y * a < 0 if minimizing, > 0 if maximizing. It pushes such columns into columns_ptr
+// and returns 0 on error. Pushing no column ends the generation
+typedef uint32_t (*colgen_oracle_fn)(void* ctx, const gsl_vector* y, colgen_columns_t* columns_ptr);
+
+// Column generation on the LP problem_ptr, the restricted master. After each optimal solve the oracle prices the
+// duals and its improving columns are appended to A; the primal simplex reoptimizes from the previous basis and
+// factorization. Generated columns left nonbasic at 0 for COLGEN_MAX_AGE rounds are purged. The master is neither
+// presolved nor scaled. solution_ptr holds the columns of the model followed by the generated ones left in the master
+uint32_t problem_solve_colgen(problem_t* problem_ptr, colgen_oracle_fn oracle, void* ctx, solution_t* solution_ptr);
+
+// Oracle over a file of candidate columns: the number of columns, then each column is "cost k i1 v1 ... ik vk"
+// with its k nonzeros on the rows numbered from 1. It returns the most improving ones
+typedef struct colgen_pool {
+    csc_matrix_t A;  // Entries of every candidate column
+    double* c;       // Cost of every candidate column
+    uint32_t is_max;
+} colgen_pool_t;
+
+uint32_t colgen_pool_read(colgen_pool_t* pool_ptr, FILE* stream, uint32_t n, uint32_t is_max);
+
+// colgen_oracle_fn over the colgen_pool_t ctx
+uint32_t colgen_pool_oracle(void* ctx, const gsl_vector* y, colgen_columns_t* columns_ptr);
+
+void colgen_pool_free(colgen_pool_t* pool_ptr);
+
+// Column generation on the LP with the candidate columns of stream as the oracle
+uint32_t problem_solve_column_pool(problem_t* problem_ptr, FILE* stream, solution_t* solution_ptr);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef IPM_H
+#define IPM_H
+
+#include "problem.h"
+#include "variable.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Maximum number of predictor-corrector iterations
+#define IPM_MAX_ITER 100
+// Relative primal, dual and gap tolerance of an optimal interior solution
+#define IPM_TOL 1e-8
+// Fraction of the step to the boundary that is taken
+#define IPM_STEP 0.995
+// Pivots of the normal equations below this fraction of their diagonal belong to dependent rows
+#define IPM_PIVOT_TOL 1e-13
+
+// Solves the LP relaxation of the first m columns of problem_ptr with the Mehrotra predictor-corrector
+// method on the normal equations A * D * A^T. x (size m) receives the primal solution, zl and zu
+// (size m) the dual slacks of the lower and upper bounds. Returns 0 if it does not converge
+// within IPM_MAX_ITER iterations
+uint32_t ipm_solve(const problem_t* problem_ptr, gsl_vector* x, gsl_vector* zl, gsl_vector* zu,
+                   uint32_t* iter_n_ptr);
+
+// Crossover: fills start (size m) with the basis of a vertex next to the interior solution.
+// The columns farthest from their bounds relative to their dual slack enter the basis first,
+// the others are nonbasic at their nearest bound
+uint32_t ipm_crossover(const problem_t* problem_ptr, const gsl_vector* x, const gsl_vector* zl, const gsl_vector* zu,
+                       var_state_t* start);
+
+#endif
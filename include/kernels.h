@@ -0,0 +1,43 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdint.h>
+
+// Instruction set used by the vector kernels
+typedef enum { KERNELS_AUTO, KERNELS_SCALAR, KERNELS_AVX2, KERNELS_AVX512, KERNELS_ERR } kernels_level_t;
+const char* kernels_level_to_str(kernels_level_t level);
+kernels_level_t kernels_level_from_str(const char* str);
+
+// Selects the kernels of the given level, KERNELS_AUTO picks the widest one the CPU supports.
+// Until this is called the scalar kernels are used. Returns 0 if the CPU lacks the instructions
+uint32_t kernels_select(kernels_level_t level);
+
+// Level currently in use
+kernels_level_t kernels_level(void);
+
+// Runs the kernels of every level the CPU supports on random buffers (odd lengths, ties, skipped entries) and
+// checks that they return exactly what the scalar ones do. Prints the first mismatch and returns 0 on it
+uint32_t kernels_self_test(void);
+
+// All the kernels return exactly the same result at every level: the vector sums use
+// the same 4-lane order as the scalar ones and the other kernels only compare values
+
+// Sparse dot product sum(values[k] * x[idx[k]]) for k < len
+double kernel_gather_dot(const double* values, const uint32_t* idx, uint32_t len, const double* x);
+
+// Primal ratio test over the basic variables x with bounds [lb, ub] moving along sign * d.
+// Returns the first index with the smallest ratio below *min_ratio_ptr (or -1), updating
+// *min_ratio_ptr and setting *to_upper_ptr when that variable reaches its upper bound
+int32_t kernel_ratio_test(uint32_t n, const double* x, const double* d, double sign, const double* lb,
+                          const double* ub, double* min_ratio_ptr, uint32_t* to_upper_ptr);
+
+// Dual ratio test over the nonbasic variables with reduced costs r and pivot row sign * alpha.
+// dir is 1 for variables at their lower bound, -1 at the upper one and 0 for fixed ones.
+// Returns the first index with the smallest |r / alpha| below *min_ratio_ptr (or -1)
+int32_t kernel_dual_ratio_test(uint32_t len, const double* r, const double* alpha, const double* dir, double sign,
+                               double* min_ratio_ptr);
+
+// Index of the first x[i] farther than tol from an integer, -1 if there is none
+int32_t kernel_first_fractional(const double* x, uint32_t len, double tol);
+
+#endif
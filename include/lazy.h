@@ -0,0 +1,40 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include "problem.h"
+#include "sparse.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Violation of a row, relative to 1 + |rhs|, above which it is added to the LP
+#define LAZY_TOL 1e-6
+// Most violated rows added per round
+#define LAZY_ROUND_ROWS 100
+
+typedef enum { LAZY_LE, LAZY_GE, LAZY_EQ } lazy_sense_t;
+
+// Constraints that only enter the LP once its solution violates them. The file starts with the number of rows,
+// then each row is "<= rhs k j1 v1 ... jk vk" (or >=, =) with the k nonzeros of the row on the variables x_j
+typedef struct lazy_pool {
+    csr_matrix_t rows;    // Coefficients of every row over the m variables
+    double* rhs;          // Right-hand side of every row
+    lazy_sense_t* sense;  // Sense of every row
+    uint8_t* is_added;    // Boolean value of every row already added to the LP
+} lazy_pool_t;
+
+uint32_t lazy_pool_read(lazy_pool_t* pool_ptr, FILE* stream, uint32_t m);
+
+// Fills violated with the rows not added yet that x (size m) violates, the most violated first and at most
+// LAZY_ROUND_ROWS of them. Returns their number
+uint32_t lazy_pool_separate(const lazy_pool_t* pool_ptr, const gsl_vector* x, uint32_t* violated);
+
+void lazy_pool_free(lazy_pool_t* pool_ptr);
+
+// Solves the LP with the rows of stream as lazy constraints. After each optimal solve the violated rows are
+// appended with a basic slack, which keeps the basis dual feasible, and the dual simplex reoptimizes from it.
+// The problem is not presolved
+uint32_t problem_solve_lazy(problem_t* problem_ptr, FILE* stream, solution_t* solution_ptr);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "kernels.h"
+#include "parallel.h"
+
+#include <stdint.h>
+
+#define DEFAULT_REFACTOR_PERIOD 64
+
+// Rule used by the primal simplex to choose the entering variable, and by the dual simplex to choose the leaving one
+typedef enum { PRICING_DANTZIG, PRICING_DEVEX, PRICING_STEEPEST_EDGE, PRICING_BLAND, PRICING_ERR } pricing_rule_t;
+const char* pricing_rule_to_str(pricing_rule_t rule);
+pricing_rule_t pricing_rule_from_str(const char* str);
+
+// Open node the branch and bound explores next: the best bound, the best estimate, or a dive into a child of the
+// last node until it is pruned, then the best bound
+typedef enum { NODE_SELECT_BOUND, NODE_SELECT_ESTIMATE, NODE_SELECT_PLUNGE, NODE_SELECT_ERR } node_select_t;
+const char* node_select_to_str(node_select_t rule);
+node_select_t node_select_from_str(const char* str);
+
+typedef struct options {
+    uint32_t refactor_period;     // Number of basis updates before the LU factors are recomputed
+    pricing_rule_t pricing;       // Entering variable selection of the primal simplex
+    uint32_t partial_size;        // Columns priced per segment with partial pricing (0 = price every column)
+    uint32_t multiple_size;       // Candidates kept between iterations with multiple pricing (0 = disabled)
+    pricing_rule_t dual_pricing;  // Leaving variable selection of the dual simplex
+    kernels_level_t kernels;      // Instruction set of the vector kernels
+    node_select_t node_select;    // Open node selection of the branch and bound
+    uint32_t presolve;            // Boolean value to reduce the problem before solving it
+    uint32_t scaling;             // Boolean value to scale the rows and columns of A before solving
+    const char* basis_in;         // Basis file to warm start from (NULL = crash and PhaseI)
+    const char* basis_out;        // Basis file the final basis is written to (NULL = not saved)
+    uint32_t threads;             // Threads pricing the nonbasic columns, the caller included (0 = one per CPU)
+    uint32_t parallel_min;        // Nonbasic columns from which pricing is split over the threads
+    uint32_t barrier;             // Boolean value to start from the crossover of the interior point method
+    const char* scenarios;        // Scenario file of RHS and cost vectors solved after the model (NULL = none)
+    const char* lazy;             // Lazy constraint file, rows added when the LP solution violates them (NULL = none)
+    const char* columns;          // Candidate column file, columns priced into the LP by their duals (NULL = none)
+    uint32_t check_kernels;       // Boolean value to check the vector kernels against the scalar ones and exit
+} options_t;
+
+// Fills options with the default values
+void options_init(options_t* options_ptr);
+
+// Parses the command line arguments into options_ptr.
+// On success *filename_ptr points to the model file or is NULL to read from stdin
+uint32_t options_from_args(options_t* options_ptr, int argc, char** args, const char** filename_ptr);
+
+// Prints the accepted command line arguments
+void options_print_usage(const char* program);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+
+// Columns per block of a parallel loop: the reduced costs, pivot row entries, weights and
+// indices of a block (about 20 KB) stay in the L1 cache of the thread working on it
+#define PARALLEL_BLOCK 512
+// Default number of columns from which a loop is split over the threads
+#define DEFAULT_PARALLEL_MIN 4096
+
+// Best entry found in a block, index -1 if the block has none
+typedef struct parallel_best {
+    double value;
+    int32_t index;
+} parallel_best_t;
+
+typedef enum { PARALLEL_MAX, PARALLEL_MIN } parallel_reduce_t;
+
+// Works on the columns [start, end) and returns their best entry
+typedef parallel_best_t (*parallel_fn)(void* ctx, uint32_t start, uint32_t end);
+
+// Starts the pool with threads threads, the caller included (0 = one per CPU), which splits
+// the loops over at least min_len columns. Until this is called every loop runs on the caller
+uint32_t parallel_init(uint32_t threads, uint32_t min_len);
+
+// Threads working on a parallel loop, the caller included
+uint32_t parallel_threads(void);
+
+// Makes the loops of the calling thread run serially (1) or on the pool again (0). Threads that
+// run loops of their own at the same time, like the workers of the branch and bound, set it
+void parallel_serial(uint32_t serial);
+
+// Runs fn over [0, len), in blocks of PARALLEL_BLOCK spread over the threads when len is large
+// enough, and returns the largest (or smallest) block result. Ties go to the first block, so
+// with fn keeping the first of equal entries the result does not depend on the threads.
+// Only one thread can run a parallel loop at a time, and fn must not start another one
+parallel_best_t parallel_reduce(uint32_t len, parallel_reduce_t reduce, parallel_fn fn, void* ctx);
+
+// Stops the workers
+void parallel_free(void);
+
+#endif
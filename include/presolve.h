@@ -0,0 +1,57 @@
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+#include "problem.h"
+#include "solution.h"
+#include "sparse.h"
+
+#include <stdint.h>
+
+/* PRESOLVE_OP */
+// Reductions that postsolve has to undo to recover the removed columns. Row reductions
+// (empty, singleton and duplicate rows) only drop an equation and need no undo
+typedef enum { PRESOLVE_FIXED_COL, PRESOLVE_FREE_COL_SINGLETON, PRESOLVE_DUPLICATE_COL } presolve_op_type_t;
+
+typedef struct presolve_op {
+    presolve_op_type_t type;  // Kind of reduction
+    uint32_t col;             // Removed column (original index)
+    uint32_t other;           // Column the removed one was merged into (duplicate columns)
+    double value;             // Fixed value, pivot a_ij of a free singleton or scale of a duplicate column
+    double rhs;               // Right hand side of the row removed with a free singleton
+    uint32_t start;           // First entry of the row removed with a free singleton in the entry pool
+    uint32_t length;          // Number of entries of that row, without the singleton itself
+    double col_lb;            // Lower bound of col when it was merged
+    double other_lb;          // Bounds of other when col was merged into it
+    double other_ub;
+} presolve_op_t;
+
+/* PRESOLVE */
+typedef struct presolve {
+    uint32_t n;             // Rows of the original problem
+    uint32_t m;             // Columns of the original problem
+    uint32_t reduced_n;     // Rows left after presolve
+    uint32_t reduced_m;     // Columns left after presolve
+    uint32_t* col_map;      // Original index of each column left (size reduced_m)
+    presolve_op_t* ops;     // Postsolve stack, undone from the top
+    uint32_t ops_length;
+    uint32_t ops_capacity;
+    uint32_t* entry_cols;   // Entry pool of the rows removed with free singletons
+    double* entry_values;
+    uint32_t entries_length;
+    uint32_t entries_capacity;
+} presolve_t;
+
+// Removes empty and singleton rows, fixed, empty and implied free singleton columns, duplicate
+// rows and columns and dominated columns, and tightens the bounds of the integer variables.
+// reduced_ptr receives the reduced problem, which is left empty when no row is left.
+// Returns 0 on allocation failure or if the problem is infeasible
+uint32_t presolve_run(presolve_t* presolve_ptr, const problem_t* problem_ptr, problem_t* reduced_ptr);
+
+// Maps the solution of the reduced problem (NULL if it was empty) back to the original one, or only its
+// infeasibility when it has no solution
+uint32_t presolve_postsolve(const presolve_t* presolve_ptr, const problem_t* problem_ptr,
+                            const solution_t* reduced_solution_ptr, solution_t* solution_ptr);
+
+void presolve_free(presolve_t* presolve_ptr);
+
+#endif
@@ -5,38 +5,71 @@
 
 #include "variable.h"
 #include "solution.h"
+#include "options.h"
+#include "sparse.h"
 
 #include <stdint.h>
 #include <gsl/gsl_vector.h>
-#include <gsl/gsl_matrix.h>
 
 typedef struct problem {
-    uint32_t n;         // Number of constraints
-    uint32_t m;         // Number of variables
-    uint32_t is_max;    // Boolean value to know if its a maximization problem
-    gsl_vector* c;      // Reduced costs (m + n) (note: augmented for phaseI)
-    gsl_matrix* A;      // Constraints matrix (n x m + n) (note: augmented for phaseI)
-    gsl_vector* b;      // RHS (n)
-    int32_t* B;         // Indices of basic variables (size n)
-    int32_t* N;         // Indices of nonbasic variables (size m-n)
-    uint32_t pI_iter;   // Number of iterations to find base with PhaseI
-    var_arr_t var_arr;  // Array of variables
+    uint32_t n;              // Number of constraints
+    uint32_t m;              // Number of variables
+    uint32_t is_max;         // Boolean value to know if its a maximization problem
+    gsl_vector* c;           // Reduced costs (m + n) (note: augmented for phaseI)
+    csc_matrix_t A;          // Sparse constraints matrix (n x m + n) (note: augmented for phaseI)
+    gsl_vector* b;           // RHS (n)
+    int32_t* B;              // Indices of basic variables (size n)
+    int32_t* N;              // Indices of nonbasic variables (size m-n)
+    var_state_t* state;      // Simplex state of each variable (size m + n)
+    var_state_t* start;      // Warm start basis read from a basis file (size m, NULL = crash and PhaseI)
+    uint32_t is_dual_start;  // The warm start basis is only dual feasible, so the dual simplex solves the LP
+    uint32_t is_infeasible;  // PhaseI found no feasible basis, so the problem has no solution
+    uint32_t pI_iter;        // Number of iterations to find base with PhaseI
+    var_arr_t var_arr;       // Array of variables
+    options_t options;       // Solver options
 } problem_t;
 
-void problem_make_RHS_positive(uint32_t n, gsl_matrix* A, gsl_vector* b);
+void problem_make_RHS_positive(uint32_t n, csc_matrix_t* A, gsl_vector* b);
 
-int32_t* problem_find_primal_base(uint32_t n, uint32_t m, uint32_t is_max, gsl_vector* c, gsl_matrix* A, gsl_vector* b,
-                                  var_arr_t* var_arr_ptr, uint32_t* iter_n_ptr);
+// Basis of the crash completed by PhaseI. Returns NULL on failure, or with *is_infeasible_ptr set when the problem
+// has no feasible basis
+int32_t* problem_find_primal_base(uint32_t n, uint32_t m, csc_matrix_t* A, gsl_vector* b, var_arr_t* var_arr_ptr,
+                                  var_state_t* state, const options_t* opts_ptr, uint32_t* iter_n_ptr,
+                                  uint32_t* is_infeasible_ptr);
 
-uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream);
+// Reads the problem from stream. opts_ptr can be NULL to use the default options
+uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream, const options_t* opts_ptr);
 
 uint32_t problem_is_milp(const problem_t* problem_ptr);
 
 // Pretty print
 void problem_print(const problem_t* problem_ptr, const char* name);
 
+// Finds the starting basis of the problem as it is: the warm start basis if it can be repaired
+// into a primal (or, for LPs, dual) feasible one, the crash and PhaseI otherwise.
+// Returns 0 on failure and when PhaseI finds no feasible basis, which also sets is_infeasible
+uint32_t problem_prepare(problem_t* problem_ptr);
+
+// Turns the basic artificial variables PhaseI left on redundant rows into fixed columns after the structural
+// ones and drops the other artificial columns, so that A only holds the m columns of the LP and new columns or
+// rows can be appended to it
+uint32_t problem_fix_artificials(problem_t* problem_ptr);
+
+// Removes the columns problem_fix_artificials added past the model_m columns of the model, once the problem is solved
+// or before it is prepared again
+void problem_drop_artificials(problem_t* problem_ptr, uint32_t model_m);
+
+// Presolves the problem (unless disabled in its options), solves it and
+// reports the solution in the variables of the original problem
 uint32_t problem_solve(problem_t* problem_ptr, solution_t* solution_ptr);
 
+// Reads the basis file of the options into target_ptr, the problem that is going to be optimized.
+// col_map maps its columns to the ones of problem_ptr (NULL if they are the same)
+uint32_t problem_load_basis(const problem_t* problem_ptr, problem_t* target_ptr, const uint32_t* col_map);
+
+// Writes the basis of solved_ptr to the basis file of the options in the columns of problem_ptr
+uint32_t problem_save_basis(const problem_t* problem_ptr, const problem_t* solved_ptr, const uint32_t* col_map);
+
 void problem_free(problem_t* problem_ptr);
 
 /* GETTERS */
@@ -45,17 +78,20 @@ uint32_t problem_m(const problem_t* problem_ptr);
 uint32_t problem_is_max(const problem_t* problem_ptr);
 const gsl_vector* problem_c(const problem_t* problem_ptr);
 gsl_vector* problem_c_mut(problem_t* problem_ptr);
-const gsl_matrix* problem_A(const problem_t* problem_ptr);
-gsl_matrix* problem_A_mut(problem_t* problem_ptr);
+const csc_matrix_t* problem_A(const problem_t* problem_ptr);
+csc_matrix_t* problem_A_mut(problem_t* problem_ptr);
 const gsl_vector* problem_b(const problem_t* problem_ptr);
 gsl_vector* problem_b_mut(problem_t* problem_ptr);
 const int32_t* problem_B(const problem_t* problem_ptr);
 int32_t* problem_B_mut(problem_t* problem_ptr);
 const int32_t* problem_N(const problem_t* problem_ptr);
 int32_t* problem_N_mut(problem_t* problem_ptr);
+const var_state_t* problem_state(const problem_t* problem_ptr);
+var_state_t* problem_state_mut(problem_t* problem_ptr);
 uint32_t problem_pI_iter(const problem_t* problem_ptr);
 const var_arr_t* problem_var_arr(const problem_t* problem_ptr);
 var_arr_t* problem_var_arr_mut(problem_t* problem_ptr);
+const options_t* problem_options(const problem_t* problem_ptr);
 
 /* SETTERS */
 uint32_t problem_set_pI_iter(problem_t* problem_ptr, uint32_t pI_iter);
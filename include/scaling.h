@@ -0,0 +1,34 @@
+#ifndef SCALING_H
+#define SCALING_H
+
+#include "problem.h"
+#include "solution.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Maximum number of geometric mean passes
+#define SCALING_MAX_PASSES 8
+// The passes stop when the spread max|a_ij| / min|a_ij| improves by less than this factor
+#define SCALING_MIN_IMPROVEMENT 0.9
+
+// Row and column factors of the scaled problem: A' = R * A * S, b' = R * b, c' = S * c
+// and the bounds of x' = S^-1 * x. Every factor is a power of 2, so scaling is exact
+typedef struct scaling {
+    uint32_t n;             // Number of rows
+    uint32_t m;             // Number of columns
+    gsl_vector* row_scale;  // R (size n)
+    gsl_vector* col_scale;  // S (size m), 1 on the integer and binary columns
+} scaling_t;
+
+// Scales the problem in place with geometric mean passes followed by a column equilibration
+// (largest |a_ij| of each column equal to 1). Integer columns are never scaled, so their
+// bounds and branching values stay integer
+uint32_t scaling_apply(scaling_t* scaling_ptr, problem_t* problem_ptr);
+
+// Maps a solution of the scaled problem back to the original variables
+void scaling_unscale_solution(const scaling_t* scaling_ptr, solution_t* solution_ptr);
+
+void scaling_free(scaling_t* scaling_ptr);
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef BASIS_H
+#define BASIS_H
+
+#include "sparse.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_permutation.h>
+
+// Right-hand sides with at most this fraction of nonzeros are solved hypersparse: a depth-first search on
+// the graph of the factors finds the nonzero pattern of the result, and only those entries are computed
+#define HYPERSPARSE_RATIO 0.1
+
+// Product-form eta matrix: identity with column p replaced by the entering column
+typedef struct eta {
+    uint32_t p;       // Pivot row
+    double pivot;     // Value of the entering column on the pivot row
+    uint32_t start;   // Offset of the off-pivot entries in the eta pool
+    uint32_t length;  // Number of off-pivot nonzero entries
+} eta_t;
+
+// Factorization of the basis matrix AB as LU factors plus an eta file,
+// so that AB^-1 is never formed explicitly
+typedef struct basis_factor {
+    uint32_t n;                   // Size of the basis
+    uint32_t capacity;            // Largest basis the buffers can hold
+    gsl_matrix* LU_block;         // Storage of the LU factors (capacity x capacity)
+    gsl_matrix_view LU;           // LU factors of the last refactorized basis (P * AB = L * U), n x n
+    gsl_permutation* perm_block;  // Storage of the row permutation (size capacity)
+    gsl_permutation perm;         // Row permutation P of the LU factors (size n)
+    eta_t* etas;                  // Eta file (size refactor_period)
+    uint32_t eta_n;               // Number of etas applied since the last refactorization
+    uint32_t* eta_indices;        // Pool of eta row indices (size refactor_period * capacity)
+    double* eta_values;           // Pool of eta values (size refactor_period * capacity)
+    uint32_t eta_pool_length;     // Number of used entries in the pool
+    csc_matrix_t L;               // Strictly lower part of the LU factors by columns (unit diagonal)
+    csc_matrix_t U;               // Strictly upper part of the LU factors by columns
+    csc_matrix_t Lt;              // Strictly lower part of the LU factors by rows, for BTRAN
+    csc_matrix_t Ut;              // Strictly upper part of the LU factors by rows, for BTRAN
+    double* U_diag;               // Diagonal of U (size capacity)
+    double* work;                 // Scratch buffer for the triangular solves (size capacity)
+    uint32_t* rhs;                // Nonzero pattern of the right-hand side of a triangular solve (size capacity)
+    uint32_t* pattern;            // Nonzero pattern of its result in topological order (size capacity)
+    uint32_t* stack;              // Depth-first search stack (size capacity)
+    uint32_t* next;               // Next entry to visit in the column of each node on the stack (size capacity)
+    uint8_t* mark;                // Nodes reached by the current search, cleared after it (size capacity)
+    uint32_t refactor_period;     // Number of updates after which the basis is refactorized
+} basis_factor_t;
+
+// Allocates the buffers for bases up to capacity rows and sets the size of the basis to capacity
+uint32_t basis_factor_init(basis_factor_t* factor_ptr, uint32_t capacity, uint32_t refactor_period);
+
+// Sets the size of the basis to n (<= capacity) without allocating. The factors must be recomputed
+uint32_t basis_factor_resize(basis_factor_t* factor_ptr, uint32_t n);
+
+// Computes the LU factors of the basis made of the columns B of A and clears the eta file.
+// Returns 0 if the basis is singular
+uint32_t basis_factor_refactor(basis_factor_t* factor_ptr, const csc_matrix_t* A, const int32_t* B);
+
+// Solves AB * x = v in place (x overwrites v). Sparse v are solved hypersparse, in time proportional to
+// the nonzeros of the triangular solves rather than to n^2
+void basis_factor_ftran(const basis_factor_t* factor_ptr, gsl_vector* v);
+
+// Solves AB^T * y = v in place (y overwrites v), hypersparse as basis_factor_ftran
+void basis_factor_btran(const basis_factor_t* factor_ptr, gsl_vector* v);
+
+// Updates the factorization after the basic variable in row p has been replaced.
+// alpha_q must be AB^-1 * Aq computed with the old basis and B must already contain
+// the entering index. Refactorizes when the eta file is full or the pivot is too small
+uint32_t basis_factor_update(basis_factor_t* factor_ptr, const csc_matrix_t* A, const int32_t* B, uint32_t p,
+                             const gsl_vector* alpha_q);
+
+void basis_factor_free(basis_factor_t* factor_ptr);
+
+#endif
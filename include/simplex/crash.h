@@ -0,0 +1,21 @@
+#ifndef CRASH_H
+#define CRASH_H
+
+#include "sparse.h"
+#include "variable.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Smallest |a_ij| / max_k |a_kj| accepted as a crash pivot
+#define CRASH_PIVOT_RATIO 0.1
+
+// Triangular crash: greedily picks structural columns that keep the basis lower triangular,
+// preferring sparse columns without an upper bound and large pivots. A column is only taken
+// if its basic value, with every nonbasic variable at its lower bound, lies within its bounds,
+// so the basis is feasible once the rows left without a column get an artificial variable.
+// B[i] receives the column of row i or -1. Returns the number of rows covered
+uint32_t crash_basis(uint32_t n, uint32_t m, const csc_matrix_t* A, const gsl_vector* b, const var_arr_t* var_arr_ptr,
+                     int32_t* B);
+
+#endif
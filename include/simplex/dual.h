@@ -2,10 +2,17 @@
 #define DUAL_H
 
 #include "solution.h"
+#include "options.h"
+#include "sparse.h"
+#include "variable.h"
+#include "simplex/workspace.h"
 
-#include <gsl/gsl_matrix.h>
+// Bounded dual simplex, same conventions as simplex_primal. B must be dual feasible
+// (boxed nonbasic variables are moved to the bound that makes them so). With an iteration limit in the
+// workspace the solution can stop primal infeasible, its z still bounding the optimum
+uint32_t simplex_dual(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                      const gsl_vector* b, const var_arr_t* var_arr_ptr, int32_t* B, int32_t* N,
+                      var_state_t* state, const options_t* opts_ptr, simplex_workspace_t* workspace_ptr,
+                      solution_t* solution_ptr, uint32_t* iter_n_ptr);
 
-uint32_t simplex_dual(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const gsl_matrix* A,
-                      const gsl_vector* b, int32_t* B, int32_t* N, solution_t* solution_ptr, uint32_t* iter_n_ptr);
-
-#endif
\ No newline at end of file
+#endif
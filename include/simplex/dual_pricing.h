@@ -0,0 +1,50 @@
+#ifndef DUAL_PRICING_H
+#define DUAL_PRICING_H
+
+#include "options.h"
+#include "variable.h"
+#include "simplex/basis.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Leaving variable selection state of the dual simplex.
+// Weights are indexed by position in the basis array B
+typedef struct dual_pricing {
+    pricing_rule_t rule;  // Selected rule
+    uint32_t size;        // Number of basic variables (n)
+    uint32_t max_n;       // Maximum number of rows the buffers can hold
+    double* weights;      // Dual Devex reference weights or dual steepest edge norms ||e_i^T * AB_inv||^2
+    int32_t* basis;       // Basic variable of each row when the last solve ended, which the weights belong to
+    uint32_t is_saved;    // Boolean value to know if a solve left its weights and basis for the next one
+    double* data;         // Storage of tau (size max_n)
+    gsl_vector_view tau;  // AB_inv * rho_p for the steepest edge update (size n)
+} dual_pricing_t;
+
+// Allocates the dual pricing buffers for problems up to max_n rows
+uint32_t dual_pricing_alloc(dual_pricing_t* pricing_ptr, uint32_t max_n);
+
+// Prepares the dual pricing for the basis B without allocating. Steepest edge computes the exact norms with
+// factor_ptr on the first solve only: a later one keeps the weights of the rows whose basic variable did not change
+// since the last solve ended and resets the others to 1, as Devex does
+uint32_t dual_pricing_init(dual_pricing_t* pricing_ptr, const options_t* opts_ptr, uint32_t n, const int32_t* B,
+                           const basis_factor_t* factor_ptr);
+
+// Records the basis B the weights belong to at the end of a solve, for the next one
+void dual_pricing_save(dual_pricing_t* pricing_ptr, const int32_t* B);
+
+// Returns xj - lb if xj is below its lower bound, xj - ub if it is above its upper bound and 0 otherwise
+double dual_pricing_infeasibility(const var_arr_t* var_arr_ptr, uint32_t j, double xj);
+
+// Returns the position in B of the leaving variable, or -1 if xB is within its bounds
+int32_t dual_pricing_select(const dual_pricing_t* pricing_ptr, const gsl_vector* xB, const int32_t* B,
+                            const var_arr_t* var_arr_ptr);
+
+// Updates the weights for the pivot on row p with entering column alpha_q = AB_inv * Aq and
+// rho_p = AB_inv^T * e_p. Must be called before the pivot, while factor_ptr still describes the old basis
+void dual_pricing_update(dual_pricing_t* pricing_ptr, const basis_factor_t* factor_ptr, uint32_t p,
+                         const gsl_vector* alpha_q, const gsl_vector* rho_p);
+
+void dual_pricing_free(dual_pricing_t* pricing_ptr);
+
+#endif
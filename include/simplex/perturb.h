@@ -0,0 +1,37 @@
+#ifndef PERTURB_H
+#define PERTURB_H
+
+#include "sparse.h"
+#include "variable.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Stalling measure after which an engine perturbs its problem: it grows by one with every degenerate pivot
+// and is halved by every other one, so that a few progressing pivots do not hide a stall
+#define PERTURB_STALL 30
+// Each perturbed bound or cost moves by up to PERTURB_SCALE * (1 + |value|)
+#define PERTURB_SCALE 1e-6
+
+// Random generator of the perturbations, seeded the same way by every solve so that runs are reproducible
+typedef struct perturb {
+    uint64_t rng;    // State of the xorshift64* generator
+    uint32_t count;  // Number of times the engine perturbed its problem (0 = it is the original one)
+} perturb_t;
+
+void perturb_init(perturb_t* perturb_ptr);
+
+// Random factor in [0.5, 1)
+double perturb_random(perturb_t* perturb_ptr);
+
+// Moves every basic variable away from its nearest bound, by at most half of its range,
+// adding AB * shift to b_pert. xB, lbB and ubB are the basic values and bounds
+void perturb_rhs(perturb_t* perturb_ptr, uint32_t n, const int32_t* B, const csc_matrix_t* A, const gsl_vector* xB,
+                 const gsl_vector* lbB, const gsl_vector* ubB, gsl_vector* b_pert);
+
+// Makes the reduced cost of every nonbasic variable that can move more dual feasible
+// (more negative at the lower bound, more positive at the upper one once maximized) in c_pert
+void perturb_costs(perturb_t* perturb_ptr, uint32_t n, uint32_t m, uint32_t is_max, const int32_t* N,
+                   const var_state_t* state, gsl_vector* c_pert);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PRICING_H
+#define PRICING_H
+
+#include "options.h"
+#include "sparse.h"
+#include "variable.h"
+#include "simplex/basis.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Entering variable selection state of the primal simplex.
+// Weights and candidates are indexed by position in the nonbasis array N
+typedef struct pricing {
+    pricing_rule_t rule;          // Selected rule
+    uint32_t size;                // Number of nonbasic variables (m - n)
+    uint32_t max_n;               // Maximum number of rows the buffers can hold
+    uint32_t max_m;               // Maximum number of columns the buffers can hold
+    double* weights;              // Devex reference weights or steepest edge norms (size max_m + 1)
+    uint32_t partial_size;        // Positions priced per segment (size when pricing is full)
+    uint32_t segment_start;       // Position where the next partial scan starts
+    uint32_t* candidates;         // Multiple pricing list, best candidate first
+    double* candidate_scores;     // Score of each candidate
+    uint32_t candidate_n;         // Number of candidates in the list
+    uint32_t candidate_capacity;  // Maximum number of candidates (1 without multiple pricing)
+    uint32_t max_candidates;      // Allocated candidates
+    double* data;                 // Storage of rho_p and w (size 2 * max_n)
+    gsl_vector_view rho_p;        // Pivot row of AB_inv (size n)
+    gsl_vector_view w;            // AB_inv^T * alpha_q for the steepest edge update (size n)
+} pricing_t;
+
+// Allocates the pricing buffers for problems up to max_n rows and max_m columns
+uint32_t pricing_alloc(pricing_t* pricing_ptr, uint32_t max_n, uint32_t max_m, uint32_t max_candidates);
+
+// Prepares the pricing for the basis B without allocating
+// (steepest edge computes the exact norms with factor_ptr)
+uint32_t pricing_init(pricing_t* pricing_ptr, const options_t* opts_ptr, uint32_t n, uint32_t m,
+                      const csc_matrix_t* A, const int32_t* N, const basis_factor_t* factor_ptr);
+
+// Computes the reduced costs that are needed from the multipliers y (storing them in r) and returns the
+// position in N of the entering variable, or -1 if no variable can improve the objective
+// (a positive reduced cost at the lower bound or a negative one at the upper bound).
+// With use_bland set every column is priced and the smallest index is chosen
+int32_t pricing_select(pricing_t* pricing_ptr, uint32_t is_max, const gsl_vector* c, const gsl_vector* y,
+                       const csc_matrix_t* A, const int32_t* N, const var_state_t* state, gsl_vector* r,
+                       uint32_t use_bland);
+
+// Updates the weights for the pivot (q entering, p leaving). Must be called before
+// the pivot, while factor_ptr still describes the old basis
+void pricing_update(pricing_t* pricing_ptr, const csc_matrix_t* A, const int32_t* N, const basis_factor_t* factor_ptr,
+                    uint32_t p, uint32_t q, const gsl_vector* alpha_q);
+
+void pricing_free(pricing_t* pricing_ptr);
+
+#endif
@@ -2,12 +2,27 @@
 #define PRIMAL_H
 
 #include "problem.h"
+#include "options.h"
+#include "simplex/workspace.h"
 
-// Find problem basis indices with Phase 1 method
-uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, uint32_t is_max, gsl_vector* c, gsl_matrix* A, gsl_vector* b,
-                               int32_t* B, var_arr_t* var_arr_ptr, uint32_t* iter_n_ptr);
+// Find problem basis indices with Phase 1 method. On input B may hold a crash basis, the structural
+// column of each row or -1 for the rows that need an artificial variable. state (size m + n) receives
+// the bound of each nonbasic variable in the feasible basis that is found. When the problem has no feasible
+// basis *is_infeasible_ptr is set, B is left as it was and the artificial columns are removed again
+uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, csc_matrix_t* A, const gsl_vector* b, int32_t* B,
+                               var_arr_t* var_arr_ptr, var_state_t* state, const options_t* opts_ptr,
+                               uint32_t* iter_n_ptr, uint32_t* is_infeasible_ptr);
 
-uint32_t simplex_primal(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const gsl_matrix* A,
-                        const gsl_vector* b, int32_t* B, int32_t* N, solution_t* solution_ptr, uint32_t* iter_n_ptr);
+// Ratio test of Bland's rule over the basic variables with bounds [lbB, ubB] moving along sign * d
+int32_t ratio_test_bland(uint32_t n, const int32_t* B, const gsl_vector* xB, const gsl_vector* d, double sign,
+                         const gsl_vector* lbB, const gsl_vector* ubB, double* min_ratio_ptr, uint32_t* to_upper_ptr);
 
-#endif
\ No newline at end of file
+// Bounded primal simplex: the variables live in [lb, ub] as given by var_arr_ptr ([0, inf) when NULL)
+// and the nonbasic ones sit on the bound given by state (size m, all at the lower bound when NULL).
+// B must be primal feasible for the given states. workspace_ptr provides the buffers (NULL to allocate them)
+uint32_t simplex_primal(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                        const gsl_vector* b, const var_arr_t* var_arr_ptr, int32_t* B, int32_t* N,
+                        var_state_t* state, const options_t* opts_ptr, simplex_workspace_t* workspace_ptr,
+                        solution_t* solution_ptr, uint32_t* iter_n_ptr);
+
+#endif
@@ -2,19 +2,45 @@
 #define S_UTILS_H
 
 #include "solution.h"
+#include "sparse.h"
+#include "variable.h"
+#include "simplex/basis.h"
 
-#include <gsl/gsl_matrix.h>
+void extract_basic_costs(uint32_t n, uint32_t is_max, const int32_t* B, const gsl_vector* c, gsl_vector* cB);
 
-void extract_basic_objects(uint32_t n, uint32_t is_max, int32_t* B, const gsl_vector* c, const gsl_matrix* A,
-                           gsl_vector* cB, gsl_matrix* AB);
-gsl_matrix* inverse(const gsl_matrix* base, size_t size);
-void compute_basic_solution(const gsl_matrix* AB_inv, const gsl_vector* b, gsl_vector* xB);
-void compute_reduced_costs(uint32_t n, uint32_t m, uint32_t is_max, int32_t* N, const gsl_vector* c, gsl_vector* cB,
-                           gsl_vector* cN, const gsl_matrix* A, const gsl_matrix* AB_inv, gsl_vector* r);
-uint32_t extract_column(const gsl_matrix* m, uint32_t j, gsl_vector* col);
-uint32_t extract_row(const gsl_matrix* m, uint32_t i, gsl_vector* row);
+// Bounds of variable j, [0, VARIABLE_INF) when var_arr_ptr is NULL
+double var_lb(const var_arr_t* var_arr_ptr, uint32_t j);
+double var_ub(const var_arr_t* var_arr_ptr, uint32_t j);
+
+// Value of the nonbasic variable j, which sits on the bound given by its state
+double nonbasic_value(const var_arr_t* var_arr_ptr, const var_state_t* state, uint32_t j);
+
+// Copies the bounds of the basic variables into lbB and ubB, contiguous for the ratio test kernels
+void basic_bounds(uint32_t n, const int32_t* B, const var_arr_t* var_arr_ptr, gsl_vector* lbB, gsl_vector* ubB);
+
+// Marks the variables of B as basic and moves every nonbasic variable to a finite bound
+void normalize_states(uint32_t n, uint32_t m, const int32_t* B, const int32_t* N, const var_arr_t* var_arr_ptr,
+                      var_state_t* state);
+
+// Computes xB = AB_inv * (b - AN * xN)
+void compute_basic_solution(const basis_factor_t* factor_ptr, const csc_matrix_t* A, const gsl_vector* b, uint32_t n,
+                            uint32_t m, const int32_t* N, const var_arr_t* var_arr_ptr, const var_state_t* state,
+                            gsl_vector* xB);
+
+// Computes the simplex multipliers y = AB_inv^T * cB with a single BTRAN
+void compute_duals(uint32_t n, uint32_t is_max, const int32_t* B, const gsl_vector* c,
+                   const basis_factor_t* factor_ptr, gsl_vector* y);
+
+// Reduced costs rj = cj - y * Aj, one sparse dot product per column
+double compute_reduced_cost(uint32_t is_max, uint32_t j, const gsl_vector* c, const gsl_vector* y,
+                            const csc_matrix_t* A);
+void compute_reduced_costs(uint32_t n, uint32_t m, uint32_t is_max, const int32_t* N, const gsl_vector* c,
+                           const gsl_vector* y, const csc_matrix_t* A, gsl_vector* r);
+
+uint32_t extract_column(const csc_matrix_t* A, uint32_t j, gsl_vector* col);
 void pivot(int32_t entering, int32_t leaving, int32_t* B, int32_t* N);
-void extract_optimal(uint32_t n, uint32_t is_max, int32_t* B, gsl_vector* xB, const gsl_vector* c,
+void extract_optimal(uint32_t n, uint32_t m, uint32_t is_max, const int32_t* B, const int32_t* N, const gsl_vector* xB,
+                     const gsl_vector* c, const var_arr_t* var_arr_ptr, const var_state_t* state,
                      solution_t* solution_ptr);
 
-#endif
\ No newline at end of file
+#endif
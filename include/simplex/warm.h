@@ -0,0 +1,41 @@
+#ifndef WARM_H
+#define WARM_H
+
+#include "sparse.h"
+#include "variable.h"
+#include "options.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Smallest |pivot| / max_k |a_kj| accepted when a column enters the repaired basis
+#define WARM_PIVOT_RATIO 1e-7
+// Tolerance on the primal and dual feasibility of the warm basis
+#define WARM_FEAS_TOL 1e-9
+
+// How the simplex can start from a warm basis. With WARM_START_PHASE_I, PhaseI only works on
+// the rows whose basic variable had to be swapped for an artificial one
+typedef enum { WARM_START_NONE, WARM_START_PRIMAL, WARM_START_DUAL, WARM_START_PHASE_I } warm_start_t;
+
+// Writes the state of the first m variables to filename, one character each
+// (B = basic, L = lower, U = upper, F = fixed) after a "n m" header
+uint32_t basis_write(const char* filename, uint32_t n, uint32_t m, const var_state_t* state);
+
+// Reads a basis written by basis_write into state (size m).
+// Returns 0 if the file cannot be read or belongs to a problem of another size
+uint32_t basis_read(const char* filename, uint32_t n, uint32_t m, var_state_t* state);
+
+// Picks linearly independent columns for B among the basic ones of start and then, if fill is set,
+// among the others for the rows still uncovered. The columns are tried in the order given by order
+// (size m, NULL = by index). B[i] receives the column of row i or -1. Returns the number of rows covered
+uint32_t basis_repair(uint32_t n, uint32_t m, const csc_matrix_t* A, const var_arr_t* var_arr_ptr,
+                      const var_state_t* start, const uint32_t* order, uint32_t fill, int32_t* B);
+
+// Repairs start into B and state (size m) and tells whether it is primal feasible, only dual
+// feasible (when allow_dual is set) or needs PhaseI on the rows where B[i] = -1 after the slack
+// swaps. B and state are meaningless when it is not usable
+warm_start_t warm_start(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                        const gsl_vector* b, const var_arr_t* var_arr_ptr, const var_state_t* start,
+                        uint32_t allow_dual, const options_t* opts_ptr, int32_t* B, var_state_t* state);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "options.h"
+#include "variable.h"
+#include "simplex/basis.h"
+#include "simplex/pricing.h"
+#include "simplex/dual_pricing.h"
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+// Alignment of the vectors, so that the vector kernels work on whole cache lines
+#define WORKSPACE_ALIGNMENT 64
+
+// Buffers of the simplex engines, allocated once for the largest problem that will be
+// solved and reused by every solve, so that the engines do not allocate at all
+typedef struct simplex_workspace {
+    uint32_t max_n;               // Maximum number of constraints
+    uint32_t max_m;               // Maximum number of variables
+    basis_factor_t factor;        // Factorization of the basis
+    pricing_t pricing;            // Entering variable selection of the primal simplex
+    dual_pricing_t dual_pricing;  // Leaving variable selection of the dual simplex
+    double* data;                 // Storage of the vectors below, 64 byte aligned
+    gsl_vector_view xB;           // Values of the basic variables (size n)
+    gsl_vector_view y;            // Simplex multipliers (size n)
+    gsl_vector_view d;            // Entering column AB_inv * Aq (size n)
+    gsl_vector_view rho_p;        // Pivot row of AB_inv (size n)
+    gsl_vector_view lbB;          // Lower bounds of the basic variables (size n)
+    gsl_vector_view ubB;          // Upper bounds of the basic variables (size n)
+    gsl_vector_view b_pert;       // Perturbed RHS of the primal simplex (size n)
+    gsl_vector_view r;            // Reduced costs of the nonbasic variables (size m - n)
+    gsl_vector_view alpha;        // Pivot row of the dual simplex over the nonbasic variables (size m - n)
+    gsl_vector_view dir;          // Direction each nonbasic variable can move in: 1, -1 or 0 if fixed (size m - n)
+    gsl_vector_view c_pert;       // Perturbed costs of the dual simplex (size m)
+    var_state_t* state;           // States used when the caller does not provide them (size max_m)
+    uint32_t keep_factor;         // Boolean value set by the caller when B is the basis the last solve ended with,
+                                  // so that the next solve reuses the factorization (cleared by every solve)
+    uint32_t is_cleanup;          // Boolean value set by an engine that hands its basis to the other one to remove
+                                  // a perturbation, which must not perturb again (cleared by every solve)
+    uint32_t iter_limit;          // Iterations after which the dual simplex stops with the bound of its basis rather
+                                  // than the optimum, and does not perturb (0 = none, cleared by every solve)
+} simplex_workspace_t;
+
+size_t workspace_stride(size_t len);
+
+// Allocates a workspace for problems up to max_n constraints and max_m variables
+uint32_t simplex_workspace_init(simplex_workspace_t* workspace_ptr, uint32_t max_n, uint32_t max_m,
+                                const options_t* opts_ptr);
+
+// Sizes the vectors of the workspace for a problem with n constraints and m variables.
+// A kept factorization survives only if n does not change
+uint32_t simplex_workspace_prepare(simplex_workspace_t* workspace_ptr, uint32_t n, uint32_t m);
+
+void simplex_workspace_free(simplex_workspace_t* workspace_ptr);
+
+#endif
@@ -4,14 +4,18 @@
 #include <stdint.h>
 #include <gsl/gsl_vector.h>
 
+// Largest distance from an integer for a value to count as integer
+#define INTEGER_TOL 1e-8
+
 typedef struct solution {
-    uint32_t n;             // Number of constraints
-    uint32_t m;             // Number of variables
-    gsl_vector* x;          // Optimal solution (m)
-    double z;               // Optimal value
-    uint32_t is_unbounded;  // Boolean value to know if unbounded
-    uint32_t pI_iter;       // Number of iterations of PhaseI to find a base
-    uint32_t pII_iter;      // Number of iterations of PhaseII to find solution
+    uint32_t n;              // Number of constraints
+    uint32_t m;              // Number of variables
+    gsl_vector* x;           // Optimal solution (m)
+    double z;                // Optimal value
+    uint32_t is_unbounded;   // Boolean value to know if unbounded
+    uint32_t is_infeasible;  // Boolean value to know if there is no feasible solution
+    uint32_t pI_iter;        // Number of iterations of PhaseI to find a base
+    uint32_t pII_iter;       // Number of iterations of PhaseII to find solution
 } solution_t;
 
 uint32_t solution_init(solution_t* solution_ptr, uint32_t n, uint32_t m, uint32_t is_unbounded);
@@ -26,11 +30,15 @@ void solution_print(const solution_t* solution_ptr, const char* name);
 
 void solution_free(solution_t* solution_ptr);
 
+// Keeps only the first m variables of the solution
+uint32_t solution_truncate(solution_t* solution_ptr, uint32_t m);
+
 /* GETTERS */
 const gsl_vector* solution_x(const solution_t* solution_ptr);
 gsl_vector* solution_x_mut(solution_t* solution_ptr);
 double solution_z(const solution_t* solution_ptr);
 uint32_t solution_is_unbounded(const solution_t* solution_ptr);
+uint32_t solution_is_infeasible(const solution_t* solution_ptr);
 uint32_t solution_pI_iterations(const solution_t* solution_ptr);
 uint32_t solution_pII_iterations(const solution_t* solution_ptr);
 
@@ -39,5 +47,6 @@ uint32_t solution_set_x(solution_t* solution_ptr, gsl_vector* x);
 uint32_t solution_set_z(solution_t* solution_ptr, double z);
 uint32_t solution_set_pI_iter(solution_t* solution_ptr, uint32_t pI_iter);
 uint32_t solution_set_pII_iter(solution_t* solution_ptr, uint32_t pII_iter);
+uint32_t solution_set_infeasible(solution_t* solution_ptr, uint32_t is_infeasible);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <stdint.h>
+#include <gsl/gsl_vector.h>
+
+/* CSC */
+// Compressed sparse column matrix. Columns can be appended up to col_capacity,
+// the nonzero storage grows on demand
+typedef struct csc_matrix {
+    uint32_t rows;          // Number of rows
+    uint32_t cols;          // Number of columns
+    uint32_t col_capacity;  // Maximum number of columns
+    uint32_t nnz_capacity;  // Allocated nonzero entries
+    uint32_t* col_ptr;      // Start of each column in row_idx/values (size col_capacity + 1)
+    uint32_t* row_idx;      // Row index of each nonzero, sorted inside each column (size nnz_capacity)
+    double* values;         // Value of each nonzero (size nnz_capacity)
+} csc_matrix_t;
+
+uint32_t csc_init(csc_matrix_t* A_ptr, uint32_t rows, uint32_t col_capacity, uint32_t nnz_capacity);
+
+// Copies the first cols columns of src into dst, which must not be initialized
+uint32_t csc_copy(csc_matrix_t* dst_ptr, const csc_matrix_t* src_ptr, uint32_t cols, uint32_t col_capacity);
+
+uint32_t csc_nnz(const csc_matrix_t* A_ptr);
+
+// Grows the nonzero storage to hold at least nnz entries
+uint32_t csc_reserve(csc_matrix_t* A_ptr, uint32_t nnz);
+
+// Appends a column with length nonzeros (rows must be sorted)
+uint32_t csc_push_column(csc_matrix_t* A_ptr, const uint32_t* rows, const double* values, uint32_t length);
+
+// Inserts (or overwrites) the entry (i, j)
+uint32_t csc_insert(csc_matrix_t* A_ptr, uint32_t i, uint32_t j, double value);
+
+// Drops every column >= cols and every entry on a row >= rows
+void csc_truncate(csc_matrix_t* A_ptr, uint32_t rows, uint32_t cols);
+
+// Removes every column j with keep[j] == 0, the others keep their order
+void csc_keep_columns(csc_matrix_t* A_ptr, const uint8_t* keep);
+
+double csc_get(const csc_matrix_t* A_ptr, uint32_t i, uint32_t j);
+
+// Writes column j into the dense vector v
+void csc_column_scatter(const csc_matrix_t* A_ptr, uint32_t j, gsl_vector* v);
+
+// Computes v * Aj
+double csc_column_dot(const csc_matrix_t* A_ptr, uint32_t j, const gsl_vector* v);
+
+// Computes v += alpha * Aj
+void csc_column_axpy(const csc_matrix_t* A_ptr, uint32_t j, double alpha, gsl_vector* v);
+
+// Multiplies every row i by s[i]
+void csc_scale_rows(csc_matrix_t* A_ptr, const gsl_vector* s);
+
+void csc_free(csc_matrix_t* A_ptr);
+
+/* CSR */
+// Compressed sparse row matrix, built one row at a time
+typedef struct csr_matrix {
+    uint32_t rows;          // Number of rows
+    uint32_t cols;          // Number of columns
+    uint32_t row_capacity;  // Maximum number of rows
+    uint32_t nnz_capacity;  // Allocated nonzero entries
+    uint32_t* row_ptr;      // Start of each row in col_idx/values (size row_capacity + 1)
+    uint32_t* col_idx;      // Column index of each nonzero, sorted inside each row (size nnz_capacity)
+    double* values;         // Value of each nonzero (size nnz_capacity)
+} csr_matrix_t;
+
+uint32_t csr_init(csr_matrix_t* A_ptr, uint32_t cols, uint32_t row_capacity, uint32_t nnz_capacity);
+
+// Appends a row with length nonzeros (cols must be sorted)
+uint32_t csr_push_row(csr_matrix_t* A_ptr, const uint32_t* cols, const double* values, uint32_t length);
+
+// Builds the CSC representation of src with room for col_capacity columns
+uint32_t csc_from_csr(csc_matrix_t* dst_ptr, const csr_matrix_t* src_ptr, uint32_t col_capacity);
+
+// Builds the CSR representation of src
+uint32_t csr_from_csc(csr_matrix_t* dst_ptr, const csc_matrix_t* src_ptr);
+
+void csr_free(csr_matrix_t* A_ptr);
+
+#endif
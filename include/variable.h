@@ -4,6 +4,9 @@
 #include <stdio.h>
 #include <stdint.h>
 
+// Upper bounds at or above this value are treated as infinite
+#define VARIABLE_INF 10e9
+
 /* VARIABLE */
 typedef enum { VAR_REAL, VAR_INTEGER, VAR_BINARY, VAR_ERR } variable_type_t;
 const char* variable_type_to_str(variable_type_t vt);
@@ -22,12 +25,19 @@ uint32_t variable_init_binary(variable_t* variable_ptr);
 variable_t variable_copy(variable_t other);
 
 uint32_t variable_is_real(const variable_t* variable_ptr);
+// Binary variables are integer too
 uint32_t variable_is_integer(const variable_t* variable_ptr);
 uint32_t variable_is_binary(const variable_t* variable_ptr);
+uint32_t variable_has_ub(const variable_t* variable_ptr);
 
 void variable_print(const variable_t* v);
 void variable_free(variable_t* variable_ptr);
 
+/* VAR_STATE */
+// Simplex state of a variable: basic, or nonbasic at one of its bounds.
+// Fixed variables (lb == ub) are nonbasic and never enter the basis
+typedef enum { VAR_STATE_LOWER, VAR_STATE_UPPER, VAR_STATE_FIXED, VAR_STATE_BASIC } var_state_t;
+
 /* VAR_ARRAY */
 typedef struct var_arr {
     variable_t* data;
@@ -0,0 +1,234 @@
+#include "batch.h"
+#include "scaling.h"
+#include "simplex/primal.h"
+#include "simplex/dual.h"
+#include "simplex/workspace.h"
+#include "branch_bound/algorithm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* SCENARIO FILE */
+uint32_t scenario_init(scenario_t* scenario_ptr, uint32_t n, uint32_t m) {
+    if (!scenario_ptr) {
+        return 0;
+    }
+
+    scenario_ptr->kind = SCENARIO_RHS;
+    scenario_ptr->size = 0;
+    scenario_ptr->values = (double*)malloc(sizeof(double) * (n > m ? n : m));
+    return scenario_ptr->values != NULL;
+}
+
+uint32_t scenario_read(FILE* stream, uint32_t n, uint32_t m, scenario_t* scenario_ptr, uint32_t* end_ptr) {
+    if (!stream || !scenario_ptr || !end_ptr) {
+        fprintf(stderr, "Some arguments are NULL in scenario_read\n");
+        return 0;
+    }
+
+    *end_ptr = 0;
+    char kind = 0;
+    if (fscanf(stream, " %c", &kind) != 1) {
+        *end_ptr = 1;
+        return 0;
+    }
+
+    if (kind == 'b') {
+        scenario_ptr->kind = SCENARIO_RHS;
+        scenario_ptr->size = n;
+    } else if (kind == 'c') {
+        scenario_ptr->kind = SCENARIO_COST;
+        scenario_ptr->size = m;
+    } else {
+        fprintf(stderr, "Unknown scenario kind '%c', expected 'b' or 'c'\n", kind);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < scenario_ptr->size; i++) {
+        if (fscanf(stream, "%lf", &scenario_ptr->values[i]) != 1) {
+            fprintf(stderr, "Expected %u values in the '%c' scenario, found %u\n", scenario_ptr->size, kind, i);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void scenario_free(scenario_t* scenario_ptr) {
+    if (!scenario_ptr) {
+        return;
+    }
+
+    free(scenario_ptr->values);
+    scenario_ptr->values = NULL;
+}
+
+/* BATCH */
+// Writes the scenario into the problem as it is being solved: the RHS scaled by R and with the sign of
+// the rows flipped by problem_make_RHS_positive, the costs scaled by S
+void batch_apply(problem_t* problem_ptr, const scenario_t* scenario_ptr, const scaling_t* scaling_ptr,
+                 const double* row_sign) {
+    for (uint32_t i = 0; i < scenario_ptr->size; i++) {
+        double v = scenario_ptr->values[i];
+        if (scenario_ptr->kind == SCENARIO_RHS) {
+            double r = scaling_ptr->row_scale ? gsl_vector_get(scaling_ptr->row_scale, i) : 1.0;
+            gsl_vector_set(problem_ptr->b, i, row_sign[i] * r * v);
+        } else {
+            double s = scaling_ptr->col_scale ? gsl_vector_get(scaling_ptr->col_scale, i) : 1.0;
+            gsl_vector_set(problem_ptr->c, i, s * v);
+        }
+    }
+}
+
+// Finds a new starting basis when the previous scenario did not end optimal: its basis becomes the
+// warm start, which falls back to the crash and PhaseI when it cannot be repaired. The m columns of the
+// model get back the room of the artificial variables
+uint32_t batch_restart(problem_t* problem_ptr, uint32_t m, double* row_sign) {
+    uint32_t n = problem_ptr->n;
+    problem_drop_artificials(problem_ptr, m);
+
+    if (problem_ptr->state) {
+        if (!problem_ptr->start) {
+            problem_ptr->start = (var_state_t*)malloc(sizeof(var_state_t) * m);
+            if (!problem_ptr->start) {
+                return 0;
+            }
+        }
+        memcpy(problem_ptr->start, problem_ptr->state, sizeof(var_state_t) * m);
+    }
+
+    // problem_prepare flips the rows that now have a negative RHS
+    for (uint32_t i = 0; i < n; i++) {
+        if (gsl_vector_get(problem_ptr->b, i) < 0.0) {
+            row_sign[i] = -row_sign[i];
+        }
+    }
+
+    free(problem_ptr->B);
+    free(problem_ptr->N);
+    free(problem_ptr->state);
+    problem_ptr->B = NULL;
+    problem_ptr->N = NULL;
+    problem_ptr->state = NULL;
+    problem_ptr->is_dual_start = 0;
+    problem_ptr->is_infeasible = 0;
+    problem_ptr->pI_iter = 0;
+
+    return problem_prepare(problem_ptr);
+}
+
+uint32_t problem_solve_batch(problem_t* problem_ptr, FILE* stream) {
+    if (!problem_ptr || !stream) {
+        fprintf(stderr, "Some arguments are NULL in problem_solve_batch\n");
+        return 0;
+    }
+
+    if (problem_is_milp(problem_ptr)) {
+        fprintf(stderr, "Scenarios can only be solved for LPs\n");
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    uint32_t ret = 1;
+    scaling_t scaling = {0};
+    simplex_workspace_t workspace = {0};
+    scenario_t scenario = {0};
+    double* row_sign = (double*)malloc(sizeof(double) * n);
+    if (!row_sign || !scenario_init(&scenario, n, m) || !problem_load_basis(problem_ptr, problem_ptr, NULL)) {
+        goto fail;
+    }
+
+    if (problem_ptr->options.scaling && !scaling_apply(&scaling, problem_ptr)) {
+        goto fail;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        row_sign[i] = gsl_vector_get(problem_ptr->b, i) < 0.0 ? -1.0 : 1.0;
+    }
+    // Room for a fixed column in place of each artificial variable left basic by PhaseI
+    if (!simplex_workspace_init(&workspace, n, m + n, &problem_ptr->options)) {
+        goto fail;
+    }
+
+    // When PhaseI finds no feasible basis the model is reported infeasible, and the next scenario starts over
+    uint32_t is_prepared = problem_prepare(problem_ptr);
+    gsl_vector_view b = gsl_vector_subvector(problem_ptr->b, 0, n);
+    solve_fn solver = problem_ptr->is_dual_start ? simplex_dual : simplex_primal;
+    uint32_t is_optimal = 0;
+
+    for (uint32_t k = 0;; k++) {
+        char name[32] = "Base model";
+        if (k > 0) {
+            uint32_t end = 0;
+            if (!scenario_read(stream, n, m, &scenario, &end)) {
+                if (end) {
+                    break;
+                }
+                goto fail;
+            }
+            snprintf(name, sizeof(name), "Scenario %u", k);
+            batch_apply(problem_ptr, &scenario, &scaling, row_sign);
+
+            // The optimal basis of the previous scenario stays dual feasible for a new RHS and primal
+            // feasible for new costs, so its factors are reused and only PhaseII runs
+            if (is_optimal) {
+                solver = scenario.kind == SCENARIO_RHS ? simplex_dual : simplex_primal;
+                workspace.keep_factor = 1;
+                problem_ptr->pI_iter = 0;
+                is_prepared = 1;
+            } else {
+                is_prepared = batch_restart(problem_ptr, m, row_sign);
+                solver = problem_ptr->is_dual_start ? simplex_dual : simplex_primal;
+            }
+        }
+
+        if (!is_prepared) {
+            if (!problem_ptr->is_infeasible) {
+                goto fail;
+            }
+            printf("\n================== %s ==================\ninfeasible\n", name);
+            is_optimal = 0;
+            continue;
+        }
+
+        gsl_vector_view c = gsl_vector_subvector(problem_ptr->c, 0, problem_ptr->m);
+        solution_t solution = {0};
+        uint32_t iter_n = 0;
+        if (!solver(n, problem_ptr->m, problem_ptr->is_max, &c.vector, &problem_ptr->A, &b.vector,
+                    &problem_ptr->var_arr, problem_ptr->B, problem_ptr->N, problem_ptr->state, &problem_ptr->options,
+                    &workspace, &solution, &iter_n)) {
+            solution_free(&solution);
+            goto fail;
+        }
+        solution_set_pI_iter(&solution, problem_ptr->pI_iter);
+        solution_set_pII_iter(&solution, iter_n);
+        is_optimal = !solution.is_unbounded;
+
+        // The dual simplex is unbounded when the primal is infeasible
+        if (!is_optimal && solver == simplex_dual) {
+            printf("\n================== %s ==================\ninfeasible\n", name);
+        } else if (!solution_truncate(&solution, m + n)) {
+            solution_free(&solution);
+            goto fail;
+        } else {
+            scaling_unscale_solution(&scaling, &solution);
+            solution_print(&solution, name);
+        }
+        solution_free(&solution);
+    }
+
+    problem_drop_artificials(problem_ptr, m);
+    ret = problem_save_basis(problem_ptr, problem_ptr, NULL);
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    free(row_sign);
+    scenario_free(&scenario);
+    simplex_workspace_free(&workspace);
+    scaling_free(&scaling);
+    return ret;
+}
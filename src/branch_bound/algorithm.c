@@ -1,167 +1,459 @@
 #include "branch_bound/algorithm.h"
 #include "simplex/primal.h"
 #include "simplex/dual.h"
+#include "parallel.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <sched.h>
 
-uint32_t init(const problem_t* problem_ptr, pstack_t* stack_ptr, bb_arena_t* arena_ptr, var_arr_t* var_arr_ptr) {
-    if (!pstack_init(stack_ptr)) {
-        return 0;
+uint32_t solve_relaxation(solve_fn solver, uint32_t is_max, bb_arena_t* arena_ptr, uint32_t n, uint32_t m, int32_t* N,
+                          const options_t* opts_ptr, simplex_workspace_t* workspace_ptr, solution_t* solution_ptr,
+                          uint32_t* iter_n_ptr) {
+    gsl_vector_view c = bb_arena_get_c_view(arena_ptr, n, m);
+    gsl_vector_view b = bb_arena_get_b_view(arena_ptr, n);
+    return (solver)(n, m, is_max, &c.vector, bb_arena_get_A_view(arena_ptr, n, m), &b.vector,
+                    bb_arena_get_var_arr_view(arena_ptr), bb_arena_get_B_view(arena_ptr, n), N,
+                    bb_arena_get_state_view(arena_ptr), opts_ptr, workspace_ptr, solution_ptr, iter_n_ptr);
+}
+
+uint32_t bb_strong_branch(bb_worker_t* worker_ptr, const bb_basis_t* basis_ptr, uint32_t var, double value,
+                          bb_direction_t direction, double* z_ptr) {
+    bb_search_t* search_ptr = worker_ptr->search_ptr;
+    const problem_t* problem_ptr = search_ptr->problem_ptr;
+    uint32_t n = problem_n(problem_ptr);
+    uint32_t m = problem_m(problem_ptr);
+    bb_arena_t* arena_ptr = &worker_ptr->arena;
+
+    // The bound only lives for this solve, the variable gets the bounds of the node back after it
+    variable_t* v = &bb_arena_get_var_arr_view(arena_ptr)->data[var];
+    variable_t saved = *v;
+    if (direction == BB_DOWN) {
+        v->ub = floor(value);
+    } else {
+        v->lb = ceil(value);
     }
 
-    if (!bb_arena_init(arena_ptr, MAX_N, MAX_M)) {
-        pstack_free(stack_ptr);
-        return 0;
+    bb_basis_load(basis_ptr, n, m, bb_arena_get_B_view(arena_ptr, n), worker_ptr->N,
+                  bb_arena_get_state_view(arena_ptr));
+    solution_t child = {0};
+    uint32_t iter_n = 0;
+    worker_ptr->workspace.iter_limit = BB_STRONG_ITER;
+    uint32_t ret = solve_relaxation(simplex_dual, problem_is_max(problem_ptr), arena_ptr, n, m, worker_ptr->N,
+                                    problem_options(problem_ptr), &worker_ptr->workspace, &child, &iter_n);
+    *v = saved;
+    __atomic_add_fetch(&search_ptr->iter_n, iter_n, __ATOMIC_RELAXED);
+
+    if (ret) {
+        *z_ptr = child.is_unbounded ? -INFINITY : child.z;
     }
+    solution_free(&child);
+    return ret;
+}
 
-    bb_arena_copy_problem(arena_ptr, problem_ptr);
+int32_t select_branch_var(bb_worker_t* worker_ptr, const solution_t* current_sol_ptr) {
+    bb_search_t* search_ptr = worker_ptr->search_ptr;
+    bb_pseudocost_t* pseudocost_ptr = &search_ptr->pseudocost;
+    const var_arr_t* var_arr_ptr = bb_arena_get_var_arr_view(&worker_ptr->arena);
+    const gsl_vector* x = solution_x(current_sol_ptr);
+    double z = solution_z(current_sol_ptr);
 
-    if (!var_arr_init(var_arr_ptr, MAX_M)) {
-        pstack_free(stack_ptr);
-        bb_arena_free(arena_ptr);
-        return 0;
+    // Unreliable candidates to strong branch, by decreasing pseudocost score
+    uint32_t strong[BB_STRONG_CANDIDATES];
+    double strong_score[BB_STRONG_CANDIDATES];
+    uint32_t strong_n = 0;
+    uint32_t candidate_n = 0;
+    int32_t first = -1;
+    for (uint32_t j = 0; j < var_arr_length(var_arr_ptr); j++) {
+        if (!variable_is_integer(var_arr_get(var_arr_ptr, j)) || solution_var_is_integer(current_sol_ptr, j)) {
+            continue;
+        }
+        candidate_n++;
+        first = first == -1 ? (int32_t)j : first;
+        if (bb_pseudocost_is_reliable(pseudocost_ptr, j)) {
+            continue;
+        }
+
+        double f = gsl_vector_get(x, j) - floor(gsl_vector_get(x, j));
+        double score = bb_score(bb_pseudocost_get(pseudocost_ptr, j, BB_DOWN) * f,
+                                bb_pseudocost_get(pseudocost_ptr, j, BB_UP) * (1.0 - f));
+        uint32_t k = strong_n < BB_STRONG_CANDIDATES ? strong_n++ : BB_STRONG_CANDIDATES;
+        for (; k > 0 && strong_score[k - 1] < score; k--) {
+            if (k < BB_STRONG_CANDIDATES) {
+                strong[k] = strong[k - 1];
+                strong_score[k] = strong_score[k - 1];
+            }
+        }
+        if (k < BB_STRONG_CANDIDATES) {
+            strong[k] = j;
+            strong_score[k] = score;
+        }
     }
 
-    const var_arr_t* var_arr_og = problem_var_arr(problem_ptr);
+    // Nothing to choose from
+    if (candidate_n <= 1) {
+        return first;
+    }
 
-    memcpy(var_arr_ptr->data, var_arr_og->data, sizeof(variable_t) * var_arr_og->length);
-    var_arr_ptr->length = var_arr_og->length;
+    // The gains of the strong branched children replace their pseudocost estimates. A candidate that cannot be
+    // strong branched keeps its estimate
+    const bb_basis_t* basis_ptr = strong_n > 0 ? bb_worker_basis(worker_ptr) : NULL;
+    for (uint32_t k = 0; k < strong_n && basis_ptr; k++) {
+        uint32_t j = strong[k];
+        double value = gsl_vector_get(x, j);
+        double down_z, up_z;
+        if (!bb_strong_branch(worker_ptr, basis_ptr, j, value, BB_DOWN, &down_z) ||
+            !bb_strong_branch(worker_ptr, basis_ptr, j, value, BB_UP, &up_z)) {
+            continue;
+        }
 
-    return 1;
-}
+        double f = value - floor(value);
+        bb_pseudocost_update(pseudocost_ptr, j, BB_DOWN, z - down_z, f);
+        bb_pseudocost_update(pseudocost_ptr, j, BB_UP, z - up_z, 1.0 - f);
 
-uint32_t solve_relaxation(solve_fn solver, uint32_t is_max, bb_node_t* node_ptr, int32_t* N, solution_t* solution_ptr,
-                          uint32_t* iter_n_ptr) {
-    return (solver)(node_ptr->state.n, node_ptr->state.m, is_max, &node_ptr->c_view.vector, &node_ptr->A_view.matrix,
-                    &node_ptr->b_view.vector, node_ptr->B_view, N, solution_ptr, iter_n_ptr);
+        // An infeasible child scores infinite, so that the node gets rid of it
+        strong_score[k] = bb_score(z - down_z, z - up_z);
+    }
+
+    // The strong branching left the basis of its last child in the arena: the node gets its own back, which the
+    // next solve from it factors again
+    if (basis_ptr) {
+        uint32_t n = problem_n(search_ptr->problem_ptr);
+        bb_basis_load(basis_ptr, n, problem_m(search_ptr->problem_ptr), bb_arena_get_B_view(&worker_ptr->arena, n),
+                      worker_ptr->N, bb_arena_get_state_view(&worker_ptr->arena));
+        worker_ptr->is_factored = 0;
+    }
+
+    // Best product score, ties to the first candidate
+    int32_t best = -1;
+    double best_score = -1.0;
+    for (uint32_t j = 0; j < var_arr_length(var_arr_ptr); j++) {
+        if (!variable_is_integer(var_arr_get(var_arr_ptr, j)) || solution_var_is_integer(current_sol_ptr, j)) {
+            continue;
+        }
+
+        uint32_t k = 0;
+        while (k < strong_n && strong[k] != j) {
+            k++;
+        }
+
+        double score;
+        if (k < strong_n) {
+            score = strong_score[k];
+        } else {
+            double f = gsl_vector_get(x, j) - floor(gsl_vector_get(x, j));
+            score = bb_score(bb_pseudocost_get(pseudocost_ptr, j, BB_DOWN) * f,
+                             bb_pseudocost_get(pseudocost_ptr, j, BB_UP) * (1.0 - f));
+        }
+        if (score > best_score) {
+            best = (int32_t)j;
+            best_score = score;
+        }
+    }
+
+    return best;
 }
 
-// Choses a non-integer variable to start branching from.
-// Returns -1 if the solution contains only
-// integers or the index of the first non-integer
-// variable on success
-int32_t select_branch_var(const var_arr_t* var_arr_ptr, const solution_t* current_sol_ptr) {
-    for (uint32_t i = 0; i < var_arr_length(var_arr_ptr); i++) {
-        const variable_t* v = var_arr_get(var_arr_ptr, i);
-        if (variable_is_integer(v) && !solution_var_is_integer(current_sol_ptr, i)) {
-            return (int32_t)i;
+double bb_estimate(bb_pseudocost_t* pseudocost_ptr, const var_arr_t* var_arr_ptr, const gsl_vector* c,
+                   const solution_t* solution_ptr, uint32_t branch_var, bb_direction_t direction) {
+    double estimate = solution_z(solution_ptr);
+    for (uint32_t j = 0; j < var_arr_length(var_arr_ptr); j++) {
+        if (!variable_is_integer(var_arr_get(var_arr_ptr, j))) {
+            continue;
+        }
+
+        double x = gsl_vector_get(solution_x(solution_ptr), j);
+        double f = x - floor(x);
+        if (f == 0.0) {
+            continue;
+        }
+
+        double down = f;
+        double up = 1.0 - f;
+        uint32_t is_down = bb_pseudocost_is_initialized(pseudocost_ptr, j, BB_DOWN);
+        uint32_t is_up = bb_pseudocost_is_initialized(pseudocost_ptr, j, BB_UP);
+        if (is_down) {
+            down *= bb_pseudocost_get(pseudocost_ptr, j, BB_DOWN);
+        }
+        if (is_up) {
+            up *= bb_pseudocost_get(pseudocost_ptr, j, BB_UP);
+        }
+
+        // The branching variable only moves in the direction of the child
+        double fallback = fabs(gsl_vector_get(c, j)) * fmin(f, 1.0 - f);
+        if (j == branch_var) {
+            estimate -= direction == BB_DOWN ? (is_down ? down : fallback) : (is_up ? up : fallback);
+        } else {
+            estimate -= is_down && is_up ? fmin(down, up) : fallback;
         }
     }
 
-    return -1;
+    return estimate;
 }
 
-uint32_t update(solution_t* best_solution, solution_t* current_solution, bb_node_t* current_node, pstack_t* stack_ptr) {
-    double current_z = solution_z(current_solution);
-    if (solution_is_unbounded(current_solution) || current_z <= solution_z(best_solution)) {
-        // Prune the node
-        solution_free(current_solution);
-        return 1;
+uint32_t bb_branch(bb_worker_t* worker_ptr, bb_node_t* node_ptr, const var_arr_t* var_arr_ptr, const gsl_vector* c,
+                   const solution_t* solution_ptr, int32_t branch_var, uint32_t* is_diving_ptr) {
+    double value = gsl_vector_get(solution_x(solution_ptr), (uint32_t)branch_var);
+    double z = solution_z(solution_ptr);
+    bb_pseudocost_t* pseudocost_ptr = &worker_ptr->search_ptr->pseudocost;
+    double left_estimate = bb_estimate(pseudocost_ptr, var_arr_ptr, c, solution_ptr, (uint32_t)branch_var, BB_DOWN);
+    double right_estimate = bb_estimate(pseudocost_ptr, var_arr_ptr, c, solution_ptr, (uint32_t)branch_var, BB_UP);
+
+    // The optimal basis of the node stays dual feasible under the bounds of its children. The worker keeps its
+    // reference while the arena and the factor still hold it
+    bb_basis_t* basis_ptr = bb_worker_basis(worker_ptr);
+    if (!basis_ptr) {
+        return 0;
+    }
+
+    // Left branch x <= floor(value), right branch x >= ceil(value)
+    bb_node_t left = {0};
+    bb_node_t right = {0};
+    if (!bb_node_branch(&left, node_ptr, (uint32_t)branch_var, value, 'U', z, left_estimate, basis_ptr) ||
+        !bb_node_branch(&right, node_ptr, (uint32_t)branch_var, value, 'L', z, right_estimate, basis_ptr)) {
+        bb_node_free(&left);
+        bb_node_free(&right);
+        return 0;
     }
+    bb_node_free(node_ptr);
 
-    if (!pstack_push(stack_ptr, *current_node)) {
+    uint32_t is_up = value - floor(value) >= 0.5;
+    bb_node_t next = is_up ? right : left;
+    bb_node_t other = is_up ? left : right;
+    *is_diving_ptr = worker_ptr->queue.rule == NODE_SELECT_PLUNGE;
+    if (*is_diving_ptr) {
+        // The child the worker dives into stays open until it is solved
+        __atomic_add_fetch(&worker_ptr->search_ptr->open_n, 1, __ATOMIC_ACQ_REL);
+        *node_ptr = next;
+    } else if (!bb_worker_push(worker_ptr, next)) {
+        bb_node_free(&next);
+        bb_node_free(&other);
         return 0;
     }
 
-    if (solution_is_integer(current_solution)) {
-        solution_set_x(best_solution, (gsl_vector*)solution_x(current_solution));
-        solution_set_z(best_solution, current_z);
+    if (!bb_worker_push(worker_ptr, other)) {
+        bb_node_free(&other);
+        return 0;
     }
 
     return 1;
 }
 
-// Branch and bound method on linear problem p
+uint32_t bb_solve_node(bb_worker_t* worker_ptr, bb_node_t* node_ptr, solution_t* current_ptr,
+                       uint32_t* is_diving_ptr) {
+    bb_search_t* search_ptr = worker_ptr->search_ptr;
+    const problem_t* problem_ptr = search_ptr->problem_ptr;
+    uint32_t n = problem_n(problem_ptr);
+    uint32_t m = problem_m(problem_ptr);
+    bb_arena_t* arena_ptr = &worker_ptr->arena;
+    int32_t* B = bb_arena_get_B_view(arena_ptr, n);
+    var_state_t* state = bb_arena_get_state_view(arena_ptr);
+
+    if (bb_node_is_pruned(node_ptr->bound, bb_search_incumbent(search_ptr))) {
+        bb_node_free(node_ptr);
+        return 1;
+    }
+
+    // Restart from the optimal basis of the parent. A child solved right after its parent on the same worker,
+    // like the plunge does, finds it in the arena and reuses the factor of the parent as well
+    bb_arena_load_node(arena_ptr, node_ptr);
+    if (node_ptr->basis_ptr == worker_ptr->basis_ptr) {
+        worker_ptr->workspace.keep_factor = worker_ptr->is_factored;
+    } else {
+        bb_basis_load(node_ptr->basis_ptr, n, m, B, worker_ptr->N, state);
+    }
+    bb_basis_release(worker_ptr->basis_ptr);
+    worker_ptr->basis_ptr = NULL;
+
+    solution_free(current_ptr);
+    memset(current_ptr, 0, sizeof(solution_t));
+    uint32_t iter_n = 0;
+    if (!solve_relaxation(simplex_dual, problem_is_max(problem_ptr), arena_ptr, n, m, worker_ptr->N,
+                          problem_options(problem_ptr), &worker_ptr->workspace, current_ptr, &iter_n)) {
+        return 0;
+    }
+    __atomic_add_fetch(&search_ptr->iter_n, iter_n, __ATOMIC_RELAXED);
+
+    // The gain of the last branching over the parent relaxation feeds the pseudocost of its variable
+    if (!current_ptr->is_unbounded) {
+        const bb_bound_change_t* change = &node_ptr->changes[node_ptr->depth - 1];
+        bb_pseudocost_update(&search_ptr->pseudocost, change->var, change->direction == 'U' ? BB_DOWN : BB_UP,
+                             node_ptr->bound - current_ptr->z, node_ptr->distance);
+    }
+
+    uint32_t node_n = __atomic_add_fetch(&search_ptr->node_n, 1, __ATOMIC_RELAXED);
+    if (node_n % BB_LOG_PERIOD == 0) {
+        printf("Nodes %u, open %u, incumbent %lf, bound %lf\n", node_n,
+               __atomic_load_n(&search_ptr->open_n, __ATOMIC_RELAXED), bb_search_incumbent(search_ptr),
+               bb_search_bound(search_ptr));
+    }
+
+    // The dual simplex is unbounded when the bounds of the node make it infeasible
+    if (current_ptr->is_unbounded || bb_node_is_pruned(current_ptr->z, bb_search_incumbent(search_ptr))) {
+        bb_node_free(node_ptr);
+        return 1;
+    }
+
+    // An integer solution is offered as the incumbent, the workers drop the open nodes it bounds
+    const var_arr_t* var_arr_ptr = bb_arena_get_var_arr_view(arena_ptr);
+    int32_t branch_var = select_branch_var(worker_ptr, current_ptr);
+    if (branch_var == -1) {
+        bb_search_offer(search_ptr, current_ptr);
+        bb_node_free(node_ptr);
+        return 1;
+    }
+
+    gsl_vector_view c = bb_arena_get_c_view(arena_ptr, n, m);
+    return bb_branch(worker_ptr, node_ptr, var_arr_ptr, &c.vector, current_ptr, branch_var, is_diving_ptr);
+}
+
+void* bb_worker_run(void* arg) {
+    bb_worker_t* worker_ptr = (bb_worker_t*)arg;
+    bb_search_t* search_ptr = worker_ptr->search_ptr;
+
+    // The workers already keep the threads busy, their simplex loops stay on their own thread
+    parallel_serial(1);
+
+    solution_t current = {0};
+    bb_node_t node = {0};
+    uint32_t is_diving = 0;
+    double incumbent = -INFINITY;
+    while (!__atomic_load_n(&search_ptr->is_failed, __ATOMIC_ACQUIRE)) {
+        // Drop the open nodes of the worker that a new incumbent bounds
+        double new_incumbent = bb_search_incumbent(search_ptr);
+        if (new_incumbent > incumbent) {
+            incumbent = new_incumbent;
+            pthread_mutex_lock(&worker_ptr->lock);
+            uint32_t pruned_n = bb_queue_prune(&worker_ptr->queue, incumbent);
+            pthread_mutex_unlock(&worker_ptr->lock);
+            __atomic_sub_fetch(&search_ptr->open_n, pruned_n, __ATOMIC_ACQ_REL);
+        }
+
+        // An idle worker waits while the others may still branch
+        if (!is_diving && !bb_worker_pop(worker_ptr, &node)) {
+            if (__atomic_load_n(&search_ptr->open_n, __ATOMIC_ACQUIRE) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        is_diving = 0;
+
+        __atomic_store(&worker_ptr->node_bound, &node.bound, __ATOMIC_RELAXED);
+        if (!bb_solve_node(worker_ptr, &node, &current, &is_diving)) {
+            __atomic_store_n(&search_ptr->is_failed, 1, __ATOMIC_RELEASE);
+            break;
+        }
+        if (!is_diving) {
+            double idle = -INFINITY;
+            __atomic_store(&worker_ptr->node_bound, &idle, __ATOMIC_RELAXED);
+        }
+
+        // The node is closed once its children are open
+        __atomic_sub_fetch(&search_ptr->open_n, 1, __ATOMIC_ACQ_REL);
+    }
+
+    bb_node_free(&node);
+    solution_free(&current);
+    parallel_serial(0);
+    return NULL;
+}
+
+// Branch and bound method on linear problem p, with one worker per thread of the parallel pool
 uint32_t branch_and_bound(problem_t* problem_ptr, solution_t* solution_ptr) {
     if (!problem_ptr || !solution_ptr) {
         return 0;
     }
 
-    pstack_t stack = {0};
-    bb_arena_t arena = {0};
-    var_arr_t var_arr = {0};
-    if (!init(problem_ptr, &stack, &arena, &var_arr)) {
+    bb_search_t search = {0};
+    if (!bb_search_init(&search, problem_ptr, parallel_threads())) {
         return 0;
     }
 
     uint32_t ret = 1;
-    uint32_t is_max = problem_is_max(problem_ptr);
-    int32_t* N = problem_N_mut(problem_ptr);
+    uint32_t n = problem_n(problem_ptr);
+    uint32_t m = problem_m(problem_ptr);
+    bb_worker_t* main_ptr = &search.workers[0];
+    bb_arena_t* arena_ptr = &main_ptr->arena;
+    gsl_vector_view c = bb_arena_get_c_view(arena_ptr, n, m);
+    const var_arr_t* var_arr_ptr = bb_arena_get_var_arr_view(arena_ptr);
 
     // Start of the algorithm
     solution_t best = {0};
+    solution_t current = {0};
+    bb_node_t node = {0};
+    uint32_t started_n = 1;
 
-    // Solve root relaxation
-    bb_node_t root = {0};
-    bb_node_init_root(&root, problem_n(problem_ptr), problem_m(problem_ptr), &arena);
+    // Solve root relaxation on the first worker, before the others start
     uint32_t iter_n = 0;
-    if (!solve_relaxation(simplex_primal, is_max, &root, N, &best, &iter_n)) {
+    if (!solve_relaxation(simplex_primal, problem_is_max(problem_ptr), arena_ptr, n, m, main_ptr->N,
+                          problem_options(problem_ptr), &main_ptr->workspace, &current, &iter_n)) {
         goto fail;
     }
 
-    // If the solution of the root relaxation is already integer
+    // If the solution of the root relaxation is unbounded or already integer
     // return it
-    solution_print(&best, "Root solution");
-    if (solution_is_integer(&best)) {
-        goto cleanup;
+    solution_print(&current, "Root solution");
+    int32_t branch_var = current.is_unbounded ? -1 : select_branch_var(main_ptr, &current);
+    if (branch_var == -1) {
+        best = current;
+        memset(&current, 0, sizeof(solution_t));
+        goto done;
     }
 
-    // Else push the root to the stack
-    if (!pstack_push(&stack, root)) {
+    // Else branch on the root, whose children the other workers steal
+    uint32_t is_diving = 0;
+    search.node_n = 1;
+    bb_node_init_root(&node, current.z);
+    if (!bb_branch(main_ptr, &node, var_arr_ptr, &c.vector, &current, branch_var, &is_diving)) {
         goto fail;
     }
-    best.z = -1e20;
-
-    while (!pstack_empty(&stack)) {
-        bb_node_t current_node = {0};
-        pstack_pop(&stack, &current_node);
-
-        // Branch, solve relaxations and push nodes into the stack
-        int32_t branch_var = select_branch_var(&var_arr, &best);
-        if (branch_var == -1) {
+    if (is_diving) {
+        if (!bb_queue_push(&main_ptr->queue, node)) {
             goto fail;
         }
-        double bound = gsl_vector_get(solution_x(&best), branch_var);
+        memset(&node, 0, sizeof(bb_node_t));
+    }
 
-        // Left branch
-        if (!bb_node_branch(&current_node, &arena, branch_var, bound, 'U', &var_arr)) {
-            goto fail;
-        }
-        solution_t left_solution = {0};
-        uint32_t left_iter_n = 0;
-        if (!solve_relaxation(simplex_dual, is_max, &current_node, N, &left_solution, &left_iter_n)) {
-            goto fail;
-        }
-        if (!update(&best, &left_solution, &current_node, &stack)) {
-            goto fail;
+    // A worker that fails to start leaves the search with fewer threads, the others steal its nodes
+    for (; started_n < search.worker_n; started_n++) {
+        bb_worker_t* worker_ptr = &search.workers[started_n];
+        if (pthread_create(&worker_ptr->thread, NULL, bb_worker_run, worker_ptr) != 0) {
+            fprintf(stderr, "Failed to start branch and bound worker %u, using %u threads\n", started_n, started_n);
+            break;
         }
-        bb_node_revert_to_parent(&current_node, &arena);
+    }
+    bb_worker_run(main_ptr);
+    for (uint32_t w = 1; w < started_n; w++) {
+        pthread_join(search.workers[w].thread, NULL);
+    }
+    if (search.is_failed) {
+        goto fail;
+    }
+    printf("\nBranch and bound explored %u nodes\n", search.node_n);
 
-        // Right branch
-        if (!bb_node_branch(&current_node, &arena, branch_var, bound, 'U', &var_arr)) {
-            goto fail;
-        }
-        solution_t right_solution = {0};
-        uint32_t right_iter_n = 0;
-        if (!solve_relaxation(simplex_dual, is_max, &current_node, N, &right_solution, &right_iter_n)) {
-            goto fail;
-        }
-        if (!update(&best, &right_solution, &current_node, &stack)) {
-            goto fail;
-        }
-        bb_node_revert_to_parent(&current_node, &arena);
+    if (!isfinite(search.incumbent)) {
+        fprintf(stderr, "No integer solution found by branch and bound\n");
+        goto fail;
     }
+    best = search.best;
+    memset(&search.best, 0, sizeof(solution_t));
+    iter_n += search.iter_n;
 
+done:
+    solution_set_pI_iter(&best, problem_ptr->pI_iter);
+    solution_set_pII_iter(&best, iter_n);
     goto cleanup;
 
 fail:
     ret = 0;
 
 cleanup:
-    pstack_free(&stack);
-    bb_arena_free(&arena);
-    var_arr_free(&var_arr);
+    bb_node_free(&node);
+    bb_search_free(&search);
+    solution_free(&current);
     *solution_ptr = best;
     return ret;
-}
\ No newline at end of file
+}
@@ -1,5 +1,7 @@
 #include "branch_bound/arena.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 uint32_t bb_arena_init(bb_arena_t* arena_ptr, size_t max_n, size_t max_m) {
@@ -9,10 +11,9 @@ uint32_t bb_arena_init(bb_arena_t* arena_ptr, size_t max_n, size_t max_m) {
 
     // Account for artificial variables that could be needed
     size_t c_size = max_m + max_n;
-    size_t A_size = max_n * (max_m + max_n);
     size_t b_size = max_n;
 
-    size_t total_size = c_size + A_size + b_size;
+    size_t total_size = c_size + b_size;
 
     arena_ptr->data = (double*)calloc(total_size, sizeof(double));
     if (!arena_ptr->data) {
@@ -22,37 +23,61 @@ uint32_t bb_arena_init(bb_arena_t* arena_ptr, size_t max_n, size_t max_m) {
     arena_ptr->max_n = max_n;
     arena_ptr->max_m = max_m;
 
-    // Memory layout: [c][A][b]
+    // Memory layout: [c][b], A is stored sparse on its own
     size_t c_off = 0;
-    size_t A_off = c_off + c_size;
-    size_t b_off = A_off + A_size;
+    size_t b_off = c_off + c_size;
 
     arena_ptr->c_base = arena_ptr->data + c_off;
-    arena_ptr->A_base = arena_ptr->data + A_off;
     arena_ptr->b_base = arena_ptr->data + b_off;
+    memset(&arena_ptr->A, 0, sizeof(csc_matrix_t));
 
     arena_ptr->B = (int32_t*)calloc(max_n, sizeof(int32_t));
-    if (!arena_ptr->B) {
-        free(arena_ptr->data);
+    arena_ptr->state = (var_state_t*)calloc(max_m + max_n, sizeof(var_state_t));
+    arena_ptr->root = (variable_t*)malloc(sizeof(variable_t) * max_m);
+    arena_ptr->touched = (uint32_t*)malloc(sizeof(uint32_t) * max_m);
+    arena_ptr->is_touched = (uint8_t*)calloc(max_m, sizeof(uint8_t));
+    arena_ptr->touched_n = 0;
+    if (!arena_ptr->B || !arena_ptr->state || !arena_ptr->root || !arena_ptr->touched || !arena_ptr->is_touched ||
+        !var_arr_init(&arena_ptr->var_arr, max_m)) {
+        bb_arena_free(arena_ptr);
         return 0;
     }
 
     return 1;
 }
 
-void bb_arena_copy_problem(bb_arena_t* arena_ptr, const problem_t* problem_ptr) {
+uint32_t bb_arena_copy_problem(bb_arena_t* arena_ptr, const problem_t* problem_ptr) {
     uint32_t n = problem_n(problem_ptr);
     uint32_t m = problem_m(problem_ptr);
     const gsl_vector* c = problem_c(problem_ptr);
-    const gsl_matrix* A = problem_A(problem_ptr);
+    const csc_matrix_t* A = problem_A(problem_ptr);
     const gsl_vector* b = problem_b(problem_ptr);
     const int32_t* B = problem_B(problem_ptr);
+    const var_state_t* state = problem_state(problem_ptr);
+
+    if (n > arena_ptr->max_n || m > arena_ptr->max_m) {
+        fprintf(stderr, "Problem too big for the branch and bound arena\n");
+        return 0;
+    }
 
     memcpy(arena_ptr->c_base, c->data, sizeof(double) * m);
-    memcpy(arena_ptr->A_base, A->data, sizeof(double) * n * (m + n));
     memcpy(arena_ptr->b_base, b->data, sizeof(double) * n);
 
+    // Only the structural columns, the artificial ones of PhaseI are not needed anymore
+    csc_free(&arena_ptr->A);
+    if (!csc_copy(&arena_ptr->A, A, m, arena_ptr->max_m + arena_ptr->max_n)) {
+        return 0;
+    }
+
     memcpy(arena_ptr->B, B, sizeof(int32_t) * n);
+    memcpy(arena_ptr->state, state, sizeof(var_state_t) * m);
+
+    const var_arr_t* var_arr_og = problem_var_arr(problem_ptr);
+    memcpy(arena_ptr->var_arr.data, var_arr_og->data, sizeof(variable_t) * m);
+    memcpy(arena_ptr->root, var_arr_og->data, sizeof(variable_t) * m);
+    arena_ptr->var_arr.length = m;
+
+    return 1;
 }
 
 // Creates view to cost vector c of size (m + n)
@@ -60,9 +85,10 @@ gsl_vector_view bb_arena_get_c_view(const bb_arena_t* arena_ptr, size_t n, size_
     return gsl_vector_view_array(arena_ptr->c_base, m + n);
 }
 
-// Creates view to constraint matrix A of size (n x (m + n))
-gsl_matrix_view bb_arena_get_A_view(const bb_arena_t* arena_ptr, size_t n, size_t m) {
-    return gsl_matrix_view_array(arena_ptr->A_base, n, m + n);
+// Returns the sparse constraint matrix A, resized to n x m
+csc_matrix_t* bb_arena_get_A_view(bb_arena_t* arena_ptr, size_t n, size_t m) {
+    csc_truncate(&arena_ptr->A, n, m);
+    return &arena_ptr->A;
 }
 
 // Creates view to RHS vector b of size n
@@ -74,6 +100,40 @@ int32_t* bb_arena_get_B_view(const bb_arena_t* arena_ptr, size_t n) {
     return arena_ptr->B;
 }
 
+var_state_t* bb_arena_get_state_view(const bb_arena_t* arena_ptr) {
+    return arena_ptr->state;
+}
+
+var_arr_t* bb_arena_get_var_arr_view(bb_arena_t* arena_ptr) {
+    return &arena_ptr->var_arr;
+}
+
+void bb_arena_load_node(bb_arena_t* arena_ptr, const bb_node_t* node_ptr) {
+    variable_t* vars = arena_ptr->var_arr.data;
+    for (uint32_t k = 0; k < arena_ptr->touched_n; k++) {
+        uint32_t j = arena_ptr->touched[k];
+        vars[j] = arena_ptr->root[j];
+        arena_ptr->is_touched[j] = 0;
+    }
+    arena_ptr->touched_n = 0;
+
+    // A variable branched on twice in the same direction keeps the later, tighter bound
+    for (uint32_t k = 0; k < node_ptr->depth; k++) {
+        const bb_bound_change_t* change = &node_ptr->changes[k];
+        uint32_t j = change->var;
+        if (!arena_ptr->is_touched[j]) {
+            arena_ptr->is_touched[j] = 1;
+            arena_ptr->touched[arena_ptr->touched_n++] = j;
+        }
+
+        if (change->direction == 'U') {
+            vars[j].ub = change->bound;
+        } else {
+            vars[j].lb = change->bound;
+        }
+    }
+}
+
 void bb_arena_free(bb_arena_t* arena_ptr) {
     if (!arena_ptr) {
         return;
@@ -84,8 +144,18 @@ void bb_arena_free(bb_arena_t* arena_ptr) {
     arena_ptr->max_n = 0;
     arena_ptr->max_m = 0;
     arena_ptr->c_base = NULL;
-    arena_ptr->A_base = NULL;
     arena_ptr->b_base = NULL;
+    csc_free(&arena_ptr->A);
     free(arena_ptr->B);
     arena_ptr->B = NULL;
+    free(arena_ptr->state);
+    arena_ptr->state = NULL;
+    var_arr_free(&arena_ptr->var_arr);
+    free(arena_ptr->root);
+    free(arena_ptr->touched);
+    free(arena_ptr->is_touched);
+    arena_ptr->root = NULL;
+    arena_ptr->touched = NULL;
+    arena_ptr->is_touched = NULL;
+    arena_ptr->touched_n = 0;
 }
\ No newline at end of file
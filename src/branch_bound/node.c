@@ -1,88 +1,110 @@
 #include "branch_bound/node.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
-void bb_node_state_init(struct bb_node_state* state_ptr, uint32_t n, uint32_t m) {
-    state_ptr->n = n;
-    state_ptr->m = m;
-}
+bb_basis_t* bb_basis_create(uint32_t n, uint32_t m, const int32_t* B, const int32_t* N, const var_state_t* state) {
+    bb_basis_t* basis_ptr = (bb_basis_t*)malloc(sizeof(bb_basis_t));
+    if (!basis_ptr) {
+        return NULL;
+    }
 
-uint32_t bb_node_init_root(bb_node_t* node_ptr, uint32_t n, uint32_t m, const bb_arena_t* arena_ptr) {
-    if (!node_ptr || !arena_ptr) {
-        return 0;
+    // B and N share one block
+    basis_ptr->B = (int32_t*)malloc(sizeof(int32_t) * m);
+    basis_ptr->state = (var_state_t*)malloc(sizeof(var_state_t) * m);
+    if (!basis_ptr->B || !basis_ptr->state) {
+        free(basis_ptr->B);
+        free(basis_ptr->state);
+        free(basis_ptr);
+        return NULL;
     }
+    basis_ptr->N = basis_ptr->B + n;
+    basis_ptr->ref_n = 1;
 
-    bb_node_state_init(&node_ptr->state, n, m);
-    node_ptr->c_view = bb_arena_get_c_view(arena_ptr, n, m);
-    node_ptr->A_view = bb_arena_get_A_view(arena_ptr, n, m);
-    node_ptr->b_view = bb_arena_get_b_view(arena_ptr, n);
-    node_ptr->B_view = bb_arena_get_B_view(arena_ptr, n);
-    node_ptr->parent_state = node_ptr->state;
+    memcpy(basis_ptr->B, B, sizeof(int32_t) * n);
+    memcpy(basis_ptr->N, N, sizeof(int32_t) * (m - n));
+    memcpy(basis_ptr->state, state, sizeof(var_state_t) * m);
 
-    return 1;
+    return basis_ptr;
 }
 
-uint32_t bb_node_init(bb_node_t* node_ptr, uint32_t n, uint32_t m, const bb_arena_t* arena_ptr,
-                      struct bb_node_state parent_state) {
-    if (!node_ptr || !arena_ptr) {
-        return 0;
+bb_basis_t* bb_basis_retain(bb_basis_t* basis_ptr) {
+    __atomic_add_fetch(&basis_ptr->ref_n, 1, __ATOMIC_RELAXED);
+    return basis_ptr;
+}
+
+void bb_basis_release(bb_basis_t* basis_ptr) {
+    if (!basis_ptr || __atomic_sub_fetch(&basis_ptr->ref_n, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
     }
 
-    bb_node_state_init(&node_ptr->state, n, m);
-    node_ptr->c_view = bb_arena_get_c_view(arena_ptr, n, m);
-    node_ptr->A_view = bb_arena_get_A_view(arena_ptr, n, m);
-    node_ptr->b_view = bb_arena_get_b_view(arena_ptr, n);
-    node_ptr->B_view = bb_arena_get_B_view(arena_ptr, n);
-    node_ptr->parent_state = parent_state;
+    free(basis_ptr->B);
+    free(basis_ptr->state);
+    free(basis_ptr);
+}
 
-    return 1;
+void bb_basis_load(const bb_basis_t* basis_ptr, uint32_t n, uint32_t m, int32_t* B, int32_t* N, var_state_t* state) {
+    memcpy(B, basis_ptr->B, sizeof(int32_t) * n);
+    memcpy(N, basis_ptr->N, sizeof(int32_t) * (m - n));
+    memcpy(state, basis_ptr->state, sizeof(var_state_t) * m);
+}
+
+void bb_node_init_root(bb_node_t* node_ptr, double bound) {
+    node_ptr->bound = bound;
+    node_ptr->estimate = bound;
+    node_ptr->depth = 0;
+    node_ptr->distance = 0.0;
+    node_ptr->changes = NULL;
+    node_ptr->basis_ptr = NULL;
 }
 
-// Adds a bound on the variable with index branch_var_index.
-// Direction can either be 'L' (Lower bound) or 'U' (Upper bound)
-uint32_t bb_node_branch(bb_node_t* node_ptr, const bb_arena_t* arena_ptr, int32_t branch_var_index, double bound,
-                        char direction, var_arr_t* var_arr_ptr) {
-    if ((direction != 'U' && direction != 'L') || !node_ptr || !arena_ptr || !var_arr_ptr || branch_var_index < 0) {
+// Creates the child of parent_ptr that adds a bound on the variable with index branch_var_index and restarts
+// from basis_ptr, the optimal basis of the parent, which it takes a reference to.
+// Direction can either be 'L' (Lower bound, x >= ceil(value)) or 'U' (Upper bound, x <= floor(value))
+uint32_t bb_node_branch(bb_node_t* child_ptr, const bb_node_t* parent_ptr, uint32_t branch_var_index, double value,
+                        char direction, double bound, double estimate, bb_basis_t* basis_ptr) {
+    if ((direction != 'U' && direction != 'L') || !child_ptr || !parent_ptr) {
         fprintf(stderr, "NULL parameters or unknown direction in bb_node_branch\n");
         return 0;
     }
 
-    struct bb_node_state parent_state = {.n = node_ptr->state.n, .m = node_ptr->state.m};
-    uint32_t n = parent_state.n;
-    uint32_t m = parent_state.m;
-
-    if (!bb_node_init(node_ptr, n + 1, m + 1, arena_ptr, parent_state)) {
+    uint32_t depth = parent_ptr->depth;
+    child_ptr->changes = (bb_bound_change_t*)malloc(sizeof(bb_bound_change_t) * (depth + 1));
+    if (!child_ptr->changes) {
         return 0;
     }
+    if (depth > 0) {
+        memcpy(child_ptr->changes, parent_ptr->changes, sizeof(bb_bound_change_t) * depth);
+    }
 
-    // Direction == 'U' => x[branch_var_index] <= floor(bound)
-    // Direction == 'L' => x[branch_var_index] >= ceil(bound)
-    bound = direction == 'U' ? floor(bound) : ceil(bound);
-
-    gsl_matrix* A = &node_ptr->A_view.matrix;
-    gsl_vector* b = &node_ptr->b_view.vector;
-    int32_t* B = node_ptr->B_view;
+    bb_bound_change_t* change = &child_ptr->changes[depth];
+    change->bound = direction == 'U' ? floor(value) : ceil(value);
+    change->var = branch_var_index;
+    change->direction = direction;
 
-    // Add bound value
-    gsl_vector_set(b, n, bound);
+    child_ptr->bound = bound;
+    child_ptr->estimate = estimate;
+    child_ptr->depth = depth + 1;
+    child_ptr->distance = direction == 'U' ? value - floor(value) : ceil(value) - value;
+    child_ptr->basis_ptr = bb_basis_retain(basis_ptr);
 
-    // Set the branch variable and the new slack/surplus variable
-    gsl_matrix_set(A, n, (uint32_t)branch_var_index, 1.0);
-    gsl_matrix_set(A, n, m, direction == 'U' ? 1.0 : -1.0);
+    return 1;
+}
 
-    // Add the new slack/surplus variable to the base
-    B[n] = (int32_t)m;
+uint32_t bb_node_is_pruned(double bound, double incumbent) {
+    // Without an incumbent (-INFINITY) nothing is pruned
+    return isfinite(incumbent) && bound <= incumbent + BB_PRUNE_TOL * fmax(1.0, fabs(incumbent));
+}
 
-    // Push the new variable to the array
-    variable_t v;
-    if (!variable_init_real_positive(&v, 10e9) || !var_arr_push(var_arr_ptr, &v)) {
-        return 0;
+void bb_node_free(bb_node_t* node_ptr) {
+    if (!node_ptr) {
+        return;
     }
 
-    return 1;
+    free(node_ptr->changes);
+    bb_basis_release(node_ptr->basis_ptr);
+    node_ptr->changes = NULL;
+    node_ptr->basis_ptr = NULL;
 }
-
-uint32_t bb_node_revert_to_parent(bb_node_t* node_ptr, const bb_arena_t* arena_ptr) {
-    struct bb_node_state parent_state = node_ptr->parent_state;
-    return bb_node_init(node_ptr, parent_state.n, parent_state.m, arena_ptr, parent_state);
-}
\ No newline at end of file
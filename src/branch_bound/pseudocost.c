@@ -0,0 +1,96 @@
+#include "branch_bound/pseudocost.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+uint32_t bb_pseudocost_init(bb_pseudocost_t* pseudocost_ptr, uint32_t var_n) {
+    if (!pseudocost_ptr) {
+        return 0;
+    }
+
+    pseudocost_ptr->var_n = var_n;
+    pthread_mutex_init(&pseudocost_ptr->lock, NULL);
+    for (uint32_t d = 0; d < 2; d++) {
+        pseudocost_ptr->gain[d] = (double*)calloc(var_n, sizeof(double));
+        pseudocost_ptr->count[d] = (uint32_t*)calloc(var_n, sizeof(uint32_t));
+        pseudocost_ptr->total_gain[d] = 0.0;
+        pseudocost_ptr->total_count[d] = 0;
+    }
+    if (!pseudocost_ptr->gain[BB_DOWN] || !pseudocost_ptr->gain[BB_UP] || !pseudocost_ptr->count[BB_DOWN] ||
+        !pseudocost_ptr->count[BB_UP]) {
+        fprintf(stderr, "Failed to allocate the pseudocosts\n");
+        bb_pseudocost_free(pseudocost_ptr);
+        return 0;
+    }
+
+    return 1;
+}
+
+void bb_pseudocost_update(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction, double gain,
+                          double distance) {
+    if (var >= pseudocost_ptr->var_n || distance <= 0.0 || !isfinite(gain)) {
+        return;
+    }
+
+    // The relaxation of a child cannot beat its parent, a negative gain is only rounding
+    double unit_gain = fmax(gain, 0.0) / distance;
+
+    pthread_mutex_lock(&pseudocost_ptr->lock);
+    pseudocost_ptr->gain[direction][var] += unit_gain;
+    pseudocost_ptr->count[direction][var]++;
+    pseudocost_ptr->total_gain[direction] += unit_gain;
+    pseudocost_ptr->total_count[direction]++;
+    pthread_mutex_unlock(&pseudocost_ptr->lock);
+}
+
+double bb_pseudocost_get(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction) {
+    double pseudocost = 1.0;
+
+    pthread_mutex_lock(&pseudocost_ptr->lock);
+    uint32_t count = pseudocost_ptr->count[direction][var];
+    if (count > 0) {
+        pseudocost = pseudocost_ptr->gain[direction][var] / count;
+    } else if (pseudocost_ptr->total_count[direction] > 0) {
+        pseudocost = pseudocost_ptr->total_gain[direction] / pseudocost_ptr->total_count[direction];
+    }
+    pthread_mutex_unlock(&pseudocost_ptr->lock);
+
+    return pseudocost;
+}
+
+uint32_t bb_pseudocost_is_initialized(bb_pseudocost_t* pseudocost_ptr, uint32_t var, bb_direction_t direction) {
+    pthread_mutex_lock(&pseudocost_ptr->lock);
+    uint32_t is_initialized = pseudocost_ptr->count[direction][var] > 0;
+    pthread_mutex_unlock(&pseudocost_ptr->lock);
+
+    return is_initialized;
+}
+
+uint32_t bb_pseudocost_is_reliable(bb_pseudocost_t* pseudocost_ptr, uint32_t var) {
+    pthread_mutex_lock(&pseudocost_ptr->lock);
+    uint32_t is_reliable = pseudocost_ptr->count[BB_DOWN][var] >= BB_RELIABILITY &&
+                           pseudocost_ptr->count[BB_UP][var] >= BB_RELIABILITY;
+    pthread_mutex_unlock(&pseudocost_ptr->lock);
+
+    return is_reliable;
+}
+
+double bb_score(double down_gain, double up_gain) {
+    return fmax(down_gain, BB_SCORE_EPS) * fmax(up_gain, BB_SCORE_EPS);
+}
+
+void bb_pseudocost_free(bb_pseudocost_t* pseudocost_ptr) {
+    if (!pseudocost_ptr) {
+        return;
+    }
+
+    for (uint32_t d = 0; d < 2; d++) {
+        free(pseudocost_ptr->gain[d]);
+        free(pseudocost_ptr->count[d]);
+        pseudocost_ptr->gain[d] = NULL;
+        pseudocost_ptr->count[d] = NULL;
+    }
+    pthread_mutex_destroy(&pseudocost_ptr->lock);
+    pseudocost_ptr->var_n = 0;
+}
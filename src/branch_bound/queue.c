@@ -0,0 +1,162 @@
+#include "branch_bound/queue.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+// Boolean value to know if node a is explored before node b
+uint32_t bb_queue_before(const bb_queue_t* queue_ptr, const bb_node_t* a, const bb_node_t* b) {
+    double key_a = queue_ptr->rule == NODE_SELECT_ESTIMATE ? a->estimate : a->bound;
+    double key_b = queue_ptr->rule == NODE_SELECT_ESTIMATE ? b->estimate : b->bound;
+    if (key_a != key_b) {
+        return key_a > key_b;
+    }
+
+    return a->depth > b->depth;
+}
+
+void bb_queue_sift_up(bb_queue_t* queue_ptr, uint32_t i) {
+    bb_node_t* nodes = queue_ptr->nodes;
+    bb_node_t node = nodes[i];
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!bb_queue_before(queue_ptr, &node, &nodes[parent])) {
+            break;
+        }
+        nodes[i] = nodes[parent];
+        i = parent;
+    }
+    nodes[i] = node;
+}
+
+void bb_queue_sift_down(bb_queue_t* queue_ptr, uint32_t i) {
+    bb_node_t* nodes = queue_ptr->nodes;
+    bb_node_t node = nodes[i];
+    uint32_t size = queue_ptr->size;
+    while (2 * i + 1 < size) {
+        uint32_t child = 2 * i + 1;
+        if (child + 1 < size && bb_queue_before(queue_ptr, &nodes[child + 1], &nodes[child])) {
+            child++;
+        }
+        if (!bb_queue_before(queue_ptr, &nodes[child], &node)) {
+            break;
+        }
+        nodes[i] = nodes[child];
+        i = child;
+    }
+    nodes[i] = node;
+}
+
+uint32_t bb_queue_init(bb_queue_t* queue_ptr, node_select_t rule) {
+    if (!queue_ptr) {
+        return 0;
+    }
+
+    queue_ptr->nodes = (bb_node_t*)malloc(sizeof(bb_node_t) * BB_QUEUE_INITIAL_CAPACITY);
+    if (!queue_ptr->nodes) {
+        return 0;
+    }
+    queue_ptr->size = 0;
+    queue_ptr->capacity = BB_QUEUE_INITIAL_CAPACITY;
+    queue_ptr->rule = rule;
+
+    return 1;
+}
+
+uint32_t bb_queue_empty(const bb_queue_t* queue_ptr) {
+    return !queue_ptr || queue_ptr->size == 0;
+}
+
+uint32_t bb_queue_size(const bb_queue_t* queue_ptr) {
+    return queue_ptr ? queue_ptr->size : 0;
+}
+
+uint32_t bb_queue_push(bb_queue_t* queue_ptr, bb_node_t bb_node) {
+    if (!queue_ptr) {
+        return 0;
+    }
+
+    if (queue_ptr->size == queue_ptr->capacity) {
+        uint32_t capacity = 2 * queue_ptr->capacity;
+        bb_node_t* nodes = (bb_node_t*)realloc(queue_ptr->nodes, sizeof(bb_node_t) * capacity);
+        if (!nodes) {
+            return 0;
+        }
+        queue_ptr->nodes = nodes;
+        queue_ptr->capacity = capacity;
+    }
+
+    queue_ptr->nodes[queue_ptr->size++] = bb_node;
+    bb_queue_sift_up(queue_ptr, queue_ptr->size - 1);
+
+    return 1;
+}
+
+uint32_t bb_queue_pop(bb_queue_t* queue_ptr, bb_node_t* bb_node_ptr) {
+    if (bb_queue_empty(queue_ptr) || !bb_node_ptr) {
+        return 0;
+    }
+
+    *bb_node_ptr = queue_ptr->nodes[0];
+    queue_ptr->nodes[0] = queue_ptr->nodes[--queue_ptr->size];
+    if (queue_ptr->size > 0) {
+        bb_queue_sift_down(queue_ptr, 0);
+    }
+
+    return 1;
+}
+
+double bb_queue_bound(const bb_queue_t* queue_ptr) {
+    if (bb_queue_empty(queue_ptr)) {
+        return -INFINITY;
+    }
+
+    // The top of a heap on the estimates is not the best bound
+    if (queue_ptr->rule != NODE_SELECT_ESTIMATE) {
+        return queue_ptr->nodes[0].bound;
+    }
+
+    double bound = -INFINITY;
+    for (uint32_t i = 0; i < queue_ptr->size; i++) {
+        bound = fmax(bound, queue_ptr->nodes[i].bound);
+    }
+    return bound;
+}
+
+uint32_t bb_queue_prune(bb_queue_t* queue_ptr, double incumbent) {
+    if (bb_queue_empty(queue_ptr)) {
+        return 0;
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < queue_ptr->size; i++) {
+        if (bb_node_is_pruned(queue_ptr->nodes[i].bound, incumbent)) {
+            bb_node_free(&queue_ptr->nodes[i]);
+        } else {
+            queue_ptr->nodes[kept++] = queue_ptr->nodes[i];
+        }
+    }
+
+    uint32_t pruned = queue_ptr->size - kept;
+    queue_ptr->size = kept;
+    if (pruned > 0) {
+        for (uint32_t i = kept / 2; i-- > 0;) {
+            bb_queue_sift_down(queue_ptr, i);
+        }
+    }
+
+    return pruned;
+}
+
+void bb_queue_free(bb_queue_t* queue_ptr) {
+    if (!queue_ptr) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < queue_ptr->size; i++) {
+        bb_node_free(&queue_ptr->nodes[i]);
+    }
+    free(queue_ptr->nodes);
+    queue_ptr->nodes = NULL;
+    queue_ptr->size = 0;
+    queue_ptr->capacity = 0;
+}
@@ -0,0 +1,170 @@
+#include "branch_bound/worker.h"
+#include "branch_bound/algorithm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+uint32_t bb_worker_init(bb_worker_t* worker_ptr, bb_search_t* search_ptr, uint32_t id) {
+    const problem_t* problem_ptr = search_ptr->problem_ptr;
+    const options_t* opts_ptr = problem_options(problem_ptr);
+    uint32_t n = problem_n(problem_ptr);
+    uint32_t m = problem_m(problem_ptr);
+
+    worker_ptr->id = id;
+    worker_ptr->node_bound = -INFINITY;
+    worker_ptr->search_ptr = search_ptr;
+    pthread_mutex_init(&worker_ptr->lock, NULL);
+    if (!bb_queue_init(&worker_ptr->queue, opts_ptr->node_select)) {
+        return 0;
+    }
+
+    // Every relaxation of the worker reuses the same factor, pricing weights and vectors, sized once for the model
+    // (the arena adds the room of the artificial variables itself) since the nodes only change bounds
+    worker_ptr->N = (int32_t*)malloc(sizeof(int32_t) * (m - n));
+    if (!worker_ptr->N || !bb_arena_init(&worker_ptr->arena, n, m) ||
+        !bb_arena_copy_problem(&worker_ptr->arena, problem_ptr) ||
+        !simplex_workspace_init(&worker_ptr->workspace, n, m + n, opts_ptr)) {
+        return 0;
+    }
+    memcpy(worker_ptr->N, problem_N(problem_ptr), sizeof(int32_t) * (m - n));
+
+    return 1;
+}
+
+void bb_worker_free(bb_worker_t* worker_ptr) {
+    bb_queue_free(&worker_ptr->queue);
+    pthread_mutex_destroy(&worker_ptr->lock);
+    bb_basis_release(worker_ptr->basis_ptr);
+    worker_ptr->basis_ptr = NULL;
+    bb_arena_free(&worker_ptr->arena);
+    simplex_workspace_free(&worker_ptr->workspace);
+    free(worker_ptr->N);
+    worker_ptr->N = NULL;
+}
+
+uint32_t bb_search_init(bb_search_t* search_ptr, const problem_t* problem_ptr, uint32_t worker_n) {
+    memset(search_ptr, 0, sizeof(bb_search_t));
+    search_ptr->problem_ptr = problem_ptr;
+    search_ptr->incumbent = -INFINITY;
+    pthread_mutex_init(&search_ptr->best_lock, NULL);
+
+    search_ptr->workers = (bb_worker_t*)calloc(worker_n, sizeof(bb_worker_t));
+    if (!bb_pseudocost_init(&search_ptr->pseudocost, problem_m(problem_ptr)) || !search_ptr->workers) {
+        bb_search_free(search_ptr);
+        return 0;
+    }
+
+    for (uint32_t w = 0; w < worker_n; w++) {
+        search_ptr->worker_n++;
+        if (!bb_worker_init(&search_ptr->workers[w], search_ptr, w)) {
+            bb_search_free(search_ptr);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+double bb_search_incumbent(const bb_search_t* search_ptr) {
+    double incumbent;
+    __atomic_load(&search_ptr->incumbent, &incumbent, __ATOMIC_ACQUIRE);
+    return incumbent;
+}
+
+uint32_t bb_search_offer(bb_search_t* search_ptr, solution_t* solution_ptr) {
+    uint32_t is_better = 0;
+
+    // The value is published after the solution, so a worker that prunes on it can rely on best
+    pthread_mutex_lock(&search_ptr->best_lock);
+    if (solution_ptr->z > search_ptr->incumbent) {
+        solution_free(&search_ptr->best);
+        search_ptr->best = *solution_ptr;
+        memset(solution_ptr, 0, sizeof(solution_t));
+        __atomic_store(&search_ptr->incumbent, &search_ptr->best.z, __ATOMIC_RELEASE);
+        is_better = 1;
+    }
+    pthread_mutex_unlock(&search_ptr->best_lock);
+
+    return is_better;
+}
+
+double bb_search_bound(bb_search_t* search_ptr) {
+    double bound = -INFINITY;
+    for (uint32_t w = 0; w < search_ptr->worker_n; w++) {
+        bb_worker_t* worker_ptr = &search_ptr->workers[w];
+        double node_bound;
+        __atomic_load(&worker_ptr->node_bound, &node_bound, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&worker_ptr->lock);
+        double queue_bound = bb_queue_bound(&worker_ptr->queue);
+        pthread_mutex_unlock(&worker_ptr->lock);
+
+        bound = fmax(bound, fmax(node_bound, queue_bound));
+    }
+
+    return bound;
+}
+
+void bb_search_free(bb_search_t* search_ptr) {
+    for (uint32_t w = 0; w < search_ptr->worker_n; w++) {
+        bb_worker_free(&search_ptr->workers[w]);
+    }
+    free(search_ptr->workers);
+    solution_free(&search_ptr->best);
+    bb_pseudocost_free(&search_ptr->pseudocost);
+    pthread_mutex_destroy(&search_ptr->best_lock);
+    search_ptr->workers = NULL;
+    search_ptr->worker_n = 0;
+}
+
+bb_basis_t* bb_worker_basis(bb_worker_t* worker_ptr) {
+    if (!worker_ptr->basis_ptr) {
+        const problem_t* problem_ptr = worker_ptr->search_ptr->problem_ptr;
+        uint32_t n = problem_n(problem_ptr);
+        worker_ptr->basis_ptr = bb_basis_create(n, problem_m(problem_ptr), bb_arena_get_B_view(&worker_ptr->arena, n),
+                                                worker_ptr->N, bb_arena_get_state_view(&worker_ptr->arena));
+        worker_ptr->is_factored = 1;
+    }
+
+    return worker_ptr->basis_ptr;
+}
+
+uint32_t bb_worker_push(bb_worker_t* worker_ptr, bb_node_t bb_node) {
+    // Counted before it is queued, so that open_n never reaches 0 while a node is left
+    __atomic_add_fetch(&worker_ptr->search_ptr->open_n, 1, __ATOMIC_ACQ_REL);
+
+    pthread_mutex_lock(&worker_ptr->lock);
+    uint32_t ret = bb_queue_push(&worker_ptr->queue, bb_node);
+    pthread_mutex_unlock(&worker_ptr->lock);
+
+    if (!ret) {
+        __atomic_sub_fetch(&worker_ptr->search_ptr->open_n, 1, __ATOMIC_ACQ_REL);
+    }
+
+    return ret;
+}
+
+uint32_t bb_worker_pop(bb_worker_t* worker_ptr, bb_node_t* bb_node_ptr) {
+    pthread_mutex_lock(&worker_ptr->lock);
+    uint32_t ret = bb_queue_pop(&worker_ptr->queue, bb_node_ptr);
+    pthread_mutex_unlock(&worker_ptr->lock);
+    if (ret) {
+        return 1;
+    }
+
+    // Steal the node the other worker would explore next, starting from the next worker so that the thieves spread
+    bb_search_t* search_ptr = worker_ptr->search_ptr;
+    for (uint32_t k = 1; k < search_ptr->worker_n; k++) {
+        bb_worker_t* victim_ptr = &search_ptr->workers[(worker_ptr->id + k) % search_ptr->worker_n];
+        pthread_mutex_lock(&victim_ptr->lock);
+        ret = bb_queue_pop(&victim_ptr->queue, bb_node_ptr);
+        pthread_mutex_unlock(&victim_ptr->lock);
+        if (ret) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
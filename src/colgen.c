@@ -0,0 +1,470 @@
+#include "colgen.h"
+#include "utils.h"
+#include "simplex/primal.h"
+#include "simplex/dual.h"
+#include "simplex/utils.h"
+#include "simplex/workspace.h"
+#include "branch_bound/algorithm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* COLUMNS */
+uint32_t colgen_columns_init(colgen_columns_t* columns_ptr, uint32_t n) {
+    if (!columns_ptr) {
+        return 0;
+    }
+
+    columns_ptr->c = (double*)malloc(sizeof(double) * COLGEN_ROUND_COLUMNS);
+    columns_ptr->ub = (double*)malloc(sizeof(double) * COLGEN_ROUND_COLUMNS);
+    if (!columns_ptr->c || !columns_ptr->ub || !csc_init(&columns_ptr->A, n, COLGEN_ROUND_COLUMNS, n)) {
+        fprintf(stderr, "Failed to allocate the generated columns\n");
+        colgen_columns_free(columns_ptr);
+        return 0;
+    }
+
+    return 1;
+}
+
+uint32_t colgen_columns_push(colgen_columns_t* columns_ptr, double c, double ub, const uint32_t* rows,
+                             const double* values, uint32_t length) {
+    if (!columns_ptr || columns_ptr->A.cols >= COLGEN_ROUND_COLUMNS) {
+        return 0;
+    }
+
+    uint32_t k = columns_ptr->A.cols;
+    if (!csc_push_column(&columns_ptr->A, rows, values, length)) {
+        return 0;
+    }
+    columns_ptr->c[k] = c;
+    columns_ptr->ub[k] = ub;
+
+    return 1;
+}
+
+void colgen_columns_free(colgen_columns_t* columns_ptr) {
+    if (!columns_ptr) {
+        return;
+    }
+
+    csc_free(&columns_ptr->A);
+    free(columns_ptr->c);
+    free(columns_ptr->ub);
+    columns_ptr->c = NULL;
+    columns_ptr->ub = NULL;
+}
+
+/* MASTER */
+// Appends the columns with keep[k] set to the master, nonbasic at 0. Their entries are flipped on the rows
+// problem_make_RHS_positive flipped. AB does not change, so the factorization of the basis stays valid
+uint32_t colgen_append(problem_t* problem_ptr, const colgen_columns_t* columns_ptr, const uint8_t* keep,
+                       const double* row_sign, uint32_t** age_ptr) {
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    const csc_matrix_t* C = &columns_ptr->A;
+
+    uint32_t new_m = m;
+    for (uint32_t k = 0; k < C->cols; k++) {
+        new_m += keep[k];
+    }
+    uint32_t capacity = 2 * new_m + n;
+
+    // The costs, A and the variables grow geometrically, the states and ages to the exact size
+    if (problem_ptr->c->size < new_m + n) {
+        gsl_vector* c = gsl_vector_calloc(capacity);
+        if (!c) {
+            return 0;
+        }
+        for (uint32_t j = 0; j < m; j++) {
+            gsl_vector_set(c, j, gsl_vector_get(problem_ptr->c, j));
+        }
+        gsl_vector_free(problem_ptr->c);
+        problem_ptr->c = c;
+    }
+
+    if (problem_ptr->A.col_capacity < new_m + n) {
+        csc_matrix_t A = {0};
+        if (!csc_copy(&A, &problem_ptr->A, m, capacity)) {
+            return 0;
+        }
+        csc_free(&problem_ptr->A);
+        problem_ptr->A = A;
+    }
+
+    if (problem_ptr->var_arr.capacity < new_m + n) {
+        var_arr_t var_arr = {0};
+        if (!var_arr_init(&var_arr, capacity)) {
+            return 0;
+        }
+        memcpy(var_arr.data, problem_ptr->var_arr.data, sizeof(variable_t) * m);
+        var_arr.length = m;
+        var_arr_free(&problem_ptr->var_arr);
+        problem_ptr->var_arr = var_arr;
+    }
+
+    var_state_t* state = (var_state_t*)realloc(problem_ptr->state, sizeof(var_state_t) * (new_m + n));
+    if (!state) {
+        return 0;
+    }
+    problem_ptr->state = state;
+
+    uint32_t* age = (uint32_t*)realloc(*age_ptr, sizeof(uint32_t) * new_m);
+    if (!age) {
+        return 0;
+    }
+    *age_ptr = age;
+
+    uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+    double* values = (double*)malloc(sizeof(double) * (n + 1));
+    if (!rows || !values) {
+        free(rows);
+        free(values);
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t j = m;
+    for (uint32_t k = 0; k < C->cols && ret; k++) {
+        if (!keep[k]) {
+            continue;
+        }
+
+        uint32_t length = 0;
+        for (uint32_t s = C->col_ptr[k]; s < C->col_ptr[k + 1]; s++) {
+            rows[length] = C->row_idx[s];
+            values[length++] = row_sign[C->row_idx[s]] * C->values[s];
+        }
+
+        variable_t v;
+        variable_init(&v, 0.0, columns_ptr->ub[k], VAR_REAL);
+        ret = csc_push_column(&problem_ptr->A, rows, values, length) && var_arr_push(&problem_ptr->var_arr, &v);
+        gsl_vector_set(problem_ptr->c, j, columns_ptr->c[k]);
+        state[j] = VAR_STATE_LOWER;
+        age[j++] = 0;
+    }
+    free(rows);
+    free(values);
+    if (!ret) {
+        return 0;
+    }
+
+    problem_ptr->m = new_m;
+    free(problem_ptr->N);
+    problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, new_m + n);
+    return problem_ptr->N != NULL;
+}
+
+// Ages the generated columns (from first on): one more round for those nonbasic at 0, back to 0 for the others.
+// The ones that reach COLGEN_MAX_AGE are removed from the master. B keeps its order, so the factorization of the
+// basis stays valid. Returns the number of columns removed, or -1 on error
+int32_t colgen_purge(problem_t* problem_ptr, uint32_t first, uint32_t* age) {
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    var_state_t* state = problem_ptr->state;
+
+    uint8_t* keep = (uint8_t*)malloc(sizeof(uint8_t) * m);
+    int32_t* map = (int32_t*)malloc(sizeof(int32_t) * m);
+    if (!keep || !map) {
+        free(keep);
+        free(map);
+        return -1;
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t j = 0; j < m; j++) {
+        keep[j] = 1;
+        if (j >= first) {
+            uint32_t is_zero = state[j] != VAR_STATE_BASIC && nonbasic_value(&problem_ptr->var_arr, state, j) == 0.0;
+            age[j] = is_zero ? age[j] + 1 : 0;
+            keep[j] = age[j] < COLGEN_MAX_AGE;
+        }
+
+        map[j] = keep[j] ? (int32_t)kept : -1;
+        if (keep[j]) {
+            gsl_vector_set(problem_ptr->c, kept, gsl_vector_get(problem_ptr->c, j));
+            problem_ptr->var_arr.data[kept] = problem_ptr->var_arr.data[j];
+            state[kept] = state[j];
+            age[kept] = age[j];
+            kept++;
+        }
+    }
+
+    int32_t purged = (int32_t)(m - kept);
+    if (purged > 0) {
+        csc_keep_columns(&problem_ptr->A, keep);
+        problem_ptr->var_arr.length = kept;
+        problem_ptr->m = kept;
+        for (uint32_t i = 0; i < n; i++) {
+            problem_ptr->B[i] = map[problem_ptr->B[i]];
+        }
+
+        free(problem_ptr->N);
+        problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, kept + n);
+        if (!problem_ptr->N) {
+            purged = -1;
+        }
+    }
+
+    free(keep);
+    free(map);
+    return purged;
+}
+
+uint32_t problem_solve_colgen(problem_t* problem_ptr, colgen_oracle_fn oracle, void* ctx, solution_t* solution_ptr) {
+    if (!problem_ptr || !oracle || !solution_ptr) {
+        fprintf(stderr, "Some arguments are NULL in problem_solve_colgen\n");
+        return 0;
+    }
+
+    if (problem_is_milp(problem_ptr)) {
+        fprintf(stderr, "Columns can only be generated for LPs\n");
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t is_max = problem_ptr->is_max;
+    uint32_t ret = 1;
+    uint32_t* age = NULL;
+    uint8_t* keep = (uint8_t*)malloc(sizeof(uint8_t) * COLGEN_ROUND_COLUMNS);
+    double* row_sign = (double*)malloc(sizeof(double) * n);
+    gsl_vector* y = gsl_vector_alloc(n);
+    solution_t current = {0};
+    colgen_columns_t columns = {0};
+    simplex_workspace_t workspace = {0};
+    if (!keep || !row_sign || !y || !colgen_columns_init(&columns, n) ||
+        !problem_load_basis(problem_ptr, problem_ptr, NULL)) {
+        goto fail;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        row_sign[i] = gsl_vector_get(problem_ptr->b, i) < 0.0 ? -1.0 : 1.0;
+    }
+    uint32_t model_m = problem_ptr->m;
+    if (!problem_prepare(problem_ptr)) {
+        if (problem_ptr->is_infeasible && solution_init(solution_ptr, n, model_m + n, 0) &&
+            solution_set_infeasible(solution_ptr, 1)) {
+            goto cleanup;
+        }
+        goto fail;
+    }
+
+    // The columns of the initial master are never purged
+    uint32_t first = problem_ptr->m;
+    age = (uint32_t*)calloc(first, sizeof(uint32_t));
+    if (!age) {
+        goto fail;
+    }
+
+    solve_fn solver = problem_ptr->is_dual_start ? simplex_dual : simplex_primal;
+    uint32_t iter_n = 0;
+    uint32_t generated_n = 0;
+    for (uint32_t round = 1;; round++) {
+        // A master that outgrew the workspace gets a larger one and a new factorization
+        if (problem_ptr->m > workspace.max_m) {
+            simplex_workspace_free(&workspace);
+            if (!simplex_workspace_init(&workspace, n, 2 * problem_ptr->m, &problem_ptr->options)) {
+                goto fail;
+            }
+        }
+
+        gsl_vector_view c = gsl_vector_subvector(problem_ptr->c, 0, problem_ptr->m);
+        gsl_vector_view b = gsl_vector_subvector(problem_ptr->b, 0, n);
+        uint32_t round_iter_n = 0;
+        solution_free(&current);
+        memset(&current, 0, sizeof(solution_t));
+        if (!solver(n, problem_ptr->m, is_max, &c.vector, &problem_ptr->A, &b.vector, &problem_ptr->var_arr,
+                    problem_ptr->B, problem_ptr->N, problem_ptr->state, &problem_ptr->options, &workspace,
+                    &current, &round_iter_n)) {
+            goto fail;
+        }
+        iter_n += round_iter_n;
+        if (current.is_unbounded) {
+            break;
+        }
+
+        // Duals of the last basis, in the sense of the problem and on the rows as given
+        compute_duals(n, is_max, problem_ptr->B, &c.vector, &workspace.factor, y);
+        for (uint32_t i = 0; i < n; i++) {
+            gsl_vector_set(y, i, (is_max ? 1.0 : -1.0) * row_sign[i] * gsl_vector_get(y, i));
+        }
+
+        csc_truncate(&columns.A, n, 0);
+        if (!oracle(ctx, y, &columns)) {
+            fprintf(stderr, "The pricing oracle failed\n");
+            goto fail;
+        }
+
+        // Only the columns that do improve the master are added, so an oracle cannot make it cycle
+        uint32_t improving_n = 0;
+        for (uint32_t k = 0; k < columns.A.cols; k++) {
+            double d = columns.c[k] - csc_column_dot(&columns.A, k, y);
+            keep[k] = is_max ? d > COLGEN_TOL : d < -COLGEN_TOL;
+            improving_n += keep[k];
+        }
+        if (improving_n == 0) {
+            break;
+        }
+
+        // Purging does not change the duals, so it waits for the columns that replace the purged ones
+        int32_t purged_n = colgen_purge(problem_ptr, first, age);
+        if (purged_n < 0 || !colgen_append(problem_ptr, &columns, keep, row_sign, &age)) {
+            goto fail;
+        }
+        printf("Round %u: adding %u columns and purging %d after %u iterations\n", round, improving_n, purged_n,
+               round_iter_n);
+        generated_n += improving_n;
+
+        solver = simplex_primal;
+        workspace.keep_factor = 1;
+    }
+    printf("\n%u columns generated, %u of them left in the master\n", generated_n, problem_ptr->m - first);
+
+    // Report the columns of the model followed by the generated ones, without the fixed artificial columns
+    uint32_t kept_n = problem_ptr->m - first;
+    if (!solution_init(solution_ptr, n, model_m + kept_n + n, current.is_unbounded)) {
+        goto fail;
+    }
+    for (uint32_t j = 0; j < model_m + kept_n && !current.is_unbounded; j++) {
+        uint32_t k = j < model_m ? j : first + j - model_m;
+        gsl_vector_set(solution_ptr->x, j, gsl_vector_get(current.x, k));
+    }
+    solution_set_z(solution_ptr, current.z);
+    solution_set_pI_iter(solution_ptr, problem_ptr->pI_iter);
+    solution_set_pII_iter(solution_ptr, iter_n);
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    free(age);
+    free(keep);
+    free(row_sign);
+    gsl_vector_free(y);
+    solution_free(&current);
+    colgen_columns_free(&columns);
+    simplex_workspace_free(&workspace);
+    return ret;
+}
+
+/* POOL */
+uint32_t colgen_pool_read(colgen_pool_t* pool_ptr, FILE* stream, uint32_t n, uint32_t is_max) {
+    if (!pool_ptr || !stream) {
+        fprintf(stderr, "Some arguments are NULL in colgen_pool_read\n");
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t col_n = 0;
+    uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+    double* values = (double*)malloc(sizeof(double) * (n + 1));
+    if (!rows || !values || fscanf(stream, "%u", &col_n) != 1) {
+        fprintf(stderr, "Failed to read the number of candidate columns\n");
+        goto fail;
+    }
+
+    pool_ptr->is_max = is_max;
+    pool_ptr->c = (double*)malloc(sizeof(double) * (col_n + 1));
+    if (!pool_ptr->c || !csc_init(&pool_ptr->A, n, col_n, col_n + n)) {
+        fprintf(stderr, "Failed to allocate the candidate columns\n");
+        goto fail;
+    }
+
+    for (uint32_t j = 0; j < col_n; j++) {
+        uint32_t length = 0;
+        if (fscanf(stream, "%lf %u", &pool_ptr->c[j], &length) != 2 || length > n) {
+            fprintf(stderr, "Malformed candidate column %u\n", j + 1);
+            goto fail;
+        }
+
+        // Rows are numbered from 1, in increasing order
+        for (uint32_t k = 0; k < length; k++) {
+            uint32_t i = 0;
+            if (fscanf(stream, "%u %lf", &i, &values[k]) != 2 || i == 0 || i > n || (k > 0 && i - 1 <= rows[k - 1])) {
+                fprintf(stderr, "Invalid entry %u of candidate column %u\n", k + 1, j + 1);
+                goto fail;
+            }
+            rows[k] = i - 1;
+        }
+
+        if (!csc_push_column(&pool_ptr->A, rows, values, length)) {
+            fprintf(stderr, "Failed to store candidate column %u\n", j + 1);
+            goto fail;
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+    colgen_pool_free(pool_ptr);
+cleanup:
+    free(rows);
+    free(values);
+    return ret;
+}
+
+uint32_t colgen_pool_oracle(void* ctx, const gsl_vector* y, colgen_columns_t* columns_ptr) {
+    const colgen_pool_t* pool_ptr = (const colgen_pool_t*)ctx;
+    const csc_matrix_t* A = &pool_ptr->A;
+    double gain[COLGEN_ROUND_COLUMNS];
+    uint32_t best[COLGEN_ROUND_COLUMNS];
+    uint32_t found = 0;
+
+    for (uint32_t j = 0; j < A->cols; j++) {
+        double d = pool_ptr->c[j] - csc_column_dot(A, j, y);
+        double g = pool_ptr->is_max ? d : -d;
+        if (g <= COLGEN_TOL || (found == COLGEN_ROUND_COLUMNS && g <= gain[found - 1])) {
+            continue;
+        }
+
+        // Insert the column in the list sorted by decreasing gain, dropping the last one when full
+        uint32_t k = found < COLGEN_ROUND_COLUMNS ? found++ : found - 1;
+        while (k > 0 && gain[k - 1] < g) {
+            gain[k] = gain[k - 1];
+            best[k] = best[k - 1];
+            k--;
+        }
+        gain[k] = g;
+        best[k] = j;
+    }
+
+    for (uint32_t k = 0; k < found; k++) {
+        uint32_t j = best[k];
+        uint32_t start = A->col_ptr[j];
+        if (!colgen_columns_push(columns_ptr, pool_ptr->c[j], VARIABLE_INF, A->row_idx + start, A->values + start,
+                                 A->col_ptr[j + 1] - start)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void colgen_pool_free(colgen_pool_t* pool_ptr) {
+    if (!pool_ptr) {
+        return;
+    }
+
+    csc_free(&pool_ptr->A);
+    free(pool_ptr->c);
+    pool_ptr->c = NULL;
+}
+
+uint32_t problem_solve_column_pool(problem_t* problem_ptr, FILE* stream, solution_t* solution_ptr) {
+    if (!problem_ptr || !stream || !solution_ptr) {
+        fprintf(stderr, "Some arguments are NULL in problem_solve_column_pool\n");
+        return 0;
+    }
+
+    colgen_pool_t pool = {0};
+    if (!colgen_pool_read(&pool, stream, problem_ptr->n, problem_ptr->is_max)) {
+        return 0;
+    }
+
+    uint32_t ret = problem_solve_colgen(problem_ptr, colgen_pool_oracle, &pool, solution_ptr);
+    colgen_pool_free(&pool);
+    return ret;
+}
@@ -0,0 +1,573 @@
+#include "ipm.h"
+#include "simplex/utils.h"
+#include "simplex/warm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gsl/gsl_matrix.h>
+
+// Iterate of the interior point method on min c^T * x, A * x = b, 0 <= x <= u, with the variables
+// shifted by their lower bounds. Fixed variables stay at 0 and are left out of the system
+typedef struct ipm {
+    uint32_t n;
+    uint32_t m;
+    const csc_matrix_t* A;
+    uint32_t* has_u;      // Boolean value for the variables with a finite upper bound (size m)
+    uint32_t* is_fixed;   // Boolean value for the variables with lb == ub (size m)
+    gsl_vector* c;        // Costs of the minimization (size m)
+    gsl_vector* b;        // b - A * lb (size n)
+    gsl_vector* u;        // ub - lb (size m)
+    gsl_vector* x;        // Primal variables (size m)
+    gsl_vector* w;        // Slacks of the upper bounds, u - x (size m)
+    gsl_vector* y;        // Multipliers of the rows (size n)
+    gsl_vector* z;        // Dual slacks of the lower bounds (size m)
+    gsl_vector* s;        // Dual slacks of the upper bounds (size m)
+    gsl_vector* rb;       // Primal residual b - A * x (size n)
+    gsl_vector* ru;       // Upper bound residual u - x - w (size m)
+    gsl_vector* rc;       // Dual residual c - A^T * y - z + s (size m)
+    gsl_vector* rxz;      // Complementarity targets of x * z (size m)
+    gsl_vector* rws;      // Complementarity targets of w * s (size m)
+    gsl_vector* theta;    // Diagonal D = (z / x + s / w)^-1 (size m)
+    gsl_vector* rhat;     // Reduced dual residual (size m)
+    gsl_vector* dx;       // Direction (sizes as the iterate)
+    gsl_vector* dw;
+    gsl_vector* dy;
+    gsl_vector* dz;
+    gsl_vector* ds;
+    gsl_matrix* M;        // Normal equations A * D * A^T, then their Cholesky factor
+    uint32_t* skipped;    // Boolean value for the rows of M dropped as dependent (size n)
+} ipm_t;
+
+/* NORMAL EQUATIONS */
+
+// Lower triangle of A * D * A^T
+void ipm_normal_matrix(ipm_t* ipm_ptr) {
+    const csc_matrix_t* A = ipm_ptr->A;
+    gsl_matrix* M = ipm_ptr->M;
+    gsl_matrix_set_zero(M);
+
+    for (uint32_t j = 0; j < ipm_ptr->m; j++) {
+        double t = gsl_vector_get(ipm_ptr->theta, j);
+        if (t == 0.0) {
+            continue;
+        }
+
+        for (uint32_t k1 = A->col_ptr[j]; k1 < A->col_ptr[j + 1]; k1++) {
+            uint32_t r1 = A->row_idx[k1];
+            double ta = t * A->values[k1];
+            for (uint32_t k2 = A->col_ptr[j]; k2 < A->col_ptr[j + 1]; k2++) {
+                uint32_t r2 = A->row_idx[k2];
+                if (r2 <= r1) {
+                    *gsl_matrix_ptr(M, r1, r2) += ta * A->values[k2];
+                }
+            }
+        }
+    }
+}
+
+// Cholesky factorization M = L * L^T in the lower triangle of M. A row whose pivot vanishes
+// depends on the previous ones: it is skipped and its multiplier does not move
+void ipm_cholesky(gsl_matrix* M, uint32_t* skipped) {
+    uint32_t n = M->size1;
+    for (uint32_t k = 0; k < n; k++) {
+        double diag = gsl_matrix_get(M, k, k);
+        double d = diag;
+        for (uint32_t p = 0; p < k; p++) {
+            double lkp = gsl_matrix_get(M, k, p);
+            d -= lkp * lkp;
+        }
+
+        skipped[k] = !(d > IPM_PIVOT_TOL * diag);
+        if (skipped[k]) {
+            for (uint32_t i = k + 1; i < n; i++) {
+                gsl_matrix_set(M, i, k, 0.0);
+            }
+            continue;
+        }
+
+        double lkk = sqrt(d);
+        gsl_matrix_set(M, k, k, lkk);
+        for (uint32_t i = k + 1; i < n; i++) {
+            double v = gsl_matrix_get(M, i, k);
+            for (uint32_t p = 0; p < k; p++) {
+                v -= gsl_matrix_get(M, i, p) * gsl_matrix_get(M, k, p);
+            }
+            gsl_matrix_set(M, i, k, v / lkk);
+        }
+    }
+}
+
+// Solves L * L^T * v = v in place
+void ipm_cholesky_solve(const gsl_matrix* L, const uint32_t* skipped, gsl_vector* v) {
+    uint32_t n = L->size1;
+    for (uint32_t k = 0; k < n; k++) {
+        if (skipped[k]) {
+            gsl_vector_set(v, k, 0.0);
+            continue;
+        }
+
+        double vk = gsl_vector_get(v, k);
+        for (uint32_t p = 0; p < k; p++) {
+            vk -= gsl_matrix_get(L, k, p) * gsl_vector_get(v, p);
+        }
+        gsl_vector_set(v, k, vk / gsl_matrix_get(L, k, k));
+    }
+
+    for (uint32_t k = n; k-- > 0;) {
+        if (skipped[k]) {
+            continue;
+        }
+
+        double vk = gsl_vector_get(v, k);
+        for (uint32_t i = k + 1; i < n; i++) {
+            vk -= gsl_matrix_get(L, i, k) * gsl_vector_get(v, i);
+        }
+        gsl_vector_set(v, k, vk / gsl_matrix_get(L, k, k));
+    }
+}
+
+/* INTERIOR POINT */
+
+uint32_t ipm_alloc(ipm_t* ipm_ptr, uint32_t n, uint32_t m) {
+    ipm_ptr->n = n;
+    ipm_ptr->m = m;
+    ipm_ptr->has_u = (uint32_t*)calloc(m, sizeof(uint32_t));
+    ipm_ptr->is_fixed = (uint32_t*)calloc(m, sizeof(uint32_t));
+    ipm_ptr->skipped = (uint32_t*)calloc(n, sizeof(uint32_t));
+    ipm_ptr->M = gsl_matrix_alloc(n, n);
+
+    gsl_vector** vectors_n[] = {&ipm_ptr->b, &ipm_ptr->y, &ipm_ptr->rb, &ipm_ptr->dy};
+    gsl_vector** vectors_m[] = {&ipm_ptr->c,   &ipm_ptr->u,     &ipm_ptr->x,    &ipm_ptr->w,   &ipm_ptr->z,
+                                &ipm_ptr->s,   &ipm_ptr->ru,    &ipm_ptr->rc,   &ipm_ptr->rxz, &ipm_ptr->rws,
+                                &ipm_ptr->theta, &ipm_ptr->rhat, &ipm_ptr->dx,  &ipm_ptr->dw,  &ipm_ptr->dz,
+                                &ipm_ptr->ds};
+    uint32_t ok = ipm_ptr->has_u && ipm_ptr->is_fixed && ipm_ptr->skipped && ipm_ptr->M;
+    for (uint32_t k = 0; k < sizeof(vectors_n) / sizeof(vectors_n[0]); k++) {
+        *vectors_n[k] = gsl_vector_calloc(n);
+        ok = ok && *vectors_n[k];
+    }
+    for (uint32_t k = 0; k < sizeof(vectors_m) / sizeof(vectors_m[0]); k++) {
+        *vectors_m[k] = gsl_vector_calloc(m);
+        ok = ok && *vectors_m[k];
+    }
+
+    return ok;
+}
+
+void ipm_free(ipm_t* ipm_ptr) {
+    gsl_vector* vectors[] = {ipm_ptr->b,   ipm_ptr->y,    ipm_ptr->rb,  ipm_ptr->dy,  ipm_ptr->c,
+                             ipm_ptr->u,   ipm_ptr->x,    ipm_ptr->w,   ipm_ptr->z,   ipm_ptr->s,
+                             ipm_ptr->ru,  ipm_ptr->rc,   ipm_ptr->rxz, ipm_ptr->rws, ipm_ptr->theta,
+                             ipm_ptr->rhat, ipm_ptr->dx,  ipm_ptr->dw,  ipm_ptr->dz,  ipm_ptr->ds};
+    for (uint32_t k = 0; k < sizeof(vectors) / sizeof(vectors[0]); k++) {
+        gsl_vector_free(vectors[k]);
+    }
+    gsl_matrix_free(ipm_ptr->M);
+    free(ipm_ptr->has_u);
+    free(ipm_ptr->is_fixed);
+    free(ipm_ptr->skipped);
+}
+
+// Direction of the Newton step for the complementarity targets rxz and rws, with M already factorized:
+// M * dy = rb + A * D * rhat, dx = D * (A^T * dy - rhat), then dz, dw and ds follow from dx
+void ipm_direction(ipm_t* ipm_ptr) {
+    const csc_matrix_t* A = ipm_ptr->A;
+    double* x = ipm_ptr->x->data;
+    double* w = ipm_ptr->w->data;
+    double* z = ipm_ptr->z->data;
+    double* s = ipm_ptr->s->data;
+    double* theta = ipm_ptr->theta->data;
+    double* rhat = ipm_ptr->rhat->data;
+    double* dx = ipm_ptr->dx->data;
+
+    gsl_vector_memcpy(ipm_ptr->dy, ipm_ptr->rb);
+    for (uint32_t j = 0; j < ipm_ptr->m; j++) {
+        if (ipm_ptr->is_fixed[j]) {
+            rhat[j] = 0.0;
+            continue;
+        }
+
+        rhat[j] = ipm_ptr->rc->data[j] - ipm_ptr->rxz->data[j] / x[j];
+        if (ipm_ptr->has_u[j]) {
+            rhat[j] += (ipm_ptr->rws->data[j] - s[j] * ipm_ptr->ru->data[j]) / w[j];
+        }
+        csc_column_axpy(A, j, theta[j] * rhat[j], ipm_ptr->dy);
+    }
+    ipm_cholesky_solve(ipm_ptr->M, ipm_ptr->skipped, ipm_ptr->dy);
+
+    for (uint32_t j = 0; j < ipm_ptr->m; j++) {
+        if (ipm_ptr->is_fixed[j]) {
+            dx[j] = ipm_ptr->dz->data[j] = ipm_ptr->dw->data[j] = ipm_ptr->ds->data[j] = 0.0;
+            continue;
+        }
+
+        dx[j] = theta[j] * (csc_column_dot(A, j, ipm_ptr->dy) - rhat[j]);
+        ipm_ptr->dz->data[j] = (ipm_ptr->rxz->data[j] - z[j] * dx[j]) / x[j];
+        if (ipm_ptr->has_u[j]) {
+            ipm_ptr->dw->data[j] = ipm_ptr->ru->data[j] - dx[j];
+            ipm_ptr->ds->data[j] = (ipm_ptr->rws->data[j] - s[j] * ipm_ptr->dw->data[j]) / w[j];
+        } else {
+            ipm_ptr->dw->data[j] = ipm_ptr->ds->data[j] = 0.0;
+        }
+    }
+}
+
+// Longest step in [0, 1] that keeps v + step * dv nonnegative on the variables of the lower bounds
+// (upper set to 0) or of the upper ones (upper set to 1)
+double ipm_max_step(const ipm_t* ipm_ptr, const gsl_vector* v, const gsl_vector* dv, uint32_t upper) {
+    double step = 1.0;
+    for (uint32_t j = 0; j < ipm_ptr->m; j++) {
+        if (ipm_ptr->is_fixed[j] || (upper && !ipm_ptr->has_u[j])) {
+            continue;
+        }
+
+        double dvj = gsl_vector_get(dv, j);
+        if (dvj < 0.0) {
+            step = fmin(step, -gsl_vector_get(v, j) / dvj);
+        }
+    }
+
+    return step;
+}
+
+// Average complementarity (x + step_p * dx) * (z + step_d * dz) + (w + step_p * dw) * (s + step_d * ds)
+double ipm_mu(const ipm_t* ipm_ptr, double step_p, double step_d, uint32_t pairs) {
+    double sum = 0.0;
+    for (uint32_t j = 0; j < ipm_ptr->m; j++) {
+        if (ipm_ptr->is_fixed[j]) {
+            continue;
+        }
+
+        sum += (ipm_ptr->x->data[j] + step_p * ipm_ptr->dx->data[j]) *
+               (ipm_ptr->z->data[j] + step_d * ipm_ptr->dz->data[j]);
+        if (ipm_ptr->has_u[j]) {
+            sum += (ipm_ptr->w->data[j] + step_p * ipm_ptr->dw->data[j]) *
+                   (ipm_ptr->s->data[j] + step_d * ipm_ptr->ds->data[j]);
+        }
+    }
+
+    return pairs > 0 ? sum / pairs : 0.0;
+}
+
+double ipm_norm_inf(const gsl_vector* v) {
+    double norm = 0.0;
+    for (uint32_t i = 0; i < v->size; i++) {
+        norm = fmax(norm, fabs(gsl_vector_get(v, i)));
+    }
+    return norm;
+}
+
+// Mehrotra's starting point: the least squares solutions of A * x = b and A^T * y + z = c,
+// shifted to be positive and then balanced so that no complementarity product is too small
+void ipm_start(ipm_t* ipm_ptr) {
+    const csc_matrix_t* A = ipm_ptr->A;
+    uint32_t m = ipm_ptr->m;
+    double* x = ipm_ptr->x->data;
+    double* z = ipm_ptr->z->data;
+
+    for (uint32_t j = 0; j < m; j++) {
+        gsl_vector_set(ipm_ptr->theta, j, ipm_ptr->is_fixed[j] ? 0.0 : 1.0);
+    }
+    ipm_normal_matrix(ipm_ptr);
+    ipm_cholesky(ipm_ptr->M, ipm_ptr->skipped);
+
+    // x = A^T * (A * A^T)^-1 * b, y = (A * A^T)^-1 * A * c, z = c - A^T * y
+    gsl_vector_memcpy(ipm_ptr->dy, ipm_ptr->b);
+    ipm_cholesky_solve(ipm_ptr->M, ipm_ptr->skipped, ipm_ptr->dy);
+    gsl_vector_set_zero(ipm_ptr->y);
+    for (uint32_t j = 0; j < m; j++) {
+        if (!ipm_ptr->is_fixed[j]) {
+            x[j] = csc_column_dot(A, j, ipm_ptr->dy);
+            csc_column_axpy(A, j, gsl_vector_get(ipm_ptr->c, j), ipm_ptr->y);
+        }
+    }
+    ipm_cholesky_solve(ipm_ptr->M, ipm_ptr->skipped, ipm_ptr->y);
+
+    double x_min = INFINITY;
+    double z_min = INFINITY;
+    for (uint32_t j = 0; j < m; j++) {
+        if (!ipm_ptr->is_fixed[j]) {
+            z[j] = gsl_vector_get(ipm_ptr->c, j) - csc_column_dot(A, j, ipm_ptr->y);
+            x_min = fmin(x_min, x[j]);
+            z_min = fmin(z_min, z[j]);
+        }
+    }
+
+    double dx = fmax(-1.5 * x_min, 0.0);
+    double dz = fmax(-1.5 * z_min, 0.0);
+    double xz = 0.0;
+    double x_sum = 0.0;
+    double z_sum = 0.0;
+    for (uint32_t j = 0; j < m; j++) {
+        if (!ipm_ptr->is_fixed[j]) {
+            xz += (x[j] + dx) * (z[j] + dz);
+            x_sum += x[j] + dx;
+            z_sum += z[j] + dz;
+        }
+    }
+    dx += z_sum > 0.0 ? 0.5 * xz / z_sum : 1.0;
+    dz += x_sum > 0.0 ? 0.5 * xz / x_sum : 1.0;
+    if (!(dx > 0.0)) {
+        dx = 1.0;
+    }
+    if (!(dz > 0.0)) {
+        dz = 1.0;
+    }
+
+    // The upper bound slacks only need to be positive, ru = u - x - w is driven to 0 by the iterations
+    for (uint32_t j = 0; j < m; j++) {
+        if (ipm_ptr->is_fixed[j]) {
+            x[j] = z[j] = 0.0;
+            continue;
+        }
+
+        x[j] += dx;
+        z[j] += dz;
+        if (ipm_ptr->has_u[j]) {
+            gsl_vector_set(ipm_ptr->w, j, fmax(gsl_vector_get(ipm_ptr->u, j) - x[j], dx));
+            gsl_vector_set(ipm_ptr->s, j, dz);
+        }
+    }
+}
+
+uint32_t ipm_solve(const problem_t* problem_ptr, gsl_vector* x, gsl_vector* zl, gsl_vector* zu,
+                   uint32_t* iter_n_ptr) {
+    if (!problem_ptr || !x || !zl || !zu || !iter_n_ptr) {
+        fprintf(stderr, "Some arguments are NULL in ipm_solve\n");
+        return 0;
+    }
+
+    uint32_t ret = 0;
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    const var_arr_t* var_arr_ptr = &problem_ptr->var_arr;
+
+    ipm_t ipm = {0};
+    ipm.A = &problem_ptr->A;
+    if (!ipm_alloc(&ipm, n, m)) {
+        fprintf(stderr, "Failed to allocate the interior point buffers\n");
+        goto cleanup;
+    }
+
+    // Shift x by lb and turn the problem into a minimization
+    uint32_t pairs = 0;
+    gsl_vector_memcpy(ipm.b, problem_ptr->b);
+    for (uint32_t j = 0; j < m; j++) {
+        double lb = var_lb(var_arr_ptr, j);
+        double ub = var_ub(var_arr_ptr, j);
+        double cj = gsl_vector_get(problem_ptr->c, j);
+        gsl_vector_set(ipm.c, j, problem_ptr->is_max ? -cj : cj);
+        if (lb != 0.0) {
+            csc_column_axpy(ipm.A, j, -lb, ipm.b);
+        }
+
+        ipm.is_fixed[j] = lb == ub;
+        ipm.has_u[j] = !ipm.is_fixed[j] && ub < VARIABLE_INF;
+        pairs += !ipm.is_fixed[j] + ipm.has_u[j];
+        if (ipm.is_fixed[j]) {
+            continue;
+        }
+
+        gsl_vector_set(ipm.u, j, ipm.has_u[j] ? ub - lb : 0.0);
+    }
+    ipm_start(&ipm);
+
+    double b_norm = 1.0 + ipm_norm_inf(ipm.b) + ipm_norm_inf(ipm.u);
+    double c_norm = 1.0 + ipm_norm_inf(ipm.c);
+
+    uint32_t iter_n = 0;
+    for (; iter_n <= IPM_MAX_ITER; iter_n++) {
+        // Residuals rb = b - A * x, ru = u - x - w, rc = c - A^T * y - z + s
+        gsl_vector_memcpy(ipm.rb, ipm.b);
+        double p_obj = 0.0;
+        double d_obj = 0.0;
+        for (uint32_t i = 0; i < n; i++) {
+            d_obj += gsl_vector_get(ipm.b, i) * gsl_vector_get(ipm.y, i);
+        }
+        for (uint32_t j = 0; j < m; j++) {
+            if (ipm.is_fixed[j]) {
+                continue;
+            }
+
+            double xj = gsl_vector_get(ipm.x, j);
+            double cj = gsl_vector_get(ipm.c, j);
+            csc_column_axpy(ipm.A, j, -xj, ipm.rb);
+            p_obj += cj * xj;
+
+            double rc = cj - csc_column_dot(ipm.A, j, ipm.y) - gsl_vector_get(ipm.z, j);
+            double ru = 0.0;
+            if (ipm.has_u[j]) {
+                rc += gsl_vector_get(ipm.s, j);
+                ru = gsl_vector_get(ipm.u, j) - xj - gsl_vector_get(ipm.w, j);
+                d_obj -= gsl_vector_get(ipm.u, j) * gsl_vector_get(ipm.s, j);
+            }
+            gsl_vector_set(ipm.rc, j, rc);
+            gsl_vector_set(ipm.ru, j, ru);
+        }
+
+        double mu = ipm_mu(&ipm, 0.0, 0.0, pairs);
+        double p_res = fmax(ipm_norm_inf(ipm.rb), ipm_norm_inf(ipm.ru)) / b_norm;
+        double d_res = ipm_norm_inf(ipm.rc) / c_norm;
+        double gap = fabs(p_obj - d_obj) / (1.0 + fabs(p_obj));
+        if (p_res < IPM_TOL && d_res < IPM_TOL && gap < IPM_TOL) {
+            ret = 1;
+            break;
+        }
+        // Infeasible and unbounded problems make the iterates blow up
+        if (iter_n == IPM_MAX_ITER || !isfinite(mu) || mu > 1e30) {
+            break;
+        }
+
+        for (uint32_t j = 0; j < m; j++) {
+            double t = 0.0;
+            if (!ipm.is_fixed[j]) {
+                double inv = gsl_vector_get(ipm.z, j) / gsl_vector_get(ipm.x, j);
+                if (ipm.has_u[j]) {
+                    inv += gsl_vector_get(ipm.s, j) / gsl_vector_get(ipm.w, j);
+                }
+                t = 1.0 / inv;
+            }
+            gsl_vector_set(ipm.theta, j, t);
+        }
+        ipm_normal_matrix(&ipm);
+        ipm_cholesky(ipm.M, ipm.skipped);
+
+        // Predictor: affine scaling direction towards x * z = 0
+        for (uint32_t j = 0; j < m; j++) {
+            gsl_vector_set(ipm.rxz, j, -gsl_vector_get(ipm.x, j) * gsl_vector_get(ipm.z, j));
+            gsl_vector_set(ipm.rws, j, -gsl_vector_get(ipm.w, j) * gsl_vector_get(ipm.s, j));
+        }
+        ipm_direction(&ipm);
+        double step_p = fmin(ipm_max_step(&ipm, ipm.x, ipm.dx, 0), ipm_max_step(&ipm, ipm.w, ipm.dw, 1));
+        double step_d = fmin(ipm_max_step(&ipm, ipm.z, ipm.dz, 0), ipm_max_step(&ipm, ipm.s, ipm.ds, 1));
+        double mu_aff = ipm_mu(&ipm, step_p, step_d, pairs);
+        double sigma = pow(mu_aff / mu, 3.0);
+
+        // Corrector: centering towards sigma * mu plus the second order term of the predictor
+        for (uint32_t j = 0; j < m; j++) {
+            double rxz = gsl_vector_get(ipm.rxz, j) - gsl_vector_get(ipm.dx, j) * gsl_vector_get(ipm.dz, j);
+            double rws = gsl_vector_get(ipm.rws, j) - gsl_vector_get(ipm.dw, j) * gsl_vector_get(ipm.ds, j);
+            gsl_vector_set(ipm.rxz, j, rxz + sigma * mu);
+            gsl_vector_set(ipm.rws, j, ipm.has_u[j] ? rws + sigma * mu : 0.0);
+        }
+        ipm_direction(&ipm);
+        step_p = fmin(ipm_max_step(&ipm, ipm.x, ipm.dx, 0), ipm_max_step(&ipm, ipm.w, ipm.dw, 1));
+        step_d = fmin(ipm_max_step(&ipm, ipm.z, ipm.dz, 0), ipm_max_step(&ipm, ipm.s, ipm.ds, 1));
+        step_p = fmin(1.0, IPM_STEP * step_p);
+        step_d = fmin(1.0, IPM_STEP * step_d);
+
+        gsl_vector* primal[] = {ipm.x, ipm.w};
+        gsl_vector* primal_d[] = {ipm.dx, ipm.dw};
+        gsl_vector* dual[] = {ipm.y, ipm.z, ipm.s};
+        gsl_vector* dual_d[] = {ipm.dy, ipm.dz, ipm.ds};
+        for (uint32_t k = 0; k < 2; k++) {
+            for (uint32_t j = 0; j < m; j++) {
+                primal[k]->data[j] += step_p * primal_d[k]->data[j];
+            }
+        }
+        for (uint32_t k = 0; k < 3; k++) {
+            for (uint32_t j = 0; j < dual[k]->size; j++) {
+                dual[k]->data[j] += step_d * dual_d[k]->data[j];
+            }
+        }
+    }
+
+    *iter_n_ptr = iter_n;
+    for (uint32_t j = 0; j < m; j++) {
+        gsl_vector_set(x, j, var_lb(var_arr_ptr, j) + gsl_vector_get(ipm.x, j));
+        gsl_vector_set(zl, j, gsl_vector_get(ipm.z, j));
+        gsl_vector_set(zu, j, gsl_vector_get(ipm.s, j));
+    }
+
+cleanup:
+    ipm_free(&ipm);
+    return ret;
+}
+
+/* CROSSOVER */
+
+// Column of the crossover ordering: the larger the key, the more the column wants to be basic
+typedef struct ipm_rank {
+    double key;
+    uint32_t j;
+} ipm_rank_t;
+
+int ipm_rank_cmp(const void* a, const void* b) {
+    const ipm_rank_t* ra = (const ipm_rank_t*)a;
+    const ipm_rank_t* rb = (const ipm_rank_t*)b;
+    if (ra->key != rb->key) {
+        return ra->key > rb->key ? -1 : 1;
+    }
+    return ra->j < rb->j ? -1 : (ra->j > rb->j);
+}
+
+uint32_t ipm_crossover(const problem_t* problem_ptr, const gsl_vector* x, const gsl_vector* zl, const gsl_vector* zu,
+                       var_state_t* start) {
+    if (!problem_ptr || !x || !zl || !zu || !start) {
+        fprintf(stderr, "Some arguments are NULL in ipm_crossover\n");
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    const var_arr_t* var_arr_ptr = &problem_ptr->var_arr;
+    ipm_rank_t* ranks = (ipm_rank_t*)malloc(sizeof(ipm_rank_t) * m);
+    uint32_t* order = (uint32_t*)malloc(sizeof(uint32_t) * m);
+    int32_t* B = (int32_t*)malloc(sizeof(int32_t) * n);
+    if (!ranks || !order || !B) {
+        fprintf(stderr, "Failed to allocate the crossover buffers\n");
+        goto fail;
+    }
+
+    // A column is nonbasic at its nearest bound when the distance to it is below the dual slack of that bound
+    for (uint32_t j = 0; j < m; j++) {
+        double lb = var_lb(var_arr_ptr, j);
+        double ub = var_ub(var_arr_ptr, j);
+        double xj = gsl_vector_get(x, j);
+        ranks[j].j = j;
+        if (lb == ub) {
+            start[j] = VAR_STATE_FIXED;
+            ranks[j].key = -INFINITY;
+            continue;
+        }
+
+        uint32_t at_upper = ub < VARIABLE_INF && ub - xj < xj - lb;
+        double dist = fmax(at_upper ? ub - xj : xj - lb, 0.0);
+        double slack = gsl_vector_get(at_upper ? zu : zl, j);
+        start[j] = dist > slack ? VAR_STATE_BASIC : (at_upper ? VAR_STATE_UPPER : VAR_STATE_LOWER);
+        ranks[j].key = dist / fmax(slack, 1e-300);
+    }
+
+    qsort(ranks, m, sizeof(ipm_rank_t), ipm_rank_cmp);
+    for (uint32_t k = 0; k < m; k++) {
+        order[k] = ranks[k].j;
+    }
+
+    // Keep the independent interior columns, then fill the basis with the next ones in the ordering
+    basis_repair(n, m, &problem_ptr->A, var_arr_ptr, start, order, 1, B);
+    for (uint32_t j = 0; j < m; j++) {
+        if (start[j] == VAR_STATE_BASIC) {
+            double lb = var_lb(var_arr_ptr, j);
+            double ub = var_ub(var_arr_ptr, j);
+            double xj = gsl_vector_get(x, j);
+            start[j] = ub < VARIABLE_INF && ub - xj < xj - lb ? VAR_STATE_UPPER : VAR_STATE_LOWER;
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (B[i] >= 0) {
+            start[B[i]] = VAR_STATE_BASIC;
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    free(ranks);
+    free(order);
+    free(B);
+    return ret;
+}
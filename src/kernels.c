@@ -0,0 +1,600 @@
+#include "kernels.h"
+#include "variable.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// A fused multiply-add rounds once instead of twice, which would break the equality between levels
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// Smallest |d| accepted as a pivot by the primal ratio test
+#define PRIMAL_PIVOT_TOL 1e-9
+// Smallest |alpha_pj| accepted as a pivot by the dual ratio test
+#define DUAL_PIVOT_TOL 1e-9
+
+const char* kernels_level_to_str(kernels_level_t level) {
+    switch (level) {
+        case KERNELS_AUTO: {
+            return "auto";
+        }
+        case KERNELS_SCALAR: {
+            return "scalar";
+        }
+        case KERNELS_AVX2: {
+            return "avx2";
+        }
+        case KERNELS_AVX512: {
+            return "avx512";
+        }
+        case KERNELS_ERR: {
+            return "error";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+kernels_level_t kernels_level_from_str(const char* str) {
+    for (kernels_level_t level = KERNELS_AUTO; level < KERNELS_ERR; level++) {
+        if (strcmp(str, kernels_level_to_str(level)) == 0) {
+            return level;
+        }
+    }
+
+    return KERNELS_ERR;
+}
+
+/* SCALAR */
+
+double scalar_gather_dot(const double* values, const uint32_t* idx, uint32_t len, const double* x) {
+    // Four partial sums, combined like the lanes of a 256 bit register
+    double s[4] = {0.0, 0.0, 0.0, 0.0};
+    uint32_t k = 0;
+    for (; k + 4 <= len; k += 4) {
+        for (uint32_t l = 0; l < 4; l++) {
+            s[l] += values[k + l] * x[idx[k + l]];
+        }
+    }
+
+    double res = (s[0] + s[2]) + (s[1] + s[3]);
+    for (; k < len; k++) {
+        res += values[k] * x[idx[k]];
+    }
+
+    return res;
+}
+
+// Primal ratio test from index start on, p and *min_ratio_ptr being the best entry found so far
+int32_t ratio_test_tail(uint32_t start, uint32_t n, const double* x, const double* d, double sign, const double* lb,
+                        const double* ub, int32_t p, double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    for (uint32_t i = start; i < n; i++) {
+        double di = sign * d[i];
+
+        double ratio;
+        uint32_t to_upper;
+        if (di > PRIMAL_PIVOT_TOL) {
+            // Decreasing towards the lower bound
+            ratio = (x[i] - lb[i]) / di;
+            to_upper = 0;
+        } else if (di < -PRIMAL_PIVOT_TOL && ub[i] < VARIABLE_INF) {
+            // Increasing towards the upper bound
+            ratio = (ub[i] - x[i]) / -di;
+            to_upper = 1;
+        } else {
+            continue;
+        }
+        ratio = ratio > 0.0 ? ratio : 0.0;
+
+        if (ratio < *min_ratio_ptr) {
+            *min_ratio_ptr = ratio;
+            *to_upper_ptr = to_upper;
+            p = (int32_t)i;
+        }
+    }
+
+    return p;
+}
+
+int32_t scalar_ratio_test(uint32_t n, const double* x, const double* d, double sign, const double* lb,
+                          const double* ub, double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    return ratio_test_tail(0, n, x, d, sign, lb, ub, -1, min_ratio_ptr, to_upper_ptr);
+}
+
+// Dual ratio test from index start on, q and *min_ratio_ptr being the best entry found so far
+int32_t dual_ratio_test_tail(uint32_t start, uint32_t len, const double* r, const double* alpha, const double* dir,
+                             double sign, int32_t q, double* min_ratio_ptr) {
+    for (uint32_t i = start; i < len; i++) {
+        // Only the moves that push the leaving variable back towards its bound are eligible
+        double alpha_pj = sign * alpha[i];
+        if (dir[i] * alpha_pj < -DUAL_PIVOT_TOL) {
+            double ratio = fabs(r[i] / alpha_pj);
+            if (ratio < *min_ratio_ptr) {
+                *min_ratio_ptr = ratio;
+                q = (int32_t)i;
+            }
+        }
+    }
+
+    return q;
+}
+
+int32_t scalar_dual_ratio_test(uint32_t len, const double* r, const double* alpha, const double* dir, double sign,
+                               double* min_ratio_ptr) {
+    return dual_ratio_test_tail(0, len, r, alpha, dir, sign, -1, min_ratio_ptr);
+}
+
+int32_t first_fractional_tail(uint32_t start, const double* x, uint32_t len, double tol) {
+    for (uint32_t i = start; i < len; i++) {
+        if (!(fabs(x[i] - round(x[i])) < tol)) {
+            return (int32_t)i;
+        }
+    }
+
+    return -1;
+}
+
+int32_t scalar_first_fractional(const double* x, uint32_t len, double tol) {
+    return first_fractional_tail(0, x, len, tol);
+}
+
+// Picks the best lane of a vector argmin: smallest ratio, then smallest index
+int32_t reduce_argmin_lanes(uint32_t lanes, const double* ratio, const double* idx, uint32_t upper_mask,
+                            double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    int32_t p = -1;
+    for (uint32_t l = 0; l < lanes; l++) {
+        if (idx[l] < 0.0) {
+            continue;
+        }
+
+        int32_t i = (int32_t)idx[l];
+        if (ratio[l] < *min_ratio_ptr || (ratio[l] == *min_ratio_ptr && i < p)) {
+            *min_ratio_ptr = ratio[l];
+            p = i;
+            if (to_upper_ptr) {
+                *to_upper_ptr = (upper_mask >> l) & 1;
+            }
+        }
+    }
+
+    return p;
+}
+
+#ifdef KERNELS_X86
+
+/* AVX2 */
+
+__attribute__((target("avx2"))) double avx2_gather_dot(const double* values, const uint32_t* idx, uint32_t len,
+                                                         const double* x) {
+    __m256d acc = _mm256_setzero_pd();
+    uint32_t k = 0;
+    for (; k + 4 <= len; k += 4) {
+        __m128i vidx = _mm_loadu_si128((const __m128i*)(idx + k));
+        __m256d xv = _mm256_i32gather_pd(x, vidx, 8);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(values + k), xv));
+    }
+
+    // (s0 + s2) + (s1 + s3), as in scalar_gather_dot
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double res = _mm_cvtsd_f64(half) + _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+    for (; k < len; k++) {
+        res += values[k] * x[idx[k]];
+    }
+
+    return res;
+}
+
+__attribute__((target("avx2"))) int32_t avx2_ratio_test(uint32_t n, const double* x, const double* d, double sign,
+                                                          const double* lb, const double* ub, double* min_ratio_ptr,
+                                                          uint32_t* to_upper_ptr) {
+    const __m256d vsign = _mm256_set1_pd(sign);
+    const __m256d tol = _mm256_set1_pd(PRIMAL_PIVOT_TOL);
+    const __m256d neg_tol = _mm256_set1_pd(-PRIMAL_PIVOT_TOL);
+    const __m256d inf = _mm256_set1_pd(VARIABLE_INF);
+    const __m256d huge = _mm256_set1_pd(HUGE_VAL);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    __m256d min_v = _mm256_set1_pd(*min_ratio_ptr);
+    __m256d idx_v = _mm256_set1_pd(-1.0);
+    __m256d upper_v = zero;
+    __m256d i_v = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d di = _mm256_mul_pd(vsign, _mm256_loadu_pd(d + i));
+        __m256d xi = _mm256_loadu_pd(x + i);
+        __m256d ubi = _mm256_loadu_pd(ub + i);
+
+        __m256d to_lower = _mm256_cmp_pd(di, tol, _CMP_GT_OQ);
+        __m256d to_upper = _mm256_and_pd(_mm256_cmp_pd(di, neg_tol, _CMP_LT_OQ), _mm256_cmp_pd(ubi, inf, _CMP_LT_OQ));
+
+        __m256d num = _mm256_blendv_pd(_mm256_sub_pd(ubi, xi), _mm256_sub_pd(xi, _mm256_loadu_pd(lb + i)), to_lower);
+        __m256d den = _mm256_blendv_pd(_mm256_sub_pd(zero, di), di, to_lower);
+        __m256d ratio = _mm256_max_pd(_mm256_div_pd(num, den), zero);
+        ratio = _mm256_blendv_pd(huge, ratio, _mm256_or_pd(to_lower, to_upper));
+
+        __m256d better = _mm256_cmp_pd(ratio, min_v, _CMP_LT_OQ);
+        min_v = _mm256_blendv_pd(min_v, ratio, better);
+        idx_v = _mm256_blendv_pd(idx_v, i_v, better);
+        upper_v = _mm256_blendv_pd(upper_v, to_upper, better);
+        i_v = _mm256_add_pd(i_v, four);
+    }
+
+    double ratio_l[4], idx_l[4];
+    _mm256_storeu_pd(ratio_l, min_v);
+    _mm256_storeu_pd(idx_l, idx_v);
+    uint32_t upper_mask = (uint32_t)_mm256_movemask_pd(upper_v);
+
+    int32_t p = reduce_argmin_lanes(4, ratio_l, idx_l, upper_mask, min_ratio_ptr, to_upper_ptr);
+    return ratio_test_tail(i, n, x, d, sign, lb, ub, p, min_ratio_ptr, to_upper_ptr);
+}
+
+__attribute__((target("avx2"))) int32_t avx2_dual_ratio_test(uint32_t len, const double* r, const double* alpha,
+                                                               const double* dir, double sign,
+                                                               double* min_ratio_ptr) {
+    const __m256d vsign = _mm256_set1_pd(sign);
+    const __m256d neg_tol = _mm256_set1_pd(-DUAL_PIVOT_TOL);
+    const __m256d huge = _mm256_set1_pd(HUGE_VAL);
+    const __m256d sign_bit = _mm256_set1_pd(-0.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    __m256d min_v = _mm256_set1_pd(*min_ratio_ptr);
+    __m256d idx_v = _mm256_set1_pd(-1.0);
+    __m256d i_v = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    uint32_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m256d alpha_pj = _mm256_mul_pd(vsign, _mm256_loadu_pd(alpha + i));
+        __m256d eligible = _mm256_cmp_pd(_mm256_mul_pd(_mm256_loadu_pd(dir + i), alpha_pj), neg_tol, _CMP_LT_OQ);
+
+        __m256d ratio = _mm256_andnot_pd(sign_bit, _mm256_div_pd(_mm256_loadu_pd(r + i), alpha_pj));
+        ratio = _mm256_blendv_pd(huge, ratio, eligible);
+
+        __m256d better = _mm256_cmp_pd(ratio, min_v, _CMP_LT_OQ);
+        min_v = _mm256_blendv_pd(min_v, ratio, better);
+        idx_v = _mm256_blendv_pd(idx_v, i_v, better);
+        i_v = _mm256_add_pd(i_v, four);
+    }
+
+    double ratio_l[4], idx_l[4];
+    _mm256_storeu_pd(ratio_l, min_v);
+    _mm256_storeu_pd(idx_l, idx_v);
+
+    int32_t q = reduce_argmin_lanes(4, ratio_l, idx_l, 0, min_ratio_ptr, NULL);
+    return dual_ratio_test_tail(i, len, r, alpha, dir, sign, q, min_ratio_ptr);
+}
+
+__attribute__((target("avx2"))) int32_t avx2_first_fractional(const double* x, uint32_t len, double tol) {
+    const __m256d vtol = _mm256_set1_pd(tol);
+    const __m256d sign_bit = _mm256_set1_pd(-0.0);
+
+    uint32_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        // Halves round to even here and away from zero in round(), both are 0.5 away
+        __m256d xi = _mm256_loadu_pd(x + i);
+        __m256d xr = _mm256_round_pd(xi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d diff = _mm256_andnot_pd(sign_bit, _mm256_sub_pd(xi, xr));
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(diff, vtol, _CMP_NLT_UQ));
+        if (mask) {
+            return (int32_t)(i + (uint32_t)__builtin_ctz((unsigned)mask));
+        }
+    }
+
+    return first_fractional_tail(i, x, len, tol);
+}
+
+/* AVX512 */
+
+__attribute__((target("avx512f"))) int32_t avx512_ratio_test(uint32_t n, const double* x, const double* d,
+                                                               double sign, const double* lb, const double* ub,
+                                                               double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    const __m512d vsign = _mm512_set1_pd(sign);
+    const __m512d tol = _mm512_set1_pd(PRIMAL_PIVOT_TOL);
+    const __m512d neg_tol = _mm512_set1_pd(-PRIMAL_PIVOT_TOL);
+    const __m512d inf = _mm512_set1_pd(VARIABLE_INF);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d eight = _mm512_set1_pd(8.0);
+
+    __m512d min_v = _mm512_set1_pd(*min_ratio_ptr);
+    __m512d idx_v = _mm512_set1_pd(-1.0);
+    __m512d i_v = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+    __mmask8 upper_mask = 0;
+
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d di = _mm512_mul_pd(vsign, _mm512_loadu_pd(d + i));
+        __m512d xi = _mm512_loadu_pd(x + i);
+        __m512d ubi = _mm512_loadu_pd(ub + i);
+
+        __mmask8 to_lower = _mm512_cmp_pd_mask(di, tol, _CMP_GT_OQ);
+        __mmask8 to_upper = _mm512_cmp_pd_mask(di, neg_tol, _CMP_LT_OQ) & _mm512_cmp_pd_mask(ubi, inf, _CMP_LT_OQ);
+
+        __m512d num = _mm512_mask_blend_pd(to_lower, _mm512_sub_pd(ubi, xi), _mm512_sub_pd(xi, _mm512_loadu_pd(lb + i)));
+        __m512d den = _mm512_mask_blend_pd(to_lower, _mm512_sub_pd(zero, di), di);
+        __m512d ratio = _mm512_max_pd(_mm512_div_pd(num, den), zero);
+
+        __mmask8 better = _mm512_cmp_pd_mask(ratio, min_v, _CMP_LT_OQ) & (to_lower | to_upper);
+        min_v = _mm512_mask_blend_pd(better, min_v, ratio);
+        idx_v = _mm512_mask_blend_pd(better, idx_v, i_v);
+        upper_mask = (upper_mask & ~better) | (to_upper & better);
+        i_v = _mm512_add_pd(i_v, eight);
+    }
+
+    double ratio_l[8], idx_l[8];
+    _mm512_storeu_pd(ratio_l, min_v);
+    _mm512_storeu_pd(idx_l, idx_v);
+
+    int32_t p = reduce_argmin_lanes(8, ratio_l, idx_l, upper_mask, min_ratio_ptr, to_upper_ptr);
+    return ratio_test_tail(i, n, x, d, sign, lb, ub, p, min_ratio_ptr, to_upper_ptr);
+}
+
+__attribute__((target("avx512f"))) int32_t avx512_dual_ratio_test(uint32_t len, const double* r, const double* alpha,
+                                                                    const double* dir, double sign,
+                                                                    double* min_ratio_ptr) {
+    const __m512d vsign = _mm512_set1_pd(sign);
+    const __m512d neg_tol = _mm512_set1_pd(-DUAL_PIVOT_TOL);
+    const __m512d eight = _mm512_set1_pd(8.0);
+
+    __m512d min_v = _mm512_set1_pd(*min_ratio_ptr);
+    __m512d idx_v = _mm512_set1_pd(-1.0);
+    __m512d i_v = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+
+    uint32_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m512d alpha_pj = _mm512_mul_pd(vsign, _mm512_loadu_pd(alpha + i));
+        __mmask8 eligible =
+            _mm512_cmp_pd_mask(_mm512_mul_pd(_mm512_loadu_pd(dir + i), alpha_pj), neg_tol, _CMP_LT_OQ);
+
+        __m512d ratio = _mm512_abs_pd(_mm512_div_pd(_mm512_loadu_pd(r + i), alpha_pj));
+
+        __mmask8 better = _mm512_cmp_pd_mask(ratio, min_v, _CMP_LT_OQ) & eligible;
+        min_v = _mm512_mask_blend_pd(better, min_v, ratio);
+        idx_v = _mm512_mask_blend_pd(better, idx_v, i_v);
+        i_v = _mm512_add_pd(i_v, eight);
+    }
+
+    double ratio_l[8], idx_l[8];
+    _mm512_storeu_pd(ratio_l, min_v);
+    _mm512_storeu_pd(idx_l, idx_v);
+
+    int32_t q = reduce_argmin_lanes(8, ratio_l, idx_l, 0, min_ratio_ptr, NULL);
+    return dual_ratio_test_tail(i, len, r, alpha, dir, sign, q, min_ratio_ptr);
+}
+
+__attribute__((target("avx512f"))) int32_t avx512_first_fractional(const double* x, uint32_t len, double tol) {
+    const __m512d vtol = _mm512_set1_pd(tol);
+
+    uint32_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m512d xi = _mm512_loadu_pd(x + i);
+        __m512d xr = _mm512_roundscale_pd(xi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m512d diff = _mm512_abs_pd(_mm512_sub_pd(xi, xr));
+        __mmask8 mask = _mm512_cmp_pd_mask(diff, vtol, _CMP_NLT_UQ);
+        if (mask) {
+            return (int32_t)(i + (uint32_t)__builtin_ctz((unsigned)mask));
+        }
+    }
+
+    return first_fractional_tail(i, x, len, tol);
+}
+
+#endif
+
+/* DISPATCH */
+
+typedef struct kernels {
+    kernels_level_t level;
+    double (*gather_dot)(const double*, const uint32_t*, uint32_t, const double*);
+    int32_t (*ratio_test)(uint32_t, const double*, const double*, double, const double*, const double*, double*,
+                          uint32_t*);
+    int32_t (*dual_ratio_test)(uint32_t, const double*, const double*, const double*, double, double*);
+    int32_t (*first_fractional)(const double*, uint32_t, double);
+} kernels_t;
+
+static kernels_t active_kernels = {
+    KERNELS_SCALAR, scalar_gather_dot, scalar_ratio_test, scalar_dual_ratio_test, scalar_first_fractional,
+};
+
+uint32_t kernels_select(kernels_level_t level) {
+    kernels_t kernels = {KERNELS_SCALAR, scalar_gather_dot, scalar_ratio_test, scalar_dual_ratio_test,
+                         scalar_first_fractional};
+
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    uint32_t has_avx2 = __builtin_cpu_supports("avx2");
+    uint32_t has_avx512 = has_avx2 && __builtin_cpu_supports("avx512f");
+#else
+    uint32_t has_avx2 = 0;
+    uint32_t has_avx512 = 0;
+#endif
+
+    if (level == KERNELS_AUTO) {
+        level = has_avx512 ? KERNELS_AVX512 : (has_avx2 ? KERNELS_AVX2 : KERNELS_SCALAR);
+    }
+
+    if ((level == KERNELS_AVX2 && !has_avx2) || (level == KERNELS_AVX512 && !has_avx512) || level == KERNELS_ERR) {
+        fprintf(stderr, "The CPU does not support the %s kernels\n", kernels_level_to_str(level));
+        return 0;
+    }
+
+#ifdef KERNELS_X86
+    if (level == KERNELS_AVX2) {
+        kernels = (kernels_t){KERNELS_AVX2, avx2_gather_dot, avx2_ratio_test, avx2_dual_ratio_test,
+                              avx2_first_fractional};
+    } else if (level == KERNELS_AVX512) {
+        // The dot product keeps the 4-lane sums of AVX2 so that its result does not depend on the level
+        kernels = (kernels_t){KERNELS_AVX512, avx2_gather_dot, avx512_ratio_test, avx512_dual_ratio_test,
+                              avx512_first_fractional};
+    }
+#endif
+
+    active_kernels = kernels;
+    return 1;
+}
+
+kernels_level_t kernels_level(void) {
+    return active_kernels.level;
+}
+
+double kernel_gather_dot(const double* values, const uint32_t* idx, uint32_t len, const double* x) {
+    return active_kernels.gather_dot(values, idx, len, x);
+}
+
+int32_t kernel_ratio_test(uint32_t n, const double* x, const double* d, double sign, const double* lb,
+                          const double* ub, double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    return active_kernels.ratio_test(n, x, d, sign, lb, ub, min_ratio_ptr, to_upper_ptr);
+}
+
+int32_t kernel_dual_ratio_test(uint32_t len, const double* r, const double* alpha, const double* dir, double sign,
+                               double* min_ratio_ptr) {
+    return active_kernels.dual_ratio_test(len, r, alpha, dir, sign, min_ratio_ptr);
+}
+
+int32_t kernel_first_fractional(const double* x, uint32_t len, double tol) {
+    return active_kernels.first_fractional(x, len, tol);
+}
+
+/* SELF TEST */
+
+// Longest buffer of the self test, past a few whole AVX-512 blocks so that every length has a tail
+#define KERNELS_TEST_LEN 67
+#define KERNELS_TEST_ROUNDS 200
+#define KERNELS_TEST_TOL 1e-8
+
+// xorshift64, so that the buffers are the same on every run
+double kernels_test_random(uint64_t* seed_ptr) {
+    *seed_ptr ^= *seed_ptr << 13;
+    *seed_ptr ^= *seed_ptr >> 7;
+    *seed_ptr ^= *seed_ptr << 17;
+    return (double)(*seed_ptr >> 11) / 9007199254740992.0;
+}
+
+// Value among few distinct ones, so that the ratio tests see ties, and with some entries the kernels have to skip
+double kernels_test_value(uint64_t* seed_ptr, double zero_rate) {
+    double u = kernels_test_random(seed_ptr);
+    if (u < zero_rate) {
+        return u < zero_rate / 2.0 ? 0.0 : 1e-10;
+    }
+    return (double)((int32_t)(kernels_test_random(seed_ptr) * 9.0) - 4) * 0.5;
+}
+
+uint32_t kernels_test_level(const kernels_t* kernels_ptr, const kernels_t* scalar_ptr, uint64_t* seed_ptr) {
+    double values[KERNELS_TEST_LEN], x[KERNELS_TEST_LEN], d[KERNELS_TEST_LEN], lb[KERNELS_TEST_LEN];
+    double ub[KERNELS_TEST_LEN], dir[KERNELS_TEST_LEN];
+    uint32_t idx[KERNELS_TEST_LEN];
+    const char* name = kernels_level_to_str(kernels_ptr->level);
+
+    for (uint32_t r = 0; r < KERNELS_TEST_ROUNDS; r++) {
+        for (uint32_t len = 0; len <= KERNELS_TEST_LEN; len++) {
+            for (uint32_t i = 0; i < len; i++) {
+                values[i] = kernels_test_random(seed_ptr) * 2.0 - 1.0;
+                idx[i] = (uint32_t)(kernels_test_random(seed_ptr) * len);
+                x[i] = kernels_test_value(seed_ptr, 0.1);
+                d[i] = kernels_test_value(seed_ptr, 0.2);
+                lb[i] = x[i] - fabs(kernels_test_value(seed_ptr, 0.3));
+                ub[i] = x[i] + fabs(kernels_test_value(seed_ptr, 0.3));
+                if (kernels_test_random(seed_ptr) < 0.3) {
+                    ub[i] = VARIABLE_INF;
+                }
+                dir[i] = (double)((int32_t)(kernels_test_random(seed_ptr) * 3.0) - 1);
+            }
+
+            // The dot product must match to the last bit
+            double dot = kernels_ptr->gather_dot(values, idx, len, x);
+            double scalar_dot = scalar_ptr->gather_dot(values, idx, len, x);
+            if (memcmp(&dot, &scalar_dot, sizeof(double)) != 0) {
+                fprintf(stderr, "%s gather_dot differs from scalar at length %u: %.17g != %.17g\n", name, len, dot,
+                        scalar_dot);
+                return 0;
+            }
+
+            // Both signs, starting from no bound on the ratio and from one that hides the entries above it
+            for (uint32_t k = 0; k < 4; k++) {
+                double sign = k % 2 ? -1.0 : 1.0;
+                double start = k < 2 ? 1e20 : 1.0;
+
+                double min_ratio = start, scalar_min_ratio = start;
+                uint32_t to_upper = 2, scalar_to_upper = 2;
+                int32_t p = kernels_ptr->ratio_test(len, x, d, sign, lb, ub, &min_ratio, &to_upper);
+                int32_t scalar_p = scalar_ptr->ratio_test(len, x, d, sign, lb, ub, &scalar_min_ratio, &scalar_to_upper);
+                if (p != scalar_p || to_upper != scalar_to_upper ||
+                    memcmp(&min_ratio, &scalar_min_ratio, sizeof(double)) != 0) {
+                    fprintf(stderr, "%s ratio_test differs from scalar at length %u: %d != %d\n", name, len, p,
+                            scalar_p);
+                    return 0;
+                }
+
+                min_ratio = start;
+                scalar_min_ratio = start;
+                int32_t q = kernels_ptr->dual_ratio_test(len, x, d, dir, sign, &min_ratio);
+                int32_t scalar_q = scalar_ptr->dual_ratio_test(len, x, d, dir, sign, &scalar_min_ratio);
+                if (q != scalar_q || memcmp(&min_ratio, &scalar_min_ratio, sizeof(double)) != 0) {
+                    fprintf(stderr, "%s dual_ratio_test differs from scalar at length %u: %d != %d\n", name, len, q,
+                            scalar_q);
+                    return 0;
+                }
+            }
+
+            // Integers with a single fractional value (halves included) anywhere, or none at all
+            for (uint32_t i = 0; i < len; i++) {
+                x[i] = round(x[i] * 4.0);
+            }
+            if (len > 0 && kernels_test_random(seed_ptr) < 0.8) {
+                uint32_t i = (uint32_t)(kernels_test_random(seed_ptr) * len);
+                double u = kernels_test_random(seed_ptr);
+                x[i] += u < 0.3 ? 0.5 : (u < 0.6 ? KERNELS_TEST_TOL * 2.0 : KERNELS_TEST_TOL / 2.0);
+            }
+            int32_t f = kernels_ptr->first_fractional(x, len, KERNELS_TEST_TOL);
+            int32_t scalar_f = scalar_ptr->first_fractional(x, len, KERNELS_TEST_TOL);
+            if (f != scalar_f) {
+                fprintf(stderr, "%s first_fractional differs from scalar at length %u: %d != %d\n", name, len, f,
+                        scalar_f);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+uint32_t kernels_self_test(void) {
+    const kernels_t scalar = {KERNELS_SCALAR, scalar_gather_dot, scalar_ratio_test, scalar_dual_ratio_test,
+                              scalar_first_fractional};
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint32_t tested_n = 0;
+
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        const kernels_t avx2 = {KERNELS_AVX2, avx2_gather_dot, avx2_ratio_test, avx2_dual_ratio_test,
+                                avx2_first_fractional};
+        if (!kernels_test_level(&avx2, &scalar, &seed)) {
+            return 0;
+        }
+        tested_n++;
+
+        if (__builtin_cpu_supports("avx512f")) {
+            const kernels_t avx512 = {KERNELS_AVX512, avx2_gather_dot, avx512_ratio_test, avx512_dual_ratio_test,
+                                      avx512_first_fractional};
+            if (!kernels_test_level(&avx512, &scalar, &seed)) {
+                return 0;
+            }
+            tested_n++;
+        }
+    }
+#endif
+
+    printf("The %u vector kernel sets the CPU supports match the scalar kernels\n", tested_n);
+    return 1;
+}
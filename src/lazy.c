@@ -0,0 +1,385 @@
+#include "lazy.h"
+#include "utils.h"
+#include "scaling.h"
+#include "simplex/primal.h"
+#include "simplex/dual.h"
+#include "branch_bound/algorithm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* POOL */
+uint32_t lazy_pool_read(lazy_pool_t* pool_ptr, FILE* stream, uint32_t m) {
+    if (!pool_ptr || !stream) {
+        fprintf(stderr, "Some arguments are NULL in lazy_pool_read\n");
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t row_n = 0;
+    uint32_t* cols = (uint32_t*)malloc(sizeof(uint32_t) * (m + 1));
+    double* values = (double*)malloc(sizeof(double) * (m + 1));
+    if (!cols || !values || fscanf(stream, "%u", &row_n) != 1) {
+        fprintf(stderr, "Failed to read the number of lazy rows\n");
+        goto fail;
+    }
+
+    pool_ptr->rhs = (double*)malloc(sizeof(double) * (row_n + 1));
+    pool_ptr->sense = (lazy_sense_t*)malloc(sizeof(lazy_sense_t) * (row_n + 1));
+    pool_ptr->is_added = (uint8_t*)calloc(row_n + 1, sizeof(uint8_t));
+    if (!pool_ptr->rhs || !pool_ptr->sense || !pool_ptr->is_added ||
+        !csr_init(&pool_ptr->rows, m, row_n, row_n + m)) {
+        fprintf(stderr, "Failed to allocate the lazy rows\n");
+        goto fail;
+    }
+
+    for (uint32_t i = 0; i < row_n; i++) {
+        char sense[3] = {0};
+        uint32_t length = 0;
+        if (fscanf(stream, " %2s %lf %u", sense, &pool_ptr->rhs[i], &length) != 3 || length > m) {
+            fprintf(stderr, "Malformed lazy row %u\n", i + 1);
+            goto fail;
+        }
+
+        if (strcmp(sense, "<=") == 0) {
+            pool_ptr->sense[i] = LAZY_LE;
+        } else if (strcmp(sense, ">=") == 0) {
+            pool_ptr->sense[i] = LAZY_GE;
+        } else if (strcmp(sense, "=") == 0) {
+            pool_ptr->sense[i] = LAZY_EQ;
+        } else {
+            fprintf(stderr, "Unknown sense '%s' of lazy row %u, expected <=, >= or =\n", sense, i + 1);
+            goto fail;
+        }
+
+        // Columns are numbered from 1 as the variables x1 ... xm, in increasing order
+        for (uint32_t k = 0; k < length; k++) {
+            uint32_t j = 0;
+            if (fscanf(stream, "%u %lf", &j, &values[k]) != 2 || j == 0 || j > m || (k > 0 && j - 1 <= cols[k - 1])) {
+                fprintf(stderr, "Invalid entry %u of lazy row %u\n", k + 1, i + 1);
+                goto fail;
+            }
+            cols[k] = j - 1;
+        }
+
+        if (!csr_push_row(&pool_ptr->rows, cols, values, length)) {
+            fprintf(stderr, "Failed to store lazy row %u\n", i + 1);
+            goto fail;
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+    lazy_pool_free(pool_ptr);
+cleanup:
+    free(cols);
+    free(values);
+    return ret;
+}
+
+uint32_t lazy_pool_separate(const lazy_pool_t* pool_ptr, const gsl_vector* x, uint32_t* violated) {
+    const csr_matrix_t* R = &pool_ptr->rows;
+    double excess[LAZY_ROUND_ROWS];
+    uint32_t found = 0;
+
+    for (uint32_t i = 0; i < R->rows; i++) {
+        if (pool_ptr->is_added[i]) {
+            continue;
+        }
+
+        double ax = 0.0;
+        for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+            ax += R->values[k] * gsl_vector_get(x, R->col_idx[k]);
+        }
+
+        double rhs = pool_ptr->rhs[i];
+        double e = fabs(ax - rhs);
+        if (pool_ptr->sense[i] == LAZY_LE) {
+            e = ax - rhs;
+        } else if (pool_ptr->sense[i] == LAZY_GE) {
+            e = rhs - ax;
+        }
+        e /= 1.0 + fabs(rhs);
+        if (e <= LAZY_TOL || (found == LAZY_ROUND_ROWS && e <= excess[found - 1])) {
+            continue;
+        }
+
+        // Insert the row in the list sorted by decreasing violation, dropping the last one when full
+        uint32_t k = found < LAZY_ROUND_ROWS ? found++ : found - 1;
+        while (k > 0 && excess[k - 1] < e) {
+            excess[k] = excess[k - 1];
+            violated[k] = violated[k - 1];
+            k--;
+        }
+        excess[k] = e;
+        violated[k] = i;
+    }
+
+    return found;
+}
+
+void lazy_pool_free(lazy_pool_t* pool_ptr) {
+    if (!pool_ptr) {
+        return;
+    }
+
+    csr_free(&pool_ptr->rows);
+    free(pool_ptr->rhs);
+    free(pool_ptr->sense);
+    free(pool_ptr->is_added);
+    pool_ptr->rhs = NULL;
+    pool_ptr->sense = NULL;
+    pool_ptr->is_added = NULL;
+}
+
+/* ROW GENERATION */
+// Appends the rows of the pool to the LP, each with a basic slack column: a * x + s = rhs with s >= 0 for <=,
+// a * x - s = rhs for >= and s = 0 for =. The duals of the new rows are 0, so the basis stays dual feasible.
+// The coefficients are scaled by col_scale (NULL if the problem is not scaled)
+uint32_t lazy_add_rows(problem_t* problem_ptr, lazy_pool_t* pool_ptr, const uint32_t* rows, uint32_t row_n,
+                       uint32_t structural_m, const gsl_vector* col_scale) {
+    if (!problem_fix_artificials(problem_ptr)) {
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    const csc_matrix_t* A_old = &problem_ptr->A;
+    const csr_matrix_t* R = &pool_ptr->rows;
+    uint32_t new_n = n + row_n;
+    uint32_t new_m = m + row_n;
+    uint32_t buffer_length = new_n > structural_m ? new_n : structural_m;
+
+    uint32_t ret = 1;
+    csr_matrix_t added = {0};
+    csc_matrix_t added_cols = {0};
+    csc_matrix_t A = {0};
+    var_arr_t var_arr = {0};
+    int32_t* N = NULL;
+    gsl_vector* c = gsl_vector_calloc(new_m + new_n);
+    gsl_vector* b = gsl_vector_alloc(new_n);
+    int32_t* B = (int32_t*)malloc(sizeof(int32_t) * new_n);
+    var_state_t* state = (var_state_t*)calloc(new_m + new_n, sizeof(var_state_t));
+    uint32_t* entry_idx = (uint32_t*)malloc(sizeof(uint32_t) * buffer_length);
+    double* entry_values = (double*)malloc(sizeof(double) * buffer_length);
+    if (!c || !b || !B || !state || !entry_idx || !entry_values ||
+        !csr_init(&added, structural_m, row_n, R->row_ptr[R->rows] + 1) ||
+        !csc_init(&A, new_n, new_m + new_n, A_old->col_ptr[m] + R->row_ptr[R->rows] + new_m) ||
+        !var_arr_init(&var_arr, new_m + new_n)) {
+        fprintf(stderr, "Failed to allocate the LP with the lazy rows\n");
+        goto fail;
+    }
+
+    // The new rows in the columns of the scaled problem
+    for (uint32_t r = 0; r < row_n; r++) {
+        uint32_t i = rows[r];
+        uint32_t length = 0;
+        for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+            double s = col_scale ? gsl_vector_get(col_scale, R->col_idx[k]) : 1.0;
+            entry_idx[length] = R->col_idx[k];
+            entry_values[length++] = s * R->values[k];
+        }
+        if (!csr_push_row(&added, entry_idx, entry_values, length)) {
+            goto fail;
+        }
+    }
+    if (!csc_from_csr(&added_cols, &added, structural_m)) {
+        goto fail;
+    }
+
+    // Columns of the LP, with the entries of the new rows below the old ones
+    for (uint32_t j = 0; j < m; j++) {
+        uint32_t length = 0;
+        for (uint32_t k = A_old->col_ptr[j]; k < A_old->col_ptr[j + 1]; k++) {
+            entry_idx[length] = A_old->row_idx[k];
+            entry_values[length++] = A_old->values[k];
+        }
+        if (j < structural_m) {
+            for (uint32_t k = added_cols.col_ptr[j]; k < added_cols.col_ptr[j + 1]; k++) {
+                entry_idx[length] = n + added_cols.row_idx[k];
+                entry_values[length++] = added_cols.values[k];
+            }
+        }
+        if (!csc_push_column(&A, entry_idx, entry_values, length)) {
+            goto fail;
+        }
+    }
+
+    memcpy(var_arr.data, problem_ptr->var_arr.data, sizeof(variable_t) * m);
+    var_arr.length = m;
+    memcpy(state, problem_ptr->state, sizeof(var_state_t) * m);
+    memcpy(B, problem_ptr->B, sizeof(int32_t) * n);
+    for (uint32_t j = 0; j < m; j++) {
+        gsl_vector_set(c, j, gsl_vector_get(problem_ptr->c, j));
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(b, i, gsl_vector_get(problem_ptr->b, i));
+    }
+
+    uint32_t next = m;
+    for (uint32_t r = 0; r < row_n; r++) {
+        uint32_t i = rows[r];
+        uint32_t row = n + r;
+        double sign = pool_ptr->sense[i] == LAZY_GE ? -1.0 : 1.0;
+        variable_t slack;
+        variable_init(&slack, 0.0, pool_ptr->sense[i] == LAZY_EQ ? 0.0 : VARIABLE_INF, VAR_REAL);
+        if (!var_arr_push(&var_arr, &slack) || !csc_push_column(&A, &row, &sign, 1)) {
+            goto fail;
+        }
+
+        gsl_vector_set(b, row, pool_ptr->rhs[i]);
+        state[next] = VAR_STATE_BASIC;
+        B[row] = (int32_t)next++;
+        pool_ptr->is_added[i] = 1;
+    }
+
+    N = calculate_nonbasis(B, new_n, new_m + new_n);
+    if (!N) {
+        goto fail;
+    }
+
+    gsl_vector_free(problem_ptr->c);
+    gsl_vector_free(problem_ptr->b);
+    csc_free(&problem_ptr->A);
+    var_arr_free(&problem_ptr->var_arr);
+    free(problem_ptr->B);
+    free(problem_ptr->N);
+    free(problem_ptr->state);
+    problem_ptr->n = new_n;
+    problem_ptr->m = new_m;
+    problem_ptr->c = c;
+    problem_ptr->b = b;
+    problem_ptr->A = A;
+    problem_ptr->var_arr = var_arr;
+    problem_ptr->B = B;
+    problem_ptr->N = N;
+    problem_ptr->state = state;
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+    fprintf(stderr, "Failed to add the lazy rows to the LP\n");
+    gsl_vector_free(c);
+    gsl_vector_free(b);
+    csc_free(&A);
+    var_arr_free(&var_arr);
+    free(B);
+    free(state);
+cleanup:
+    csr_free(&added);
+    csc_free(&added_cols);
+    free(entry_idx);
+    free(entry_values);
+    return ret;
+}
+
+uint32_t problem_solve_lazy(problem_t* problem_ptr, FILE* stream, solution_t* solution_ptr) {
+    if (!problem_ptr || !stream || !solution_ptr) {
+        fprintf(stderr, "Some arguments are NULL in problem_solve_lazy\n");
+        return 0;
+    }
+
+    if (problem_is_milp(problem_ptr)) {
+        fprintf(stderr, "Lazy constraints can only be added to LPs\n");
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    uint32_t ret = 1;
+    lazy_pool_t pool = {0};
+    scaling_t scaling = {0};
+    solution_t current = {0};
+    gsl_vector* x = gsl_vector_alloc(m);
+    uint32_t* violated = (uint32_t*)malloc(sizeof(uint32_t) * LAZY_ROUND_ROWS);
+    if (!x || !violated || !lazy_pool_read(&pool, stream, m) || !problem_load_basis(problem_ptr, problem_ptr, NULL)) {
+        goto fail;
+    }
+
+    if (problem_ptr->options.scaling && !scaling_apply(&scaling, problem_ptr)) {
+        goto fail;
+    }
+    if (!problem_prepare(problem_ptr)) {
+        if (problem_ptr->is_infeasible && solution_init(solution_ptr, n, m + n, 0) &&
+            solution_set_infeasible(solution_ptr, 1)) {
+            goto cleanup;
+        }
+        goto fail;
+    }
+
+    // Only the first solve can need the primal simplex, the rows added later keep the basis dual feasible
+    solve_fn solver = problem_ptr->is_dual_start ? simplex_dual : simplex_primal;
+    uint32_t iter_n = 0;
+    uint32_t added_n = 0;
+    for (uint32_t round = 1;; round++) {
+        gsl_vector_view c = gsl_vector_subvector(problem_ptr->c, 0, problem_ptr->m);
+        gsl_vector_view b = gsl_vector_subvector(problem_ptr->b, 0, problem_ptr->n);
+        uint32_t round_iter_n = 0;
+        solution_free(&current);
+        memset(&current, 0, sizeof(solution_t));
+        if (!solver(problem_ptr->n, problem_ptr->m, problem_ptr->is_max, &c.vector, &problem_ptr->A, &b.vector,
+                    &problem_ptr->var_arr, problem_ptr->B, problem_ptr->N, problem_ptr->state, &problem_ptr->options,
+                    NULL, &current, &round_iter_n)) {
+            goto fail;
+        }
+        iter_n += round_iter_n;
+
+        // The dual simplex is unbounded when the rows added make the LP infeasible
+        if (current.is_unbounded) {
+            if (solver == simplex_dual) {
+                printf("The lazy rows make the LP infeasible\n");
+                current.is_unbounded = 0;
+                current.is_infeasible = 1;
+            }
+            break;
+        }
+
+        // The rows are checked on the variables of the model, not the scaled ones
+        for (uint32_t j = 0; j < m; j++) {
+            double s = scaling.col_scale ? gsl_vector_get(scaling.col_scale, j) : 1.0;
+            gsl_vector_set(x, j, s * gsl_vector_get(current.x, j));
+        }
+        uint32_t found = lazy_pool_separate(&pool, x, violated);
+        if (found == 0) {
+            break;
+        }
+
+        printf("Round %u: adding %u violated lazy rows after %u iterations\n", round, found, round_iter_n);
+        if (!lazy_add_rows(problem_ptr, &pool, violated, found, m, scaling.col_scale)) {
+            goto fail;
+        }
+        added_n += found;
+        solver = simplex_dual;
+    }
+    printf("\n%u of the %u lazy rows were added to the LP\n", added_n, pool.rows.rows);
+
+    // Report the solution in the variables of the model
+    if (!solution_init(solution_ptr, n, m + n, current.is_unbounded) ||
+        !solution_set_infeasible(solution_ptr, current.is_infeasible)) {
+        goto fail;
+    }
+    for (uint32_t j = 0; j < m && !current.is_unbounded && !current.is_infeasible; j++) {
+        gsl_vector_set(solution_ptr->x, j, gsl_vector_get(current.x, j));
+    }
+    solution_set_z(solution_ptr, current.z);
+    solution_set_pI_iter(solution_ptr, problem_ptr->pI_iter);
+    solution_set_pII_iter(solution_ptr, iter_n);
+    scaling_unscale_solution(&scaling, solution_ptr);
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    solution_free(&current);
+    lazy_pool_free(&pool);
+    scaling_free(&scaling);
+    gsl_vector_free(x);
+    free(violated);
+    return ret;
+}
@@ -1,4 +1,8 @@
 #include "problem.h"
+#include "batch.h"
+#include "lazy.h"
+#include "colgen.h"
+#include "options.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -33,32 +37,94 @@ int main(int argc, char** args) {
         return EXIT_FAILURE;
     }
 
-    if (argc > 2) {
-        fprintf(stderr, "Wrong number of arguments! Usage: 'zmax <filename>' or just 'zmax' to read from stdin\n");
+    options_t options;
+    options_init(&options);
+    const char* filename = NULL;
+    if (!options_from_args(&options, argc, args, &filename)) {
+        options_print_usage(args[0]);
         return EXIT_FAILURE;
     }
 
+    // Self test: no model is read
+    if (options.check_kernels) {
+        return kernels_self_test() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     gsl_set_error_handler_off();
 
-    FILE* stream = argc == 2 ? fopen(args[1], "r") : stdin;
+    if (!kernels_select(options.kernels)) {
+        return EXIT_FAILURE;
+    }
+
+    if (!parallel_init(options.threads, options.parallel_min)) {
+        return EXIT_FAILURE;
+    }
+
+    FILE* stream = filename ? fopen(filename, "r") : stdin;
     if (!stream) {
         perror("Failed to determine stream");
         return EXIT_FAILURE;
     }
 
     problem_t problem = {0};
-    if (!problem_from_stream(&problem, stream)) {
+    if (!problem_from_stream(&problem, stream, &options)) {
         fprintf(stderr, "Failed to create problem\n");
         return EXIT_FAILURE;
     }
 
     problem_print(&problem, "Problem");
 
+    // Batch mode: the scenarios are printed as they are solved
+    if (options.scenarios) {
+        FILE* scenario_stream = fopen(options.scenarios, "r");
+        if (!scenario_stream) {
+            perror("Failed to open the scenario file");
+            problem_free(&problem);
+            parallel_free();
+            return EXIT_FAILURE;
+        }
+
+        uint32_t ok = problem_solve_batch(&problem, scenario_stream);
+        fclose(scenario_stream);
+        problem_free(&problem);
+        parallel_free();
+        if (!ok) {
+            fprintf(stderr, "Failed to solve the scenarios\n");
+            return EXIT_FAILURE;
+        }
+        print_performance_report(&t_start, &t_end, &usage);
+        return EXIT_SUCCESS;
+    }
+
+    // Row generation: the rows of the lazy constraint file join the LP as its solutions violate them
+    uint32_t ok = 0;
     solution_t solution = {0};
-    if (!problem_solve(&problem, &solution)) {
+    if (options.lazy) {
+        FILE* lazy_stream = fopen(options.lazy, "r");
+        if (!lazy_stream) {
+            perror("Failed to open the lazy constraint file");
+        } else {
+            ok = problem_solve_lazy(&problem, lazy_stream, &solution);
+            fclose(lazy_stream);
+        }
+    } else if (options.columns) {
+        // Column generation: the candidate columns join the LP as the duals price them out improving
+        FILE* column_stream = fopen(options.columns, "r");
+        if (!column_stream) {
+            perror("Failed to open the candidate column file");
+        } else {
+            ok = problem_solve_column_pool(&problem, column_stream, &solution);
+            fclose(column_stream);
+        }
+    } else {
+        ok = problem_solve(&problem, &solution);
+    }
+
+    if (!ok) {
         fprintf(stderr, "Failed to solve problem\n");
         problem_free(&problem);
         solution_free(&solution);
+        parallel_free();
         return EXIT_FAILURE;
     }
 
@@ -66,6 +132,7 @@ int main(int argc, char** args) {
 
     problem_free(&problem);
     solution_free(&solution);
+    parallel_free();
     print_performance_report(&t_start, &t_end, &usage);
 
     return EXIT_SUCCESS;
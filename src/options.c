@@ -0,0 +1,300 @@
+#include "options.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <errno.h>
+
+const char* pricing_rule_to_str(pricing_rule_t rule) {
+    switch (rule) {
+        case PRICING_DANTZIG: {
+            return "dantzig";
+        }
+        case PRICING_DEVEX: {
+            return "devex";
+        }
+        case PRICING_STEEPEST_EDGE: {
+            return "steepest";
+        }
+        case PRICING_BLAND: {
+            return "bland";
+        }
+        case PRICING_ERR: {
+            return "error";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+pricing_rule_t pricing_rule_from_str(const char* str) {
+    for (pricing_rule_t rule = PRICING_DANTZIG; rule < PRICING_ERR; rule++) {
+        if (strcmp(str, pricing_rule_to_str(rule)) == 0) {
+            return rule;
+        }
+    }
+
+    return PRICING_ERR;
+}
+
+const char* node_select_to_str(node_select_t rule) {
+    switch (rule) {
+        case NODE_SELECT_BOUND: {
+            return "bound";
+        }
+        case NODE_SELECT_ESTIMATE: {
+            return "estimate";
+        }
+        case NODE_SELECT_PLUNGE: {
+            return "plunge";
+        }
+        case NODE_SELECT_ERR: {
+            return "error";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+node_select_t node_select_from_str(const char* str) {
+    for (node_select_t rule = NODE_SELECT_BOUND; rule < NODE_SELECT_ERR; rule++) {
+        if (strcmp(str, node_select_to_str(rule)) == 0) {
+            return rule;
+        }
+    }
+
+    return NODE_SELECT_ERR;
+}
+
+void options_init(options_t* options_ptr) {
+    if (!options_ptr) {
+        return;
+    }
+
+    options_ptr->refactor_period = DEFAULT_REFACTOR_PERIOD;
+    options_ptr->pricing = PRICING_DEVEX;
+    options_ptr->partial_size = 0;
+    options_ptr->multiple_size = 0;
+    options_ptr->dual_pricing = PRICING_STEEPEST_EDGE;
+    options_ptr->kernels = KERNELS_AUTO;
+    options_ptr->node_select = NODE_SELECT_PLUNGE;
+    options_ptr->presolve = 1;
+    options_ptr->scaling = 1;
+    options_ptr->basis_in = NULL;
+    options_ptr->basis_out = NULL;
+    options_ptr->threads = 1;
+    options_ptr->parallel_min = DEFAULT_PARALLEL_MIN;
+    options_ptr->barrier = 0;
+    options_ptr->scenarios = NULL;
+    options_ptr->lazy = NULL;
+    options_ptr->columns = NULL;
+    options_ptr->check_kernels = 0;
+}
+
+uint32_t parse_uint(const char* str, const char* name, uint32_t* value_ptr) {
+    // strtoul would accept a sign and wrap a negative value around, so only digits are allowed
+    char* end = NULL;
+    errno = 0;
+    unsigned long value = isdigit((unsigned char)str[0]) ? strtoul(str, &end, 10) : 0;
+    if (!end || *end != '\0' || end == str || errno == ERANGE || value > UINT32_MAX) {
+        fprintf(stderr, "Invalid value '%s' for option %s\n", str, name);
+        return 0;
+    }
+
+    *value_ptr = (uint32_t)value;
+    return 1;
+}
+
+uint32_t options_from_args(options_t* options_ptr, int argc, char** args, const char** filename_ptr) {
+    if (!options_ptr || !args || !filename_ptr) {
+        return 0;
+    }
+
+    static const struct option long_options[] = {
+        {"refactor", required_argument, NULL, 'r'},
+        {"pricing", required_argument, NULL, 'p'},
+        {"partial", required_argument, NULL, 'P'},
+        {"multiple", required_argument, NULL, 'M'},
+        {"dual", required_argument, NULL, 'd'},
+        {"kernels", required_argument, NULL, 'k'},
+        {"no-presolve", no_argument, NULL, 'n'},
+        {"no-scaling", no_argument, NULL, 's'},
+        {"basis-in", required_argument, NULL, 'i'},
+        {"basis-out", required_argument, NULL, 'o'},
+        {"threads", required_argument, NULL, 't'},
+        {"parallel-min", required_argument, NULL, 'T'},
+        {"barrier", no_argument, NULL, 'b'},
+        {"scenarios", required_argument, NULL, 'S'},
+        {"lazy", required_argument, NULL, 'L'},
+        {"columns", required_argument, NULL, 'C'},
+        {"nodes", required_argument, NULL, 'N'},
+        {"check-kernels", no_argument, NULL, 'K'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int opt;
+    optind = 1;
+    while ((opt = getopt_long(argc, args, "r:p:P:M:d:k:nsi:o:t:T:bS:L:C:N:Kh", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'r': {
+                if (!parse_uint(optarg, "--refactor", &options_ptr->refactor_period) ||
+                    options_ptr->refactor_period == 0) {
+                    fprintf(stderr, "--refactor must be a positive integer\n");
+                    return 0;
+                }
+                break;
+            }
+            case 'p': {
+                options_ptr->pricing = pricing_rule_from_str(optarg);
+                if (options_ptr->pricing == PRICING_ERR) {
+                    fprintf(stderr, "Unknown pricing rule '%s'\n", optarg);
+                    return 0;
+                }
+                break;
+            }
+            case 'P': {
+                if (!parse_uint(optarg, "--partial", &options_ptr->partial_size)) {
+                    return 0;
+                }
+                break;
+            }
+            case 'M': {
+                if (!parse_uint(optarg, "--multiple", &options_ptr->multiple_size)) {
+                    return 0;
+                }
+                break;
+            }
+            case 'd': {
+                options_ptr->dual_pricing = pricing_rule_from_str(optarg);
+                if (options_ptr->dual_pricing == PRICING_ERR) {
+                    fprintf(stderr, "Unknown dual pricing rule '%s'\n", optarg);
+                    return 0;
+                }
+                break;
+            }
+            case 'k': {
+                options_ptr->kernels = kernels_level_from_str(optarg);
+                if (options_ptr->kernels == KERNELS_ERR) {
+                    fprintf(stderr, "Unknown kernels '%s'\n", optarg);
+                    return 0;
+                }
+                break;
+            }
+            case 'n': {
+                options_ptr->presolve = 0;
+                break;
+            }
+            case 's': {
+                options_ptr->scaling = 0;
+                break;
+            }
+            case 'i': {
+                options_ptr->basis_in = optarg;
+                break;
+            }
+            case 'o': {
+                options_ptr->basis_out = optarg;
+                break;
+            }
+            case 't': {
+                if (!parse_uint(optarg, "--threads", &options_ptr->threads)) {
+                    return 0;
+                }
+                break;
+            }
+            case 'T': {
+                if (!parse_uint(optarg, "--parallel-min", &options_ptr->parallel_min)) {
+                    return 0;
+                }
+                break;
+            }
+            case 'b': {
+                options_ptr->barrier = 1;
+                break;
+            }
+            case 'S': {
+                options_ptr->scenarios = optarg;
+                break;
+            }
+            case 'L': {
+                options_ptr->lazy = optarg;
+                break;
+            }
+            case 'C': {
+                options_ptr->columns = optarg;
+                break;
+            }
+            case 'N': {
+                options_ptr->node_select = node_select_from_str(optarg);
+                if (options_ptr->node_select == NODE_SELECT_ERR) {
+                    fprintf(stderr, "Unknown node selection rule '%s'\n", optarg);
+                    return 0;
+                }
+                break;
+            }
+            case 'K': {
+                options_ptr->check_kernels = 1;
+                break;
+            }
+            case 'h':
+            default: {
+                return 0;
+            }
+        }
+    }
+
+    if (argc - optind > 1) {
+        fprintf(stderr, "Too many model files\n");
+        return 0;
+    }
+
+    // The scenarios, lazy rows and generated columns each drive their own solve loop from the simplex
+    uint32_t mode_n = (options_ptr->scenarios != NULL) + (options_ptr->lazy != NULL) + (options_ptr->columns != NULL);
+    if (mode_n > 1) {
+        fprintf(stderr, "--scenarios, --lazy and --columns cannot be combined\n");
+        return 0;
+    }
+    if (mode_n > 0 && options_ptr->barrier) {
+        fprintf(stderr, "--barrier cannot be combined with --scenarios, --lazy or --columns\n");
+        return 0;
+    }
+    if ((options_ptr->lazy || options_ptr->columns) && options_ptr->basis_out) {
+        fprintf(stderr, "--basis-out cannot be combined with --lazy or --columns\n");
+        return 0;
+    }
+
+    *filename_ptr = optind < argc ? args[optind] : NULL;
+
+    return 1;
+}
+
+void options_print_usage(const char* program) {
+    fprintf(stderr, "Usage: '%s [options] <filename>' or just '%s [options]' to read from stdin\n", program, program);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -r, --refactor N   Refactorize the basis every N updates (default %u)\n",
+            DEFAULT_REFACTOR_PERIOD);
+    fprintf(stderr, "  -p, --pricing RULE Primal entering rule: dantzig, devex, steepest or bland (default devex)\n");
+    fprintf(stderr, "  -P, --partial N    Price the nonbasic columns in rotating segments of N (default 0 = all)\n");
+    fprintf(stderr, "  -M, --multiple K   Keep K entering candidates between iterations (default 0 = off)\n");
+    fprintf(stderr, "  -d, --dual RULE    Dual leaving rule: dantzig, devex, steepest or bland (default steepest)\n");
+    fprintf(stderr, "  -k, --kernels SET  Vector kernels: auto, scalar, avx2 or avx512 (default auto)\n");
+    fprintf(stderr, "  -n, --no-presolve  Solve the problem as it is, without reducing it first\n");
+    fprintf(stderr, "  -s, --no-scaling   Solve the problem without scaling the rows and columns of A\n");
+    fprintf(stderr, "  -i, --basis-in FILE  Start from the basis saved in FILE instead of PhaseI\n");
+    fprintf(stderr, "  -o, --basis-out FILE Save the final basis to FILE\n");
+    fprintf(stderr, "  -t, --threads N    Price the nonbasic columns with N threads (default 1, 0 = one per CPU)\n");
+    fprintf(stderr, "  -T, --parallel-min N Use the threads from N nonbasic columns on (default %u)\n",
+            DEFAULT_PARALLEL_MIN);
+    fprintf(stderr, "  -b, --barrier      Solve the LP with the interior point method, then cross over to a basis\n");
+    fprintf(stderr, "  -S, --scenarios FILE Solve the RHS and cost vectors of FILE from the optimal basis\n");
+    fprintf(stderr, "  -L, --lazy FILE    Add the rows of FILE to the LP only once its solution violates them\n");
+    fprintf(stderr, "  -C, --columns FILE Generate the columns of FILE into the LP while they price out improving\n");
+    fprintf(stderr, "  -N, --nodes RULE   Node selection: bound, estimate or plunge (default plunge)\n");
+    fprintf(stderr, "  -K, --check-kernels Check the vector kernels the CPU supports against the scalar ones\n");
+    fprintf(stderr, "  -h, --help         Show this message\n");
+}
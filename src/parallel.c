@@ -0,0 +1,187 @@
+#include "parallel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Pool of workers that sleep between loops. The caller publishes a loop by bumping the
+// generation, then every thread claims blocks from next_block until none is left
+typedef struct parallel_pool {
+    uint32_t threads;              // Threads working on a loop, the caller included
+    uint32_t min_len;              // Shortest loop that is split over the threads
+    pthread_t* workers;            // The threads - 1 workers
+    pthread_mutex_t mutex;
+    pthread_cond_t start_cond;     // Signals a new generation (or stop) to the workers
+    pthread_cond_t done_cond;      // Signals the caller that busy reached 0
+    uint64_t generation;           // Number of loops published
+    uint32_t busy;                 // Workers still working on the current loop
+    uint32_t stop;                 // Boolean value to make the workers exit
+    parallel_fn fn;                // Current loop
+    void* ctx;
+    uint32_t len;
+    uint32_t block_n;
+    uint32_t next_block;           // First block nobody has claimed yet (atomic)
+    parallel_best_t* results;      // Result of each block (size results_capacity)
+    uint32_t results_capacity;
+} parallel_pool_t;
+
+static parallel_pool_t pool = {
+    .threads = 1,
+    .min_len = DEFAULT_PARALLEL_MIN,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .start_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER,
+};
+
+// Boolean value to make the loops of the calling thread run on it alone
+static __thread uint32_t is_serial = 0;
+
+// Claims and runs blocks of the current loop until none is left
+void parallel_run_blocks(void) {
+    uint32_t b;
+    while ((b = __atomic_fetch_add(&pool.next_block, 1, __ATOMIC_RELAXED)) < pool.block_n) {
+        uint32_t start = b * PARALLEL_BLOCK;
+        uint32_t end = start + PARALLEL_BLOCK < pool.len ? start + PARALLEL_BLOCK : pool.len;
+        pool.results[b] = pool.fn(pool.ctx, start, end);
+    }
+}
+
+void* parallel_worker(void* arg) {
+    (void)arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool.mutex);
+    while (1) {
+        while (pool.generation == seen && !pool.stop) {
+            pthread_cond_wait(&pool.start_cond, &pool.mutex);
+        }
+        if (pool.stop) {
+            break;
+        }
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.mutex);
+
+        parallel_run_blocks();
+
+        pthread_mutex_lock(&pool.mutex);
+        if (--pool.busy == 0) {
+            pthread_cond_signal(&pool.done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool.mutex);
+
+    return NULL;
+}
+
+uint32_t parallel_init(uint32_t threads, uint32_t min_len) {
+    parallel_free();
+
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+
+    pool.min_len = min_len;
+    pool.stop = 0;
+    pool.threads = 1;
+    if (threads == 1) {
+        return 1;
+    }
+
+    pool.workers = (pthread_t*)malloc(sizeof(pthread_t) * (threads - 1));
+    if (!pool.workers) {
+        fprintf(stderr, "Failed to allocate the thread pool\n");
+        return 0;
+    }
+
+    // A worker that fails to start leaves the pool with fewer threads
+    for (uint32_t t = 0; t < threads - 1; t++) {
+        if (pthread_create(&pool.workers[t], NULL, parallel_worker, NULL) != 0) {
+            fprintf(stderr, "Failed to start worker %u, using %u threads\n", t + 1, pool.threads);
+            break;
+        }
+        pool.threads++;
+    }
+
+    return 1;
+}
+
+uint32_t parallel_threads(void) {
+    return pool.threads;
+}
+
+void parallel_serial(uint32_t serial) {
+    is_serial = serial;
+}
+
+parallel_best_t parallel_reduce(uint32_t len, parallel_reduce_t reduce, parallel_fn fn, void* ctx) {
+    if (pool.threads == 1 || is_serial || len < pool.min_len) {
+        return fn(ctx, 0, len);
+    }
+
+    uint32_t block_n = (len + PARALLEL_BLOCK - 1) / PARALLEL_BLOCK;
+    if (block_n > pool.results_capacity) {
+        parallel_best_t* results = (parallel_best_t*)realloc(pool.results, sizeof(parallel_best_t) * block_n);
+        if (!results) {
+            return fn(ctx, 0, len);
+        }
+        pool.results = results;
+        pool.results_capacity = block_n;
+    }
+
+    pthread_mutex_lock(&pool.mutex);
+    pool.fn = fn;
+    pool.ctx = ctx;
+    pool.len = len;
+    pool.block_n = block_n;
+    pool.next_block = 0;
+    pool.busy = pool.threads - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start_cond);
+    pthread_mutex_unlock(&pool.mutex);
+
+    parallel_run_blocks();
+
+    // The workers may still be finishing their last block
+    pthread_mutex_lock(&pool.mutex);
+    while (pool.busy > 0) {
+        pthread_cond_wait(&pool.done_cond, &pool.mutex);
+    }
+    pthread_mutex_unlock(&pool.mutex);
+
+    // Reduce in block order, so that ties go to the lowest index as in a serial loop
+    parallel_best_t best = {0.0, -1};
+    for (uint32_t b = 0; b < block_n; b++) {
+        parallel_best_t result = pool.results[b];
+        if (result.index == -1) {
+            continue;
+        }
+        uint32_t better = reduce == PARALLEL_MAX ? result.value > best.value : result.value < best.value;
+        if (best.index == -1 || better) {
+            best = result;
+        }
+    }
+
+    return best;
+}
+
+void parallel_free(void) {
+    if (pool.workers) {
+        pthread_mutex_lock(&pool.mutex);
+        pool.stop = 1;
+        pthread_cond_broadcast(&pool.start_cond);
+        pthread_mutex_unlock(&pool.mutex);
+
+        for (uint32_t t = 0; t + 1 < pool.threads; t++) {
+            pthread_join(pool.workers[t], NULL);
+        }
+    }
+
+    free(pool.workers);
+    free(pool.results);
+    pool.workers = NULL;
+    pool.results = NULL;
+    pool.results_capacity = 0;
+    pool.threads = 1;
+}
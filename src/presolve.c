@@ -0,0 +1,838 @@
+#include "presolve.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Tolerance on coefficients and costs
+#define PRESOLVE_TOL 1e-9
+// Tolerance on the feasibility of the equations and the bounds
+#define PRESOLVE_FEAS_TOL 1e-7
+// Presolve stops after this many passes even if reductions are still being found
+#define PRESOLVE_MAX_PASSES 32
+
+// Working copy of the problem. Reductions never modify A, they only deactivate rows and
+// columns and update the right hand side, the costs and the bounds
+typedef struct presolve_work {
+    uint32_t n;             // Number of rows
+    uint32_t m;             // Number of columns
+    const csc_matrix_t* A;  // Original matrix
+    csr_matrix_t rows;      // Row-wise copy of A
+    double* cost;           // Costs of the minimization form (size m)
+    double* b;              // Right hand side with the removed columns moved into it (size n)
+    double* lb;             // Lower bounds (size m)
+    double* ub;             // Upper bounds, INFINITY when missing (size m)
+    uint32_t* is_integer;   // Columns branch and bound keeps integer (size m)
+    uint32_t* row_active;   // Rows still in the problem (size n)
+    uint32_t* col_active;   // Columns still in the problem (size m)
+} presolve_work_t;
+
+/* POSTSOLVE STACK */
+
+uint32_t presolve_push_op(presolve_t* presolve_ptr, const presolve_op_t* op_ptr) {
+    if (presolve_ptr->ops_length == presolve_ptr->ops_capacity) {
+        uint32_t capacity = presolve_ptr->ops_capacity ? 2 * presolve_ptr->ops_capacity : 16;
+        presolve_op_t* ops = (presolve_op_t*)realloc(presolve_ptr->ops, sizeof(presolve_op_t) * capacity);
+        if (!ops) {
+            fprintf(stderr, "Failed to grow the postsolve stack\n");
+            return 0;
+        }
+        presolve_ptr->ops = ops;
+        presolve_ptr->ops_capacity = capacity;
+    }
+
+    presolve_ptr->ops[presolve_ptr->ops_length++] = *op_ptr;
+    return 1;
+}
+
+uint32_t presolve_push_entry(presolve_t* presolve_ptr, uint32_t col, double value) {
+    if (presolve_ptr->entries_length == presolve_ptr->entries_capacity) {
+        uint32_t capacity = presolve_ptr->entries_capacity ? 2 * presolve_ptr->entries_capacity : 64;
+        uint32_t* cols = (uint32_t*)realloc(presolve_ptr->entry_cols, sizeof(uint32_t) * capacity);
+        if (!cols) {
+            fprintf(stderr, "Failed to grow the postsolve entry pool\n");
+            return 0;
+        }
+        presolve_ptr->entry_cols = cols;
+
+        double* values = (double*)realloc(presolve_ptr->entry_values, sizeof(double) * capacity);
+        if (!values) {
+            fprintf(stderr, "Failed to grow the postsolve entry pool\n");
+            return 0;
+        }
+        presolve_ptr->entry_values = values;
+        presolve_ptr->entries_capacity = capacity;
+    }
+
+    presolve_ptr->entry_cols[presolve_ptr->entries_length] = col;
+    presolve_ptr->entry_values[presolve_ptr->entries_length] = value;
+    presolve_ptr->entries_length++;
+    return 1;
+}
+
+/* WORK */
+
+uint32_t presolve_work_init(presolve_work_t* work_ptr, const problem_t* problem_ptr) {
+    uint32_t n = problem_n(problem_ptr);
+    uint32_t m = problem_m(problem_ptr);
+    const var_arr_t* var_arr_ptr = problem_var_arr(problem_ptr);
+    const gsl_vector* c = problem_c(problem_ptr);
+    const gsl_vector* b = problem_b(problem_ptr);
+
+    work_ptr->n = n;
+    work_ptr->m = m;
+    work_ptr->A = problem_A(problem_ptr);
+    work_ptr->cost = (double*)malloc(sizeof(double) * m);
+    work_ptr->b = (double*)malloc(sizeof(double) * n);
+    work_ptr->lb = (double*)malloc(sizeof(double) * m);
+    work_ptr->ub = (double*)malloc(sizeof(double) * m);
+    work_ptr->is_integer = (uint32_t*)malloc(sizeof(uint32_t) * m);
+    work_ptr->row_active = (uint32_t*)malloc(sizeof(uint32_t) * n);
+    work_ptr->col_active = (uint32_t*)malloc(sizeof(uint32_t) * m);
+    if (!work_ptr->cost || !work_ptr->b || !work_ptr->lb || !work_ptr->ub || !work_ptr->is_integer ||
+        !work_ptr->row_active || !work_ptr->col_active || !csr_from_csc(&work_ptr->rows, work_ptr->A)) {
+        fprintf(stderr, "Failed to allocate the presolve buffers\n");
+        return 0;
+    }
+
+    uint32_t is_max = problem_is_max(problem_ptr);
+    for (uint32_t j = 0; j < m; j++) {
+        const variable_t* v = var_arr_get(var_arr_ptr, j);
+        double cj = gsl_vector_get(c, j);
+        work_ptr->cost[j] = is_max ? -cj : cj;
+        work_ptr->lb[j] = v->lb;
+        work_ptr->ub[j] = variable_has_ub(v) ? v->ub : INFINITY;
+        work_ptr->is_integer[j] = variable_is_integer(v);
+        work_ptr->col_active[j] = 1;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        work_ptr->b[i] = gsl_vector_get(b, i);
+        work_ptr->row_active[i] = 1;
+    }
+
+    return 1;
+}
+
+void presolve_work_free(presolve_work_t* work_ptr) {
+    csr_free(&work_ptr->rows);
+    free(work_ptr->cost);
+    free(work_ptr->b);
+    free(work_ptr->lb);
+    free(work_ptr->ub);
+    free(work_ptr->is_integer);
+    free(work_ptr->row_active);
+    free(work_ptr->col_active);
+}
+
+// Number of active entries of row i, *last_ptr receives the position of the last one in the CSR copy
+uint32_t presolve_row_length(const presolve_work_t* work_ptr, uint32_t i, uint32_t* last_ptr) {
+    const csr_matrix_t* R = &work_ptr->rows;
+    uint32_t length = 0;
+    for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+        if (work_ptr->col_active[R->col_idx[k]]) {
+            length++;
+            *last_ptr = k;
+        }
+    }
+
+    return length;
+}
+
+// Number of active entries of column j, *last_ptr receives the position of the last one in A
+uint32_t presolve_col_length(const presolve_work_t* work_ptr, uint32_t j, uint32_t* last_ptr) {
+    const csc_matrix_t* A = work_ptr->A;
+    uint32_t length = 0;
+    for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+        if (work_ptr->row_active[A->row_idx[k]]) {
+            length++;
+            *last_ptr = k;
+        }
+    }
+
+    return length;
+}
+
+// Smallest and largest value of row i without column skip, given the bounds of the other columns
+void presolve_row_activity(const presolve_work_t* work_ptr, uint32_t i, uint32_t skip, double* lo_ptr,
+                           double* hi_ptr) {
+    const csr_matrix_t* R = &work_ptr->rows;
+    double lo = 0.0;
+    double hi = 0.0;
+    for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+        uint32_t j = R->col_idx[k];
+        if (j == skip || !work_ptr->col_active[j]) {
+            continue;
+        }
+
+        double a = R->values[k];
+        lo += a > 0.0 ? a * work_ptr->lb[j] : a * work_ptr->ub[j];
+        hi += a > 0.0 ? a * work_ptr->ub[j] : a * work_ptr->lb[j];
+    }
+
+    *lo_ptr = lo;
+    *hi_ptr = hi;
+}
+
+// Removes column j at the given value, moving it into the right hand side
+uint32_t presolve_fix_column(presolve_t* presolve_ptr, presolve_work_t* work_ptr, uint32_t j, double value) {
+    const csc_matrix_t* A = work_ptr->A;
+    for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+        work_ptr->b[A->row_idx[k]] -= A->values[k] * value;
+    }
+
+    work_ptr->col_active[j] = 0;
+    work_ptr->lb[j] = value;
+    work_ptr->ub[j] = value;
+
+    presolve_op_t op = {0};
+    op.type = PRESOLVE_FIXED_COL;
+    op.col = j;
+    op.value = value;
+    return presolve_push_op(presolve_ptr, &op);
+}
+
+/* REDUCTIONS */
+// Each one returns the number of reductions found, or -1 on failure or infeasibility
+
+// Empty rows must have a zero right hand side, singleton rows fix their column
+int32_t presolve_reduce_rows(presolve_t* presolve_ptr, presolve_work_t* work_ptr) {
+    const csr_matrix_t* R = &work_ptr->rows;
+    int32_t changes = 0;
+    for (uint32_t i = 0; i < work_ptr->n; i++) {
+        if (!work_ptr->row_active[i]) {
+            continue;
+        }
+
+        uint32_t last = 0;
+        uint32_t length = presolve_row_length(work_ptr, i, &last);
+        if (length == 0) {
+            if (fabs(work_ptr->b[i]) > PRESOLVE_FEAS_TOL) {
+                fprintf(stderr, "Presolve: row %u has no variables left but a nonzero right hand side\n", i + 1);
+                return -1;
+            }
+            work_ptr->row_active[i] = 0;
+            changes++;
+        } else if (length == 1) {
+            uint32_t j = R->col_idx[last];
+            double value = work_ptr->b[i] / R->values[last];
+            if (value < work_ptr->lb[j] - PRESOLVE_FEAS_TOL || value > work_ptr->ub[j] + PRESOLVE_FEAS_TOL ||
+                (work_ptr->is_integer[j] && fabs(value - round(value)) > PRESOLVE_FEAS_TOL)) {
+                fprintf(stderr, "Presolve: row %u fixes x%u to an infeasible value\n", i + 1, j + 1);
+                return -1;
+            }
+            if (work_ptr->is_integer[j]) {
+                value = round(value);
+            }
+            value = fmin(fmax(value, work_ptr->lb[j]), work_ptr->ub[j]);
+
+            work_ptr->row_active[i] = 0;
+            if (!presolve_fix_column(presolve_ptr, work_ptr, j, value)) {
+                return -1;
+            }
+            changes++;
+        }
+    }
+
+    return changes;
+}
+
+// Checks whether row k is lambda times row i on the active columns
+uint32_t presolve_rows_parallel(const presolve_work_t* work_ptr, uint32_t i, uint32_t k, double* lambda_ptr) {
+    const csr_matrix_t* R = &work_ptr->rows;
+    uint32_t p = R->row_ptr[i];
+    uint32_t q = R->row_ptr[k];
+    double lambda = 0.0;
+    while (1) {
+        while (p < R->row_ptr[i + 1] && !work_ptr->col_active[R->col_idx[p]]) {
+            p++;
+        }
+        while (q < R->row_ptr[k + 1] && !work_ptr->col_active[R->col_idx[q]]) {
+            q++;
+        }
+
+        uint32_t end_i = p == R->row_ptr[i + 1];
+        uint32_t end_k = q == R->row_ptr[k + 1];
+        if (end_i || end_k) {
+            *lambda_ptr = lambda;
+            return end_i && end_k && lambda != 0.0;
+        }
+
+        if (R->col_idx[p] != R->col_idx[q]) {
+            return 0;
+        }
+
+        if (lambda == 0.0) {
+            lambda = R->values[q] / R->values[p];
+        } else if (fabs(R->values[q] - lambda * R->values[p]) > PRESOLVE_TOL * fabs(R->values[q])) {
+            return 0;
+        }
+        p++;
+        q++;
+    }
+}
+
+// A row parallel to another one is either redundant or makes the problem infeasible
+int32_t presolve_duplicate_rows(presolve_work_t* work_ptr) {
+    int32_t changes = 0;
+    for (uint32_t i = 0; i < work_ptr->n; i++) {
+        if (!work_ptr->row_active[i]) {
+            continue;
+        }
+
+        for (uint32_t k = i + 1; k < work_ptr->n; k++) {
+            double lambda;
+            if (!work_ptr->row_active[k] || !presolve_rows_parallel(work_ptr, i, k, &lambda)) {
+                continue;
+            }
+
+            if (fabs(work_ptr->b[k] - lambda * work_ptr->b[i]) > PRESOLVE_FEAS_TOL * (1.0 + fabs(work_ptr->b[k]))) {
+                fprintf(stderr, "Presolve: rows %u and %u are parallel with incompatible right hand sides\n", i + 1,
+                        k + 1);
+                return -1;
+            }
+            work_ptr->row_active[k] = 0;
+            changes++;
+        }
+    }
+
+    return changes;
+}
+
+// Fixed columns are removed, empty ones move to the bound their cost prefers
+int32_t presolve_reduce_columns(presolve_t* presolve_ptr, presolve_work_t* work_ptr) {
+    int32_t changes = 0;
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        if (!work_ptr->col_active[j]) {
+            continue;
+        }
+
+        uint32_t last = 0;
+        double value;
+        if (work_ptr->ub[j] - work_ptr->lb[j] <= PRESOLVE_TOL) {
+            value = work_ptr->lb[j];
+        } else if (presolve_col_length(work_ptr, j, &last) == 0) {
+            if (work_ptr->cost[j] >= -PRESOLVE_TOL) {
+                value = work_ptr->lb[j];
+            } else if (work_ptr->ub[j] < INFINITY) {
+                value = work_ptr->ub[j];
+            } else {
+                // Unbounded, left to the simplex to report
+                continue;
+            }
+        } else {
+            continue;
+        }
+
+        if (!presolve_fix_column(presolve_ptr, work_ptr, j, value)) {
+            return -1;
+        }
+        changes++;
+    }
+
+    return changes;
+}
+
+// A continuous column singleton whose bounds are implied by its row is free: the row defines it
+// and is removed together with it, after substituting it in the objective
+int32_t presolve_free_singletons(presolve_t* presolve_ptr, presolve_work_t* work_ptr) {
+    const csc_matrix_t* A = work_ptr->A;
+    const csr_matrix_t* R = &work_ptr->rows;
+    int32_t changes = 0;
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        uint32_t last = 0;
+        if (!work_ptr->col_active[j] || work_ptr->is_integer[j] || presolve_col_length(work_ptr, j, &last) != 1) {
+            continue;
+        }
+
+        uint32_t i = A->row_idx[last];
+        double a = A->values[last];
+        double lo, hi;
+        presolve_row_activity(work_ptr, i, j, &lo, &hi);
+
+        double x_min = a > 0.0 ? (work_ptr->b[i] - hi) / a : (work_ptr->b[i] - lo) / a;
+        double x_max = a > 0.0 ? (work_ptr->b[i] - lo) / a : (work_ptr->b[i] - hi) / a;
+        if (x_min < work_ptr->lb[j] - PRESOLVE_FEAS_TOL || x_max > work_ptr->ub[j] + PRESOLVE_FEAS_TOL) {
+            continue;
+        }
+
+        presolve_op_t op = {0};
+        op.type = PRESOLVE_FREE_COL_SINGLETON;
+        op.col = j;
+        op.value = a;
+        op.rhs = work_ptr->b[i];
+        op.start = presolve_ptr->entries_length;
+
+        // xj = (bi - sum aik * xk) / aij, so ck -= cj * aik / aij
+        for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+            uint32_t col = R->col_idx[k];
+            if (col == j || !work_ptr->col_active[col]) {
+                continue;
+            }
+
+            if (!presolve_push_entry(presolve_ptr, col, R->values[k])) {
+                return -1;
+            }
+            work_ptr->cost[col] -= work_ptr->cost[j] * R->values[k] / a;
+            op.length++;
+        }
+
+        if (!presolve_push_op(presolve_ptr, &op)) {
+            return -1;
+        }
+        work_ptr->row_active[i] = 0;
+        work_ptr->col_active[j] = 0;
+        changes++;
+    }
+
+    return changes;
+}
+
+// Checks whether column k is lambda times column j on the active rows
+uint32_t presolve_cols_parallel(const presolve_work_t* work_ptr, uint32_t j, uint32_t k, double* lambda_ptr) {
+    const csc_matrix_t* A = work_ptr->A;
+    uint32_t p = A->col_ptr[j];
+    uint32_t q = A->col_ptr[k];
+    double lambda = 0.0;
+    while (1) {
+        while (p < A->col_ptr[j + 1] && !work_ptr->row_active[A->row_idx[p]]) {
+            p++;
+        }
+        while (q < A->col_ptr[k + 1] && !work_ptr->row_active[A->row_idx[q]]) {
+            q++;
+        }
+
+        uint32_t end_j = p == A->col_ptr[j + 1];
+        uint32_t end_k = q == A->col_ptr[k + 1];
+        if (end_j || end_k) {
+            *lambda_ptr = lambda;
+            return end_j && end_k && lambda != 0.0;
+        }
+
+        if (A->row_idx[p] != A->row_idx[q]) {
+            return 0;
+        }
+
+        if (lambda == 0.0) {
+            lambda = A->values[q] / A->values[p];
+        } else if (fabs(A->values[q] - lambda * A->values[p]) > PRESOLVE_TOL * fabs(A->values[q])) {
+            return 0;
+        }
+        p++;
+        q++;
+    }
+}
+
+// Two continuous columns with Ak = lambda * Aj and ck = lambda * cj (lambda > 0) only matter through
+// xj + lambda * xk, so k is merged into j, whose bounds become the sum of the two
+int32_t presolve_duplicate_columns(presolve_t* presolve_ptr, presolve_work_t* work_ptr) {
+    int32_t changes = 0;
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        if (!work_ptr->col_active[j] || work_ptr->is_integer[j]) {
+            continue;
+        }
+
+        for (uint32_t k = j + 1; k < work_ptr->m; k++) {
+            double lambda;
+            if (!work_ptr->col_active[k] || work_ptr->is_integer[k] ||
+                !presolve_cols_parallel(work_ptr, j, k, &lambda) || lambda <= 0.0 ||
+                fabs(work_ptr->cost[k] - lambda * work_ptr->cost[j]) > PRESOLVE_TOL * (1.0 + fabs(work_ptr->cost[k]))) {
+                continue;
+            }
+
+            presolve_op_t op = {0};
+            op.type = PRESOLVE_DUPLICATE_COL;
+            op.col = k;
+            op.other = j;
+            op.value = lambda;
+            op.col_lb = work_ptr->lb[k];
+            op.other_lb = work_ptr->lb[j];
+            op.other_ub = work_ptr->ub[j];
+            if (!presolve_push_op(presolve_ptr, &op)) {
+                return -1;
+            }
+
+            work_ptr->lb[j] += lambda * work_ptr->lb[k];
+            work_ptr->ub[j] += lambda * work_ptr->ub[k];
+            work_ptr->col_active[k] = 0;
+            changes++;
+        }
+    }
+
+    return changes;
+}
+
+// Column singletons without an upper bound bound the duals of their rows (dk = ck - a * yi >= 0).
+// A column whose reduced cost keeps its sign over those bounds is dominated and sits on a bound.
+// The argument relies on LP duality, so it is skipped when there are integer columns
+int32_t presolve_dominated_columns(presolve_t* presolve_ptr, presolve_work_t* work_ptr) {
+    const csc_matrix_t* A = work_ptr->A;
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        if (work_ptr->is_integer[j]) {
+            return 0;
+        }
+    }
+
+    int32_t changes = -1;
+
+    double* y_lo = (double*)malloc(sizeof(double) * work_ptr->n);
+    double* y_hi = (double*)malloc(sizeof(double) * work_ptr->n);
+    if (!y_lo || !y_hi) {
+        fprintf(stderr, "Failed to allocate the dual bounds of presolve\n");
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < work_ptr->n; i++) {
+        y_lo[i] = -INFINITY;
+        y_hi[i] = INFINITY;
+    }
+
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        uint32_t last = 0;
+        if (!work_ptr->col_active[j] || work_ptr->ub[j] < INFINITY || presolve_col_length(work_ptr, j, &last) != 1) {
+            continue;
+        }
+
+        uint32_t i = A->row_idx[last];
+        double bound = work_ptr->cost[j] / A->values[last];
+        if (A->values[last] > 0.0) {
+            y_hi[i] = fmin(y_hi[i], bound);
+        } else {
+            y_lo[i] = fmax(y_lo[i], bound);
+        }
+    }
+
+    changes = 0;
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        if (!work_ptr->col_active[j]) {
+            continue;
+        }
+
+        // Range of y * Aj over the dual bounds
+        double dot_min = 0.0;
+        double dot_max = 0.0;
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            uint32_t i = A->row_idx[k];
+            if (!work_ptr->row_active[i]) {
+                continue;
+            }
+
+            double a = A->values[k];
+            dot_min += a > 0.0 ? a * y_lo[i] : a * y_hi[i];
+            dot_max += a > 0.0 ? a * y_hi[i] : a * y_lo[i];
+        }
+
+        double value;
+        if (work_ptr->cost[j] - dot_max > PRESOLVE_FEAS_TOL) {
+            value = work_ptr->lb[j];
+        } else if (work_ptr->cost[j] - dot_min < -PRESOLVE_FEAS_TOL && work_ptr->ub[j] < INFINITY) {
+            value = work_ptr->ub[j];
+        } else {
+            continue;
+        }
+
+        if (!presolve_fix_column(presolve_ptr, work_ptr, j, value)) {
+            changes = -1;
+            goto cleanup;
+        }
+        changes++;
+    }
+
+cleanup:
+    free(y_lo);
+    free(y_hi);
+    return changes;
+}
+
+// Rounds the bounds each row implies on its integer columns
+int32_t presolve_tighten_bounds(presolve_work_t* work_ptr) {
+    const csr_matrix_t* R = &work_ptr->rows;
+    int32_t changes = 0;
+    for (uint32_t i = 0; i < work_ptr->n; i++) {
+        if (!work_ptr->row_active[i]) {
+            continue;
+        }
+
+        for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+            uint32_t j = R->col_idx[k];
+            if (!work_ptr->col_active[j] || !work_ptr->is_integer[j]) {
+                continue;
+            }
+
+            double a = R->values[k];
+            double lo, hi;
+            presolve_row_activity(work_ptr, i, j, &lo, &hi);
+            double implied_lb = ceil((a > 0.0 ? (work_ptr->b[i] - hi) / a : (work_ptr->b[i] - lo) / a) -
+                                     PRESOLVE_FEAS_TOL);
+            double implied_ub = floor((a > 0.0 ? (work_ptr->b[i] - lo) / a : (work_ptr->b[i] - hi) / a) +
+                                      PRESOLVE_FEAS_TOL);
+
+            if (implied_lb > work_ptr->lb[j] + 0.5) {
+                work_ptr->lb[j] = implied_lb;
+                changes++;
+            }
+            if (implied_ub < work_ptr->ub[j] - 0.5) {
+                work_ptr->ub[j] = implied_ub;
+                changes++;
+            }
+            if (work_ptr->lb[j] > work_ptr->ub[j]) {
+                fprintf(stderr, "Presolve: row %u leaves no integer value for x%u\n", i + 1, j + 1);
+                return -1;
+            }
+        }
+    }
+
+    return changes;
+}
+
+/* PRESOLVE */
+
+// Builds the problem made of the active rows and columns
+uint32_t presolve_build(presolve_t* presolve_ptr, const presolve_work_t* work_ptr, const problem_t* problem_ptr,
+                        problem_t* reduced_ptr) {
+    uint32_t reduced_n = 0;
+    uint32_t reduced_m = 0;
+    for (uint32_t i = 0; i < work_ptr->n; i++) {
+        reduced_n += work_ptr->row_active[i];
+    }
+    for (uint32_t j = 0; j < work_ptr->m; j++) {
+        reduced_m += work_ptr->col_active[j];
+    }
+    presolve_ptr->reduced_n = reduced_n;
+    presolve_ptr->reduced_m = reduced_m;
+
+    memset(reduced_ptr, 0, sizeof(problem_t));
+
+    uint32_t ret = 1;
+    uint32_t* new_col = (uint32_t*)malloc(sizeof(uint32_t) * work_ptr->m);
+    uint32_t* row_cols = (uint32_t*)malloc(sizeof(uint32_t) * (work_ptr->m + 1));
+    double* row_values = (double*)malloc(sizeof(double) * (work_ptr->m + 1));
+    presolve_ptr->col_map = (uint32_t*)malloc(sizeof(uint32_t) * (reduced_m + 1));
+    csr_matrix_t rows = {0};
+    if (!new_col || !row_cols || !row_values || !presolve_ptr->col_map) {
+        goto fail;
+    }
+
+    for (uint32_t j = 0, jr = 0; j < work_ptr->m; j++) {
+        if (work_ptr->col_active[j]) {
+            presolve_ptr->col_map[jr] = j;
+            new_col[j] = jr++;
+        }
+    }
+
+    // Nothing left for the simplex
+    if (reduced_n == 0) {
+        goto cleanup;
+    }
+
+    // Same capacities as problem_from_stream, with room for the artificial variables of PhaseI
+    uint32_t variables_num = reduced_m + reduced_n;
+    uint32_t is_max = problem_is_max(problem_ptr);
+    reduced_ptr->n = reduced_n;
+    reduced_ptr->m = reduced_m;
+    reduced_ptr->is_max = is_max;
+    reduced_ptr->options = *problem_options(problem_ptr);
+    reduced_ptr->c = gsl_vector_calloc(variables_num);
+    reduced_ptr->b = gsl_vector_alloc(reduced_n);
+    if (!reduced_ptr->c || !reduced_ptr->b || !var_arr_init(&reduced_ptr->var_arr, variables_num) ||
+        !csr_init(&rows, reduced_m, reduced_n, csc_nnz(work_ptr->A))) {
+        goto fail;
+    }
+
+    for (uint32_t jr = 0; jr < reduced_m; jr++) {
+        uint32_t j = presolve_ptr->col_map[jr];
+        gsl_vector_set(reduced_ptr->c, jr, is_max ? -work_ptr->cost[j] : work_ptr->cost[j]);
+
+        variable_t v = *var_arr_get(problem_var_arr(problem_ptr), j);
+        v.lb = work_ptr->lb[j];
+        v.ub = work_ptr->ub[j] < INFINITY ? work_ptr->ub[j] : VARIABLE_INF;
+        if (!var_arr_push(&reduced_ptr->var_arr, &v)) {
+            goto fail;
+        }
+    }
+
+    const csr_matrix_t* R = &work_ptr->rows;
+    for (uint32_t i = 0, ir = 0; i < work_ptr->n; i++) {
+        if (!work_ptr->row_active[i]) {
+            continue;
+        }
+
+        uint32_t length = 0;
+        for (uint32_t k = R->row_ptr[i]; k < R->row_ptr[i + 1]; k++) {
+            if (work_ptr->col_active[R->col_idx[k]]) {
+                row_cols[length] = new_col[R->col_idx[k]];
+                row_values[length] = R->values[k];
+                length++;
+            }
+        }
+
+        if (!csr_push_row(&rows, row_cols, row_values, length)) {
+            goto fail;
+        }
+        gsl_vector_set(reduced_ptr->b, ir++, work_ptr->b[i]);
+    }
+
+    if (!csc_from_csr(&reduced_ptr->A, &rows, variables_num)) {
+        goto fail;
+    }
+
+    goto cleanup;
+
+fail:
+    fprintf(stderr, "Failed to build the presolved problem\n");
+    problem_free(reduced_ptr);
+    memset(reduced_ptr, 0, sizeof(problem_t));
+    ret = 0;
+cleanup:
+    free(new_col);
+    free(row_cols);
+    free(row_values);
+    csr_free(&rows);
+    return ret;
+}
+
+uint32_t presolve_run(presolve_t* presolve_ptr, const problem_t* problem_ptr, problem_t* reduced_ptr) {
+    if (!presolve_ptr || !problem_ptr || !reduced_ptr) {
+        fprintf(stderr, "Some arguments are NULL in presolve_run\n");
+        return 0;
+    }
+
+    memset(presolve_ptr, 0, sizeof(presolve_t));
+    presolve_ptr->n = problem_n(problem_ptr);
+    presolve_ptr->m = problem_m(problem_ptr);
+
+    uint32_t ret = 1;
+    presolve_work_t work = {0};
+    if (!presolve_work_init(&work, problem_ptr)) {
+        goto fail;
+    }
+
+    for (uint32_t pass = 0; pass < PRESOLVE_MAX_PASSES; pass++) {
+        int32_t found[] = {
+            presolve_reduce_rows(presolve_ptr, &work),
+            presolve_reduce_columns(presolve_ptr, &work),
+            presolve_free_singletons(presolve_ptr, &work),
+            presolve_duplicate_rows(&work),
+            presolve_duplicate_columns(presolve_ptr, &work),
+            presolve_dominated_columns(presolve_ptr, &work),
+            presolve_tighten_bounds(&work),
+        };
+
+        int32_t changes = 0;
+        for (uint32_t k = 0; k < sizeof(found) / sizeof(found[0]); k++) {
+            if (found[k] < 0) {
+                goto fail;
+            }
+            changes += found[k];
+        }
+
+        if (changes == 0) {
+            break;
+        }
+    }
+
+    if (!presolve_build(presolve_ptr, &work, problem_ptr, reduced_ptr)) {
+        goto fail;
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+    presolve_free(presolve_ptr);
+cleanup:
+    presolve_work_free(&work);
+    return ret;
+}
+
+uint32_t presolve_postsolve(const presolve_t* presolve_ptr, const problem_t* problem_ptr,
+                            const solution_t* reduced_solution_ptr, solution_t* solution_ptr) {
+    if (!presolve_ptr || !problem_ptr || !solution_ptr) {
+        fprintf(stderr, "Some arguments are NULL in presolve_postsolve\n");
+        return 0;
+    }
+
+    // Columns left without rows can only be there because they are unbounded
+    uint32_t is_unbounded = reduced_solution_ptr ? solution_is_unbounded(reduced_solution_ptr)
+                                                 : presolve_ptr->reduced_m > 0;
+
+    // Same layout as the solutions of the simplex, with room for the artificial variables
+    uint32_t n = presolve_ptr->n;
+    uint32_t m = presolve_ptr->m;
+    if (!solution_init(solution_ptr, n, m + n, is_unbounded)) {
+        return 0;
+    }
+
+    if (reduced_solution_ptr) {
+        solution_set_pI_iter(solution_ptr, solution_pI_iterations(reduced_solution_ptr));
+        solution_set_pII_iter(solution_ptr, solution_pII_iterations(reduced_solution_ptr));
+        solution_set_infeasible(solution_ptr, solution_is_infeasible(reduced_solution_ptr));
+    }
+
+    if (is_unbounded || solution_is_infeasible(solution_ptr)) {
+        return 1;
+    }
+
+    gsl_vector* x = solution_x_mut(solution_ptr);
+    if (reduced_solution_ptr) {
+        const gsl_vector* reduced_x = solution_x(reduced_solution_ptr);
+        for (uint32_t jr = 0; jr < presolve_ptr->reduced_m; jr++) {
+            gsl_vector_set(x, presolve_ptr->col_map[jr], gsl_vector_get(reduced_x, jr));
+        }
+    }
+
+    // Undo the reductions in reverse order, so that every column they read is already known
+    for (uint32_t t = presolve_ptr->ops_length; t-- > 0;) {
+        const presolve_op_t* op = &presolve_ptr->ops[t];
+        switch (op->type) {
+            case PRESOLVE_FIXED_COL: {
+                gsl_vector_set(x, op->col, op->value);
+                break;
+            }
+            case PRESOLVE_FREE_COL_SINGLETON: {
+                double rest = 0.0;
+                for (uint32_t k = op->start; k < op->start + op->length; k++) {
+                    rest += presolve_ptr->entry_values[k] * gsl_vector_get(x, presolve_ptr->entry_cols[k]);
+                }
+                gsl_vector_set(x, op->col, (op->rhs - rest) / op->value);
+                break;
+            }
+            case PRESOLVE_DUPLICATE_COL: {
+                // Split v = x_other + lambda * x_col, keeping x_col at its lower bound when possible
+                double v = gsl_vector_get(x, op->other);
+                double x_other = fmin(fmax(v - op->value * op->col_lb, op->other_lb), op->other_ub);
+                gsl_vector_set(x, op->other, x_other);
+                gsl_vector_set(x, op->col, (v - x_other) / op->value);
+                break;
+            }
+        }
+    }
+
+    // The objective is evaluated on the original costs, as extract_optimal does
+    const gsl_vector* c = problem_c(problem_ptr);
+    double z = 0.0;
+    for (uint32_t j = 0; j < m; j++) {
+        z += gsl_vector_get(c, j) * gsl_vector_get(x, j);
+    }
+    solution_set_z(solution_ptr, problem_is_max(problem_ptr) ? z : -z);
+
+    return 1;
+}
+
+void presolve_free(presolve_t* presolve_ptr) {
+    if (!presolve_ptr) {
+        return;
+    }
+
+    free(presolve_ptr->col_map);
+    free(presolve_ptr->ops);
+    free(presolve_ptr->entry_cols);
+    free(presolve_ptr->entry_values);
+    presolve_ptr->col_map = NULL;
+    presolve_ptr->ops = NULL;
+    presolve_ptr->entry_cols = NULL;
+    presolve_ptr->entry_values = NULL;
+    presolve_ptr->ops_length = 0;
+    presolve_ptr->entries_length = 0;
+}
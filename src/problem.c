@@ -1,6 +1,12 @@
 #include "problem.h"
 #include "utils.h"
 #include "simplex/primal.h"
+#include "simplex/crash.h"
+#include "simplex/dual.h"
+#include "simplex/warm.h"
+#include "presolve.h"
+#include "scaling.h"
+#include "ipm.h"
 #include "branch_bound/algorithm.h"
 
 #include <stdio.h>
@@ -39,17 +45,22 @@ gsl_vector* gsl_vector_from_stream(FILE* stream, char* name, uint32_t capacity,
     return v;
 }
 
-gsl_matrix* gsl_matrix_from_stream(FILE* stream, char* name, uint32_t row_capacity, uint32_t col_capacity,
-                                   uint32_t rows, uint32_t cols) {
+uint32_t csc_matrix_from_stream(csc_matrix_t* A_ptr, FILE* stream, char* name, uint32_t row_capacity,
+                                uint32_t col_capacity, uint32_t rows, uint32_t cols) {
     if (rows > row_capacity || cols > col_capacity) {
-        fprintf(stderr, "Requested size exceeds capacity in gsl_matrix_from_stream for %s\n", name);
-        return NULL;
+        fprintf(stderr, "Requested size exceeds capacity in csc_matrix_from_stream for %s\n", name);
+        return 0;
     }
 
-    gsl_matrix* m = gsl_matrix_calloc(row_capacity, col_capacity);
-    if (!m) {
-        fprintf(stderr, "Failed to allocate gsl_matrix %s in gsl_matrix_from_stream\n", name);
-        return NULL;
+    uint32_t ret = 1;
+
+    // The file is row major, so the rows are collected in CSR form and then transposed
+    csr_matrix_t rows_matrix = {0};
+    uint32_t* row_cols = (uint32_t*)malloc(sizeof(uint32_t) * (cols + 1));
+    double* row_values = (double*)malloc(sizeof(double) * (cols + 1));
+    if (!row_cols || !row_values || !csr_init(&rows_matrix, cols, rows, rows + cols)) {
+        fprintf(stderr, "Failed to allocate matrix %s in csc_matrix_from_stream\n", name);
+        goto fail;
     }
 
     if (stream == stdin) {
@@ -58,35 +69,74 @@ gsl_matrix* gsl_matrix_from_stream(FILE* stream, char* name, uint32_t row_capaci
     }
 
     for (uint32_t i = 0; i < rows; i++) {
+        uint32_t length = 0;
         for (uint32_t j = 0; j < cols; j++) {
-            if (fscanf(stream, "%lf", m->data + i * m->tda + j) != 1) {
-                fprintf(stderr, "Failed to read element (%u, %u) of gsl_matrix %s\n", i, j, name);
-                gsl_matrix_free(m);
-                return NULL;
+            double aij;
+            if (fscanf(stream, "%lf", &aij) != 1) {
+                fprintf(stderr, "Failed to read element (%u, %u) of matrix %s\n", i, j, name);
+                goto fail;
+            }
+            if (aij != 0.0) {
+                row_cols[length] = j;
+                row_values[length] = aij;
+                length++;
             }
         }
+
+        if (!csr_push_row(&rows_matrix, row_cols, row_values, length)) {
+            fprintf(stderr, "Failed to store row %u of matrix %s\n", i, name);
+            goto fail;
+        }
+    }
+
+    if (!csc_from_csr(A_ptr, &rows_matrix, col_capacity)) {
+        fprintf(stderr, "Failed to build matrix %s in csc_matrix_from_stream\n", name);
+        goto fail;
     }
 
-    return m;
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    csr_free(&rows_matrix);
+    free(row_cols);
+    free(row_values);
+    return ret;
 }
 
-void problem_make_RHS_positive(uint32_t n, gsl_matrix* A, gsl_vector* b) {
+void problem_make_RHS_positive(uint32_t n, csc_matrix_t* A, gsl_vector* b) {
+    gsl_vector* flip = gsl_vector_alloc(n);
+    if (!flip) {
+        return;
+    }
+
+    uint32_t any_negative = 0;
     for (uint32_t i = 0; i < n; i++) {
         double bi = gsl_vector_get(b, i);
         if (bi < 0.0) {
             // Flip bi
             gsl_vector_set(b, i, -bi);
-
-            // Flip row Ai
-            gsl_vector_view row = gsl_matrix_row(A, i);
-            gsl_vector_scale(&row.vector, -1.0);
+            gsl_vector_set(flip, i, -1.0);
+            any_negative = 1;
+        } else {
+            gsl_vector_set(flip, i, 1.0);
         }
     }
+
+    // Flip the rows Ai in a single pass over the nonzeros
+    if (any_negative) {
+        csc_scale_rows(A, flip);
+    }
+
+    gsl_vector_free(flip);
 }
 
-int32_t* problem_find_primal_base(uint32_t n, uint32_t m, uint32_t is_max, gsl_vector* c, gsl_matrix* A, gsl_vector* b,
-                                  var_arr_t* var_arr_ptr, uint32_t* iter_n_ptr) {
-    if (!c || !A || !b || !iter_n_ptr) {
+int32_t* problem_find_primal_base(uint32_t n, uint32_t m, csc_matrix_t* A, gsl_vector* b, var_arr_t* var_arr_ptr,
+                                  var_state_t* state, const options_t* opts_ptr, uint32_t* iter_n_ptr,
+                                  uint32_t* is_infeasible_ptr) {
+    *is_infeasible_ptr = 0;
+    if (!A || !b || !state || !iter_n_ptr) {
         fprintf(stderr, "Some arguments are NULL in problem_find_primal_base\n");
         return NULL;
     }
@@ -96,62 +146,48 @@ int32_t* problem_find_primal_base(uint32_t n, uint32_t m, uint32_t is_max, gsl_v
         return NULL;
     }
 
-    // Initialize basis indices to -1
-    for (uint32_t i = 0; i < n; i++) {
-        B[i] = -1;
-    }
-
-    // Check for identity
-    uint32_t n_indices_set = 0;
-    for (uint32_t j = 0; j < m; j++) {
-        int32_t pivot_row = -1;
-        uint32_t valid = 1;
-        for (uint32_t i = 0; valid && i < n; i++) {
-            double aij = gsl_matrix_get(A, i, j);
-            if (aij == 1.0) {
-                if (pivot_row == -1) {
-                    pivot_row = (int32_t)i;
-                } else {
-                    valid = 0;
-                }
-            } else if (aij != 0.0) {
-                valid = 0;
-            }
-        }
-        if (valid && pivot_row != -1 && B[pivot_row] == -1) {
-            B[pivot_row] = j;
-            n_indices_set++;
-        }
-    }
+    // Triangular crash, the rows it cannot cover get an artificial variable (B[i] = -1)
+    uint32_t n_indices_set = crash_basis(n, m, A, b, var_arr_ptr, B);
 
-    // If the B array of indices has been filled
+    // If the B array of indices has been filled, the crash basis is already feasible
     if (n_indices_set == n) {
+        for (uint32_t j = 0; j < m; j++) {
+            state[j] = VAR_STATE_LOWER;
+        }
         return B;
     }
 
-    memset(B, 0, sizeof(int32_t) * n);
-
-    if (!simplex_primal_phaseI(n, m, is_max, c, A, b, B, var_arr_ptr, iter_n_ptr)) {
+    if (!simplex_primal_phaseI(n, m, A, b, B, var_arr_ptr, state, opts_ptr, iter_n_ptr, is_infeasible_ptr)) {
         fprintf(stderr, "Failed to find initial primal feasible base with PhaseI\n");
+        free(B);
+        return NULL;
+    }
+    if (*is_infeasible_ptr) {
+        free(B);
+        return NULL;
     }
 
     return B;
 }
 
-uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream) {
+uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream, const options_t* opts_ptr) {
     if (!problem_ptr || !stream) {
         return 0;
     }
 
+    if (opts_ptr) {
+        problem_ptr->options = *opts_ptr;
+    } else {
+        options_init(&problem_ptr->options);
+    }
+
     uint32_t n;
     uint32_t m;
     uint32_t is_max;
     gsl_vector* c = NULL;
-    gsl_matrix* A = NULL;
+    csc_matrix_t A = {0};
     gsl_vector* b = NULL;
     var_arr_t var_arr = {0};
-    int32_t* B = NULL;
-    int32_t* N = NULL;
 
     if (stream == stdin) {
         printf("n: ");
@@ -191,8 +227,7 @@ uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream) {
         goto fail;
     }
 
-    A = gsl_matrix_from_stream(stream, "A", constraints_num, variables_num, n, m);
-    if (!A) {
+    if (!csc_matrix_from_stream(&A, stream, "A", constraints_num, variables_num, n, m)) {
         goto fail;
     }
 
@@ -211,24 +246,14 @@ uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream) {
     problem_ptr->c = c;
     problem_ptr->A = A;
     problem_ptr->b = b;
+    problem_ptr->B = NULL;
+    problem_ptr->N = NULL;
+    problem_ptr->state = NULL;
+    problem_ptr->start = NULL;
+    problem_ptr->is_dual_start = 0;
     problem_ptr->var_arr = var_arr;
     problem_ptr->pI_iter = 0;
 
-    problem_make_RHS_positive(n, A, b);
-
-    B = problem_find_primal_base(n, m, is_max, c, A, b, &var_arr, &problem_ptr->pI_iter);
-    if (!B) {
-        goto fail;
-    }
-
-    N = calculate_nonbasis(B, n, m + n);
-    if (!N) {
-        goto fail;
-    }
-
-    problem_ptr->B = B;
-    problem_ptr->N = N;
-
     if (stream != stdin) {
         fclose(stream);
     }
@@ -237,11 +262,9 @@ uint32_t problem_from_stream(problem_t* problem_ptr, FILE* stream) {
 
 fail:
     gsl_vector_free(c);
-    gsl_matrix_free(A);
+    csc_free(&A);
     gsl_vector_free(b);
     var_arr_free(&var_arr);
-    free(B);
-    free(N);
     if (stream != stdin) {
         fclose(stream);
     }
@@ -289,12 +312,12 @@ void problem_print(const problem_t* problem_ptr, const char* name) {
     printf("\n\nconstraints:\n");
 
     // Constraints
-    const gsl_matrix* A = problem_ptr->A;
+    const csc_matrix_t* A = &problem_ptr->A;
     const gsl_vector* b = problem_ptr->b;
     for (uint32_t i = 0; i < problem_ptr->n; i++) {
         printf("\t");
         for (uint32_t j = 0; j < problem_ptr->m; j++) {
-            double aij = gsl_matrix_get(A, i, j);
+            double aij = csc_get(A, i, j);
             print_coefficient(aij, j, j == 0);
         }
 
@@ -333,46 +356,352 @@ uint32_t problem_is_milp(const problem_t* problem_ptr) {
     return 0;
 }
 
-uint32_t problem_solve(problem_t* problem_ptr, solution_t* solution_ptr) {
-    if (!problem_ptr || !solution_ptr) {
-        fprintf(stderr, "Some arguments are NULL in problem_solve\n");
+uint32_t problem_prepare(problem_t* problem_ptr) {
+    if (!problem_ptr) {
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+
+    problem_make_RHS_positive(n, &problem_ptr->A, problem_ptr->b);
+    problem_ptr->is_infeasible = 0;
+
+    problem_ptr->state = (var_state_t*)calloc(m + n, sizeof(var_state_t));
+    if (!problem_ptr->state) {
+        return 0;
+    }
+
+    // A warm start basis replaces the crash and PhaseI when it can be repaired into a feasible one
+    if (problem_ptr->start) {
+        problem_ptr->B = (int32_t*)malloc(sizeof(int32_t) * n);
+        if (!problem_ptr->B) {
+            return 0;
+        }
+
+        warm_start_t start = warm_start(n, m, problem_ptr->is_max, problem_ptr->c, &problem_ptr->A, problem_ptr->b,
+                                        &problem_ptr->var_arr, problem_ptr->start, !problem_is_milp(problem_ptr),
+                                        &problem_ptr->options, problem_ptr->B, problem_ptr->state);
+        if (start == WARM_START_PRIMAL || start == WARM_START_DUAL) {
+            printf("\nWarm start from a %s feasible basis\n", start == WARM_START_PRIMAL ? "primal" : "dual");
+            problem_ptr->is_dual_start = start == WARM_START_DUAL;
+            problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, m + n);
+            return problem_ptr->N != NULL;
+        }
+
+        if (start == WARM_START_PHASE_I) {
+            uint32_t swapped_n = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                swapped_n += problem_ptr->B[i] < 0;
+            }
+            printf("\nWarm start with PhaseI on the %u rows swapped to an artificial variable\n", swapped_n);
+
+            if (!simplex_primal_phaseI(n, m, &problem_ptr->A, problem_ptr->b, problem_ptr->B, &problem_ptr->var_arr,
+                                       problem_ptr->state, &problem_ptr->options, &problem_ptr->pI_iter,
+                                       &problem_ptr->is_infeasible)) {
+                fprintf(stderr, "Failed to find initial primal feasible base with PhaseI\n");
+                return 0;
+            }
+            if (problem_ptr->is_infeasible) {
+                return 0;
+            }
+            problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, m + n);
+            return problem_ptr->N != NULL && problem_fix_artificials(problem_ptr);
+        }
+
+        printf("\nThe warm start basis cannot be used, falling back to the crash and PhaseI\n");
+        free(problem_ptr->B);
+        problem_ptr->B = NULL;
+    }
+
+    problem_ptr->B = problem_find_primal_base(n, m, &problem_ptr->A, problem_ptr->b, &problem_ptr->var_arr,
+                                              problem_ptr->state, &problem_ptr->options, &problem_ptr->pI_iter,
+                                              &problem_ptr->is_infeasible);
+    if (!problem_ptr->B) {
+        return 0;
+    }
+
+    // PhaseI leaves an artificial variable basic on a redundant row, which must stay in the m columns of the LP
+    problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, m + n);
+    return problem_ptr->N != NULL && problem_fix_artificials(problem_ptr);
+}
+
+uint32_t problem_fix_artificials(problem_t* problem_ptr) {
+    if (!problem_ptr || !problem_ptr->B || !problem_ptr->state) {
+        return 0;
+    }
+
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    csc_matrix_t* A = &problem_ptr->A;
+
+    // Artificial columns are unit columns, so each is kept as its row and sign
+    uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * n);
+    double* signs = (double*)malloc(sizeof(double) * n);
+    if (!rows || !signs) {
+        free(rows);
+        free(signs);
+        return 0;
+    }
+
+    uint32_t fixed_n = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = (uint32_t)problem_ptr->B[i];
+        if (j >= m) {
+            rows[fixed_n] = A->row_idx[A->col_ptr[j]];
+            signs[fixed_n++] = A->values[A->col_ptr[j]];
+        }
+    }
+    // PhaseI appended the artificial variables past the m columns as well
+    csc_truncate(A, n, m);
+    problem_ptr->var_arr.length = m;
+
+    uint32_t ret = 1;
+    for (uint32_t i = 0, k = 0; i < n && ret; i++) {
+        if ((uint32_t)problem_ptr->B[i] < m) {
+            continue;
+        }
+
+        variable_t fixed;
+        variable_init(&fixed, 0.0, 0.0, VAR_REAL);
+        ret = csc_push_column(A, &rows[k], &signs[k], 1) && var_arr_push(&problem_ptr->var_arr, &fixed);
+        gsl_vector_set(problem_ptr->c, m + k, 0.0);
+        problem_ptr->state[m + k] = VAR_STATE_BASIC;
+        problem_ptr->B[i] = (int32_t)(m + k++);
+    }
+    free(rows);
+    free(signs);
+
+    if (ret && fixed_n > 0) {
+        problem_ptr->m = m + fixed_n;
+        free(problem_ptr->N);
+        problem_ptr->N = calculate_nonbasis(problem_ptr->B, n, problem_ptr->m + n);
+        ret = problem_ptr->N != NULL;
+    }
+
+    return ret;
+}
+
+// Solves the LP relaxation with the interior point method and makes the basis found by the crossover
+// the warm start basis. If the method does not converge the crash and PhaseI are used instead
+uint32_t problem_barrier_start(problem_t* problem_ptr) {
+    uint32_t ret = 1;
+    uint32_t m = problem_ptr->m;
+    uint32_t iter_n = 0;
+    gsl_vector* x = gsl_vector_alloc(m);
+    gsl_vector* zl = gsl_vector_alloc(m);
+    gsl_vector* zu = gsl_vector_alloc(m);
+    var_state_t* start = (var_state_t*)malloc(sizeof(var_state_t) * m);
+    if (!x || !zl || !zu || !start) {
+        fprintf(stderr, "Failed to allocate the interior point solution\n");
+        goto fail;
+    }
+
+    if (!ipm_solve(problem_ptr, x, zl, zu, &iter_n)) {
+        printf("\nThe interior point method did not converge in %u iterations, falling back to the simplex\n", iter_n);
+        goto cleanup;
+    }
+    printf("\nInterior point method converged in %u iterations\n", iter_n);
+
+    if (!ipm_crossover(problem_ptr, x, zl, zu, start)) {
+        goto fail;
+    }
+    problem_ptr->start = start;
+    start = NULL;
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    gsl_vector_free(x);
+    gsl_vector_free(zl);
+    gsl_vector_free(zu);
+    free(start);
+    return ret;
+}
+
+void problem_drop_artificials(problem_t* problem_ptr, uint32_t model_m) {
+    if (problem_ptr->m == model_m) {
+        return;
+    }
+
+    csc_truncate(&problem_ptr->A, problem_ptr->n, model_m);
+    problem_ptr->var_arr.length = model_m;
+    problem_ptr->m = model_m;
+}
+
+// Solves the problem as it is, without presolve
+uint32_t problem_optimize(problem_t* problem_ptr, solution_t* solution_ptr) {
+    scaling_t scaling = {0};
+    uint32_t is_scaled = problem_ptr->options.scaling;
+    if (is_scaled && !scaling_apply(&scaling, problem_ptr)) {
         return 0;
     }
 
+    uint32_t res = 0;
+    uint32_t model_m = problem_ptr->m;
+    if (problem_ptr->options.barrier && !problem_ptr->start && !problem_barrier_start(problem_ptr)) {
+        goto cleanup;
+    }
+    // A problem without a feasible basis is solved, its solution reports it infeasible
+    if (!problem_prepare(problem_ptr)) {
+        res = problem_ptr->is_infeasible && solution_init(solution_ptr, problem_ptr->n, model_m + problem_ptr->n, 0) &&
+              solution_set_infeasible(solution_ptr, 1) && solution_set_pI_iter(solution_ptr, problem_ptr->pI_iter);
+        goto cleanup;
+    }
+
     // Solve with B&B
     if (problem_is_milp(problem_ptr)) {
-        return branch_and_bound(problem_ptr, solution_ptr);
+        res = branch_and_bound(problem_ptr, solution_ptr);
+        goto cleanup;
     }
 
-    // Solve with Primal Simplex
+    // Solve with Primal Simplex, or with the dual one from a dual feasible warm start
+    solve_fn solver = problem_ptr->is_dual_start ? simplex_dual : simplex_primal;
     uint32_t n = problem_ptr->n;
     uint32_t m = problem_ptr->m;
     uint32_t is_max = problem_ptr->is_max;
 
     gsl_vector_view c = gsl_vector_subvector(problem_ptr->c, 0, m);
-    gsl_matrix_view A = gsl_matrix_submatrix(problem_ptr->A, 0, 0, n, m);
     gsl_vector_view b = gsl_vector_subvector(problem_ptr->b, 0, n);
 
     uint32_t iter_n = 0;
-    uint32_t res = simplex_primal(n, m, is_max, &c.vector, &A.matrix, &b.vector, problem_ptr->B, problem_ptr->N,
-                                  solution_ptr, &iter_n);
+    res = solver(n, m, is_max, &c.vector, &problem_ptr->A, &b.vector, &problem_ptr->var_arr, problem_ptr->B,
+                 problem_ptr->N, problem_ptr->state, &problem_ptr->options, NULL, solution_ptr, &iter_n);
+
+    // The dual simplex is unbounded when the primal is infeasible
+    if (res && solver == simplex_dual && solution_ptr->is_unbounded) {
+        solution_ptr->is_unbounded = 0;
+        solution_set_infeasible(solution_ptr, 1);
+    }
 
     solution_set_pI_iter(solution_ptr, problem_ptr->pI_iter);
     solution_set_pII_iter(solution_ptr, iter_n);
 
+cleanup:
+    // The fixed columns are always 0, so the solution only loses their entries
+    problem_drop_artificials(problem_ptr, model_m);
+    if (res) {
+        res = solution_truncate(solution_ptr, model_m + problem_ptr->n);
+    }
+    if (res && is_scaled && !solution_is_infeasible(solution_ptr)) {
+        scaling_unscale_solution(&scaling, solution_ptr);
+    }
+    scaling_free(&scaling);
     return res;
 }
 
+// Reads the basis file of the options into target_ptr, the problem that is going to be optimized.
+// col_map maps its columns to the ones of problem_ptr (NULL if they are the same).
+// A basis file that cannot be read only disables the warm start
+uint32_t problem_load_basis(const problem_t* problem_ptr, problem_t* target_ptr, const uint32_t* col_map) {
+    const char* filename = problem_ptr->options.basis_in;
+    if (!filename) {
+        return 1;
+    }
+
+    var_state_t* start = (var_state_t*)malloc(sizeof(var_state_t) * problem_ptr->m);
+    if (!start) {
+        return 0;
+    }
+    if (!basis_read(filename, problem_ptr->n, problem_ptr->m, start)) {
+        fprintf(stderr, "Ignoring basis file %s\n", filename);
+        free(start);
+        return 1;
+    }
+
+    target_ptr->start = (var_state_t*)malloc(sizeof(var_state_t) * (target_ptr->m ? target_ptr->m : 1));
+    if (!target_ptr->start) {
+        free(start);
+        return 0;
+    }
+    for (uint32_t j = 0; j < target_ptr->m; j++) {
+        target_ptr->start[j] = start[col_map ? col_map[j] : j];
+    }
+
+    free(start);
+    return 1;
+}
+
+// Writes the basis of solved_ptr to the basis file of the options in the columns of problem_ptr.
+// Columns removed by presolve are saved as nonbasic at their lower bound
+uint32_t problem_save_basis(const problem_t* problem_ptr, const problem_t* solved_ptr, const uint32_t* col_map) {
+    // An infeasible problem has no basis worth saving
+    const char* filename = problem_ptr->options.basis_out;
+    if (!filename || solved_ptr->is_infeasible) {
+        return 1;
+    }
+
+    var_state_t* state = (var_state_t*)calloc(problem_ptr->m, sizeof(var_state_t));
+    if (!state) {
+        return 0;
+    }
+    for (uint32_t j = 0; solved_ptr->state && j < solved_ptr->m; j++) {
+        state[col_map ? col_map[j] : j] = solved_ptr->state[j];
+    }
+
+    uint32_t ret = basis_write(filename, problem_ptr->n, problem_ptr->m, state);
+    if (!ret) {
+        fprintf(stderr, "Failed to save the basis to %s\n", filename);
+    }
+
+    free(state);
+    return ret;
+}
+
+uint32_t problem_solve(problem_t* problem_ptr, solution_t* solution_ptr) {
+    if (!problem_ptr || !solution_ptr) {
+        fprintf(stderr, "Some arguments are NULL in problem_solve\n");
+        return 0;
+    }
+
+    if (!problem_ptr->options.presolve) {
+        return problem_load_basis(problem_ptr, problem_ptr, NULL) && problem_optimize(problem_ptr, solution_ptr) &&
+               problem_save_basis(problem_ptr, problem_ptr, NULL);
+    }
+
+    presolve_t presolve = {0};
+    problem_t reduced = {0};
+    if (!presolve_run(&presolve, problem_ptr, &reduced)) {
+        fprintf(stderr, "Presolve failed\n");
+        return 0;
+    }
+
+    printf("\nPresolve removed %u of %u rows and %u of %u columns\n", presolve.n - presolve.reduced_n, presolve.n,
+           presolve.m - presolve.reduced_m, presolve.m);
+
+    // Without rows left there is nothing for the simplex to do
+    uint32_t ret = 1;
+    solution_t reduced_solution = {0};
+    if (presolve.reduced_n == 0) {
+        ret = presolve_postsolve(&presolve, problem_ptr, NULL, solution_ptr) &&
+              problem_save_basis(problem_ptr, &reduced, presolve.col_map);
+    } else {
+        ret = problem_load_basis(problem_ptr, &reduced, presolve.col_map) &&
+              problem_optimize(&reduced, &reduced_solution) &&
+              presolve_postsolve(&presolve, problem_ptr, &reduced_solution, solution_ptr) &&
+              problem_save_basis(problem_ptr, &reduced, presolve.col_map);
+    }
+
+    solution_free(&reduced_solution);
+    problem_free(&reduced);
+    presolve_free(&presolve);
+    return ret;
+}
+
 void problem_free(problem_t* problem_ptr) {
     if (!problem_ptr) {
         return;
     }
 
     gsl_vector_free(problem_ptr->c);
-    gsl_matrix_free(problem_ptr->A);
+    csc_free(&problem_ptr->A);
     gsl_vector_free(problem_ptr->b);
     free(problem_ptr->B);
     free(problem_ptr->N);
+    free(problem_ptr->state);
+    free(problem_ptr->start);
     var_arr_free(&problem_ptr->var_arr);
 }
 
@@ -398,12 +727,12 @@ gsl_vector* problem_c_mut(problem_t* problem_ptr) {
     return problem_ptr ? problem_ptr->c : NULL;
 }
 
-const gsl_matrix* problem_A(const problem_t* problem_ptr) {
-    return problem_ptr ? problem_ptr->A : NULL;
+const csc_matrix_t* problem_A(const problem_t* problem_ptr) {
+    return problem_ptr ? &problem_ptr->A : NULL;
 }
 
-gsl_matrix* problem_A_mut(problem_t* problem_ptr) {
-    return problem_ptr ? problem_ptr->A : NULL;
+csc_matrix_t* problem_A_mut(problem_t* problem_ptr) {
+    return problem_ptr ? &problem_ptr->A : NULL;
 }
 
 const gsl_vector* problem_b(const problem_t* problem_ptr) {
@@ -430,6 +759,14 @@ int32_t* problem_N_mut(problem_t* problem_ptr) {
     return problem_ptr ? problem_ptr->N : NULL;
 }
 
+const var_state_t* problem_state(const problem_t* problem_ptr) {
+    return problem_ptr ? problem_ptr->state : NULL;
+}
+
+var_state_t* problem_state_mut(problem_t* problem_ptr) {
+    return problem_ptr ? problem_ptr->state : NULL;
+}
+
 uint32_t problem_pI_iter(const problem_t* problem_ptr) {
     return problem_ptr ? problem_ptr->pI_iter : 0;
 }
@@ -442,6 +779,10 @@ var_arr_t* problem_var_arr_mut(problem_t* problem_ptr) {
     return problem_ptr ? &problem_ptr->var_arr : NULL;
 }
 
+const options_t* problem_options(const problem_t* problem_ptr) {
+    return problem_ptr ? &problem_ptr->options : NULL;
+}
+
 /* SETTERS */
 uint32_t problem_set_pI_iter(problem_t* problem_ptr, uint32_t pI_iter) {
     if (!problem_ptr) {
@@ -0,0 +1,204 @@
+#include "scaling.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Power of 2 nearest to v (in log scale)
+double scaling_round(double v) {
+    return ldexp(1.0, (int)lround(log2(v)));
+}
+
+// Spread max|a_ij| / min|a_ij| of the entries of A scaled by R and S
+double scaling_spread(const csc_matrix_t* A, uint32_t m, const gsl_vector* R, const gsl_vector* S) {
+    double a_min = INFINITY;
+    double a_max = 0.0;
+    for (uint32_t j = 0; j < m; j++) {
+        double sj = gsl_vector_get(S, j);
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            double a = fabs(A->values[k]) * gsl_vector_get(R, A->row_idx[k]) * sj;
+            if (a > 0.0) {
+                a_min = fmin(a_min, a);
+                a_max = fmax(a_max, a);
+            }
+        }
+    }
+
+    return a_max > 0.0 ? a_max / a_min : 1.0;
+}
+
+// One geometric mean pass: every row, then every scalable column, is divided by
+// sqrt(min|a| * max|a|) of its currently scaled entries
+void scaling_geometric_pass(const csc_matrix_t* A, uint32_t n, uint32_t m, const uint32_t* is_fixed, double* row_min,
+                            double* row_max, gsl_vector* R, gsl_vector* S) {
+    for (uint32_t i = 0; i < n; i++) {
+        row_min[i] = INFINITY;
+        row_max[i] = 0.0;
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+        double sj = gsl_vector_get(S, j);
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            uint32_t i = A->row_idx[k];
+            double a = fabs(A->values[k]) * sj;
+            if (a > 0.0) {
+                row_min[i] = fmin(row_min[i], a);
+                row_max[i] = fmax(row_max[i], a);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(R, i, row_max[i] > 0.0 ? 1.0 / sqrt(row_min[i] * row_max[i]) : 1.0);
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+        if (is_fixed[j]) {
+            continue;
+        }
+
+        double col_min = INFINITY;
+        double col_max = 0.0;
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            double a = fabs(A->values[k]) * gsl_vector_get(R, A->row_idx[k]);
+            if (a > 0.0) {
+                col_min = fmin(col_min, a);
+                col_max = fmax(col_max, a);
+            }
+        }
+
+        gsl_vector_set(S, j, col_max > 0.0 ? 1.0 / sqrt(col_min * col_max) : 1.0);
+    }
+}
+
+uint32_t scaling_apply(scaling_t* scaling_ptr, problem_t* problem_ptr) {
+    if (!scaling_ptr || !problem_ptr) {
+        fprintf(stderr, "Some arguments are NULL in scaling_apply\n");
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t n = problem_ptr->n;
+    uint32_t m = problem_ptr->m;
+    csc_matrix_t* A = &problem_ptr->A;
+    var_arr_t* var_arr_ptr = &problem_ptr->var_arr;
+
+    scaling_ptr->n = n;
+    scaling_ptr->m = m;
+    scaling_ptr->row_scale = gsl_vector_alloc(n);
+    scaling_ptr->col_scale = gsl_vector_alloc(m);
+    uint32_t* is_fixed = (uint32_t*)malloc(sizeof(uint32_t) * m);
+    double* row_min = (double*)malloc(sizeof(double) * n);
+    double* row_max = (double*)malloc(sizeof(double) * n);
+    gsl_vector* R_prev = gsl_vector_alloc(n);
+    gsl_vector* S_prev = gsl_vector_alloc(m);
+    if (!scaling_ptr->row_scale || !scaling_ptr->col_scale || !is_fixed || !row_min || !row_max || !R_prev ||
+        !S_prev) {
+        fprintf(stderr, "Failed to allocate the scaling factors\n");
+        goto fail;
+    }
+
+    gsl_vector* R = scaling_ptr->row_scale;
+    gsl_vector* S = scaling_ptr->col_scale;
+    gsl_vector_set_all(R, 1.0);
+    gsl_vector_set_all(S, 1.0);
+
+    // Scaling an integer column would make its values fractional
+    for (uint32_t j = 0; j < m; j++) {
+        const variable_t* v = var_arr_get(var_arr_ptr, j);
+        is_fixed[j] = !variable_is_real(v);
+    }
+
+    double spread = scaling_spread(A, m, R, S);
+    for (uint32_t pass = 0; pass < SCALING_MAX_PASSES && spread > 1.0; pass++) {
+        gsl_vector_memcpy(R_prev, R);
+        gsl_vector_memcpy(S_prev, S);
+        scaling_geometric_pass(A, n, m, is_fixed, row_min, row_max, R, S);
+
+        // A pass that makes the spread worse is undone, one that barely helps is the last
+        double new_spread = scaling_spread(A, m, R, S);
+        if (new_spread >= spread) {
+            gsl_vector_memcpy(R, R_prev);
+            gsl_vector_memcpy(S, S_prev);
+            break;
+        }
+        if (new_spread > SCALING_MIN_IMPROVEMENT * spread) {
+            break;
+        }
+        spread = new_spread;
+    }
+
+    // Equilibrate the columns on top of the rounded row factors
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(R, i, scaling_round(gsl_vector_get(R, i)));
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        if (is_fixed[j]) {
+            continue;
+        }
+
+        double col_max = 0.0;
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            col_max = fmax(col_max, fabs(A->values[k]) * gsl_vector_get(R, A->row_idx[k]));
+        }
+        gsl_vector_set(S, j, col_max > 0.0 ? scaling_round(1.0 / col_max) : 1.0);
+    }
+
+    // A' = R * A * S, b' = R * b, c' = S * c, bounds of x' = S^-1 * x
+    csc_scale_rows(A, R);
+    for (uint32_t j = 0; j < m; j++) {
+        double sj = gsl_vector_get(S, j);
+        if (sj == 1.0) {
+            continue;
+        }
+
+        for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            A->values[k] *= sj;
+        }
+        gsl_vector_set(problem_ptr->c, j, gsl_vector_get(problem_ptr->c, j) * sj);
+
+        variable_t* v = (variable_t*)var_arr_get(var_arr_ptr, j);
+        v->lb /= sj;
+        if (v->ub < VARIABLE_INF) {
+            v->ub /= sj;
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(problem_ptr->b, i, gsl_vector_get(problem_ptr->b, i) * gsl_vector_get(R, i));
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    free(is_fixed);
+    free(row_min);
+    free(row_max);
+    gsl_vector_free(R_prev);
+    gsl_vector_free(S_prev);
+    return ret;
+}
+
+void scaling_unscale_solution(const scaling_t* scaling_ptr, solution_t* solution_ptr) {
+    if (!scaling_ptr || !solution_ptr || !solution_ptr->x) {
+        return;
+    }
+
+    // x = S * x', z is invariant since c' * x' = c * S * S^-1 * x
+    for (uint32_t j = 0; j < scaling_ptr->m && j < solution_ptr->x->size; j++) {
+        double xj = gsl_vector_get(solution_ptr->x, j);
+        gsl_vector_set(solution_ptr->x, j, xj * gsl_vector_get(scaling_ptr->col_scale, j));
+    }
+}
+
+void scaling_free(scaling_t* scaling_ptr) {
+    if (!scaling_ptr) {
+        return;
+    }
+
+    gsl_vector_free(scaling_ptr->row_scale);
+    gsl_vector_free(scaling_ptr->col_scale);
+    scaling_ptr->row_scale = NULL;
+    scaling_ptr->col_scale = NULL;
+}
@@ -0,0 +1,387 @@
+#include "simplex/basis.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gsl/gsl_linalg.h>
+
+#define SINGULAR_TOL 1e-11
+#define ETA_PIVOT_TOL 1e-9
+#define ETA_DROP_TOL 1e-14
+
+uint32_t basis_factor_init(basis_factor_t* factor_ptr, uint32_t capacity, uint32_t refactor_period) {
+    if (!factor_ptr || capacity == 0 || refactor_period == 0) {
+        return 0;
+    }
+
+    factor_ptr->capacity = capacity;
+    factor_ptr->refactor_period = refactor_period;
+
+    factor_ptr->LU_block = gsl_matrix_alloc(capacity, capacity);
+    factor_ptr->perm_block = gsl_permutation_alloc(capacity);
+    factor_ptr->etas = (eta_t*)malloc(sizeof(eta_t) * refactor_period);
+    factor_ptr->eta_indices = (uint32_t*)malloc(sizeof(uint32_t) * refactor_period * capacity);
+    factor_ptr->eta_values = (double*)malloc(sizeof(double) * refactor_period * capacity);
+    factor_ptr->work = (double*)malloc(sizeof(double) * capacity);
+    factor_ptr->U_diag = (double*)malloc(sizeof(double) * capacity);
+    factor_ptr->rhs = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    factor_ptr->pattern = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    factor_ptr->stack = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    factor_ptr->next = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    factor_ptr->mark = (uint8_t*)calloc(capacity, sizeof(uint8_t));
+    uint32_t is_sparse_ok = csc_init(&factor_ptr->L, capacity, capacity, capacity);
+    is_sparse_ok &= csc_init(&factor_ptr->U, capacity, capacity, capacity);
+    is_sparse_ok &= csc_init(&factor_ptr->Lt, capacity, capacity, capacity);
+    is_sparse_ok &= csc_init(&factor_ptr->Ut, capacity, capacity, capacity);
+
+    if (!factor_ptr->LU_block || !factor_ptr->perm_block || !factor_ptr->etas || !factor_ptr->eta_indices ||
+        !factor_ptr->eta_values || !factor_ptr->work || !factor_ptr->U_diag || !factor_ptr->rhs ||
+        !factor_ptr->pattern || !factor_ptr->stack || !factor_ptr->next || !factor_ptr->mark || !is_sparse_ok) {
+        fprintf(stderr, "Failed to allocate basis factorization\n");
+        basis_factor_free(factor_ptr);
+        return 0;
+    }
+
+    return basis_factor_resize(factor_ptr, capacity);
+}
+
+uint32_t basis_factor_resize(basis_factor_t* factor_ptr, uint32_t n) {
+    if (!factor_ptr || n == 0 || n > factor_ptr->capacity) {
+        fprintf(stderr, "Basis of size %u does not fit the factorization buffers\n", n);
+        return 0;
+    }
+
+    factor_ptr->n = n;
+    factor_ptr->LU = gsl_matrix_submatrix(factor_ptr->LU_block, 0, 0, n, n);
+    factor_ptr->perm.size = n;
+    factor_ptr->perm.data = factor_ptr->perm_block->data;
+    factor_ptr->eta_n = 0;
+    factor_ptr->eta_pool_length = 0;
+
+    return 1;
+}
+
+// Copies the dense LU factors into L, U and their row-wise counterparts, dropping the zeros
+uint32_t basis_factor_extract(basis_factor_t* factor_ptr) {
+    uint32_t n = factor_ptr->n;
+    const gsl_matrix* LU = &factor_ptr->LU.matrix;
+    uint32_t* rows = factor_ptr->rhs;
+    double* values = factor_ptr->work;
+
+    csc_matrix_t* parts[4] = {&factor_ptr->L, &factor_ptr->U, &factor_ptr->Lt, &factor_ptr->Ut};
+    for (uint32_t k = 0; k < 4; k++) {
+        parts[k]->rows = n;
+        parts[k]->cols = 0;
+    }
+
+    for (uint32_t j = 0; j < n; j++) {
+        uint32_t length = 0;
+        for (uint32_t i = j + 1; i < n; i++) {
+            double v = gsl_matrix_get(LU, i, j);
+            if (v != 0.0) {
+                rows[length] = i;
+                values[length++] = v;
+            }
+        }
+        if (!csc_push_column(&factor_ptr->L, rows, values, length)) {
+            return 0;
+        }
+
+        length = 0;
+        for (uint32_t i = 0; i < j; i++) {
+            double v = gsl_matrix_get(LU, i, j);
+            if (v != 0.0) {
+                rows[length] = i;
+                values[length++] = v;
+            }
+        }
+        if (!csc_push_column(&factor_ptr->U, rows, values, length)) {
+            return 0;
+        }
+
+        // Row j of L and of U
+        const double* row = gsl_matrix_const_ptr(LU, j, 0);
+        length = 0;
+        for (uint32_t k = 0; k < j; k++) {
+            if (row[k] != 0.0) {
+                rows[length] = k;
+                values[length++] = row[k];
+            }
+        }
+        if (!csc_push_column(&factor_ptr->Lt, rows, values, length)) {
+            return 0;
+        }
+
+        length = 0;
+        for (uint32_t k = j + 1; k < n; k++) {
+            if (row[k] != 0.0) {
+                rows[length] = k;
+                values[length++] = row[k];
+            }
+        }
+        if (!csc_push_column(&factor_ptr->Ut, rows, values, length)) {
+            return 0;
+        }
+
+        factor_ptr->U_diag[j] = row[j];
+    }
+
+    return 1;
+}
+
+uint32_t basis_factor_refactor(basis_factor_t* factor_ptr, const csc_matrix_t* A, const int32_t* B) {
+    if (!factor_ptr || !A || !B) {
+        return 0;
+    }
+
+    uint32_t n = factor_ptr->n;
+    gsl_matrix* LU = &factor_ptr->LU.matrix;
+    gsl_matrix_set_zero(LU);
+    for (uint32_t j = 0; j < n; j++) {
+        if (B[j] < 0 || (uint32_t)B[j] >= A->cols) {
+            fprintf(stderr, "Invalid basis index %d\n", B[j]);
+            return 0;
+        }
+        for (uint32_t k = A->col_ptr[B[j]]; k < A->col_ptr[B[j] + 1]; k++) {
+            gsl_matrix_set(LU, A->row_idx[k], j, A->values[k]);
+        }
+    }
+
+    int signum;
+    gsl_linalg_LU_decomp(LU, &factor_ptr->perm, &signum);
+
+    factor_ptr->eta_n = 0;
+    factor_ptr->eta_pool_length = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (fabs(gsl_matrix_get(LU, i, i)) < SINGULAR_TOL) {
+            fprintf(stderr, "Singular basis matrix\n");
+            return 0;
+        }
+    }
+
+    return basis_factor_extract(factor_ptr);
+}
+
+// Depth-first search in the graph of G, with an edge j -> i for every entry (i, j), from the nodes
+// rhs[0..rhs_n). The reached nodes are left marked in pattern[top..n) in topological order, returns top
+uint32_t basis_factor_reach(const basis_factor_t* factor_ptr, const csc_matrix_t* G, uint32_t rhs_n) {
+    uint32_t* pattern = factor_ptr->pattern;
+    uint32_t* stack = factor_ptr->stack;
+    uint32_t* next = factor_ptr->next;
+    uint8_t* mark = factor_ptr->mark;
+    uint32_t top = factor_ptr->n;
+
+    for (uint32_t r = 0; r < rhs_n; r++) {
+        uint32_t root = factor_ptr->rhs[r];
+        if (mark[root]) {
+            continue;
+        }
+
+        uint32_t head = 0;
+        stack[0] = root;
+        mark[root] = 1;
+        next[root] = G->col_ptr[root];
+        while (1) {
+            uint32_t j = stack[head];
+            if (next[j] < G->col_ptr[j + 1]) {
+                uint32_t i = G->row_idx[next[j]++];
+                if (!mark[i]) {
+                    mark[i] = 1;
+                    next[i] = G->col_ptr[i];
+                    stack[++head] = i;
+                }
+                continue;
+            }
+
+            // Every node j reaches is already placed after it
+            pattern[--top] = j;
+            if (head-- == 0) {
+                break;
+            }
+        }
+    }
+
+    return top;
+}
+
+// Solves G * x = work in place, with G triangular (lower if is_lower) and diagonal diag, unit if NULL.
+// rhs[0..*nnz_ptr) is the nonzero pattern of work: when sparse, only the nodes reached from it are
+// solved and it becomes the pattern of x. Otherwise every column is visited and *nnz_ptr becomes n
+void basis_factor_solve(const basis_factor_t* factor_ptr, const csc_matrix_t* G, const double* diag,
+                        uint32_t is_lower, uint32_t* nnz_ptr) {
+    uint32_t n = factor_ptr->n;
+    double* w = factor_ptr->work;
+
+    if (*nnz_ptr > HYPERSPARSE_RATIO * n) {
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t j = is_lower ? k : n - 1 - k;
+            if (diag) {
+                w[j] /= diag[j];
+            }
+            double wj = w[j];
+            if (wj == 0.0) {
+                continue;
+            }
+            for (uint32_t s = G->col_ptr[j]; s < G->col_ptr[j + 1]; s++) {
+                w[G->row_idx[s]] -= G->values[s] * wj;
+            }
+        }
+        *nnz_ptr = n;
+        return;
+    }
+
+    uint32_t top = basis_factor_reach(factor_ptr, G, *nnz_ptr);
+    for (uint32_t k = top; k < n; k++) {
+        uint32_t j = factor_ptr->pattern[k];
+        factor_ptr->mark[j] = 0;
+        factor_ptr->rhs[k - top] = j;
+        if (diag) {
+            w[j] /= diag[j];
+        }
+        double wj = w[j];
+        if (wj == 0.0) {
+            continue;
+        }
+        for (uint32_t s = G->col_ptr[j]; s < G->col_ptr[j + 1]; s++) {
+            w[G->row_idx[s]] -= G->values[s] * wj;
+        }
+    }
+    *nnz_ptr = n - top;
+}
+
+void basis_factor_ftran(const basis_factor_t* factor_ptr, gsl_vector* v) {
+    uint32_t n = factor_ptr->n;
+    double* w = factor_ptr->work;
+
+    // Solve L * U * x = P * v
+    uint32_t nnz = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        w[i] = gsl_vector_get(v, gsl_permutation_get(&factor_ptr->perm, i));
+        if (w[i] != 0.0) {
+            factor_ptr->rhs[nnz++] = i;
+        }
+    }
+    basis_factor_solve(factor_ptr, &factor_ptr->L, NULL, 1, &nnz);
+    basis_factor_solve(factor_ptr, &factor_ptr->U, factor_ptr->U_diag, 0, &nnz);
+
+    // Apply the eta file in order
+    for (uint32_t e = 0; e < factor_ptr->eta_n; e++) {
+        const eta_t* eta = &factor_ptr->etas[e];
+        double xp = w[eta->p] / eta->pivot;
+        w[eta->p] = xp;
+        if (xp == 0.0) {
+            continue;
+        }
+        for (uint32_t k = eta->start; k < eta->start + eta->length; k++) {
+            w[factor_ptr->eta_indices[k]] -= factor_ptr->eta_values[k] * xp;
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(v, i, w[i]);
+    }
+}
+
+void basis_factor_btran(const basis_factor_t* factor_ptr, gsl_vector* v) {
+    uint32_t n = factor_ptr->n;
+    double* w = factor_ptr->work;
+
+    for (uint32_t i = 0; i < n; i++) {
+        w[i] = gsl_vector_get(v, i);
+    }
+
+    // Apply the transposed eta file in reverse order
+    for (uint32_t e = factor_ptr->eta_n; e-- > 0;) {
+        const eta_t* eta = &factor_ptr->etas[e];
+        double sum = w[eta->p];
+        for (uint32_t k = eta->start; k < eta->start + eta->length; k++) {
+            sum -= factor_ptr->eta_values[k] * w[factor_ptr->eta_indices[k]];
+        }
+        w[eta->p] = sum / eta->pivot;
+    }
+
+    // Solve U^T * L^T * (P * y) = w
+    uint32_t nnz = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (w[i] != 0.0) {
+            factor_ptr->rhs[nnz++] = i;
+        }
+    }
+    basis_factor_solve(factor_ptr, &factor_ptr->Ut, factor_ptr->U_diag, 1, &nnz);
+    basis_factor_solve(factor_ptr, &factor_ptr->Lt, NULL, 0, &nnz);
+
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(v, gsl_permutation_get(&factor_ptr->perm, i), w[i]);
+    }
+}
+
+uint32_t basis_factor_update(basis_factor_t* factor_ptr, const csc_matrix_t* A, const int32_t* B, uint32_t p,
+                             const gsl_vector* alpha_q) {
+    if (!factor_ptr || !A || !B || !alpha_q || p >= factor_ptr->n) {
+        return 0;
+    }
+
+    double pivot = gsl_vector_get(alpha_q, p);
+    if (factor_ptr->eta_n >= factor_ptr->refactor_period || fabs(pivot) < ETA_PIVOT_TOL) {
+        return basis_factor_refactor(factor_ptr, A, B);
+    }
+
+    eta_t* eta = &factor_ptr->etas[factor_ptr->eta_n++];
+    eta->p = p;
+    eta->pivot = pivot;
+    eta->start = factor_ptr->eta_pool_length;
+    eta->length = 0;
+
+    for (uint32_t i = 0; i < factor_ptr->n; i++) {
+        double di = gsl_vector_get(alpha_q, i);
+        if (i == p || fabs(di) < ETA_DROP_TOL) {
+            continue;
+        }
+        factor_ptr->eta_indices[eta->start + eta->length] = i;
+        factor_ptr->eta_values[eta->start + eta->length] = di;
+        eta->length++;
+    }
+    factor_ptr->eta_pool_length += eta->length;
+
+    return 1;
+}
+
+void basis_factor_free(basis_factor_t* factor_ptr) {
+    if (!factor_ptr) {
+        return;
+    }
+
+    gsl_matrix_free(factor_ptr->LU_block);
+    gsl_permutation_free(factor_ptr->perm_block);
+    free(factor_ptr->etas);
+    free(factor_ptr->eta_indices);
+    free(factor_ptr->eta_values);
+    free(factor_ptr->work);
+    free(factor_ptr->U_diag);
+    free(factor_ptr->rhs);
+    free(factor_ptr->pattern);
+    free(factor_ptr->stack);
+    free(factor_ptr->next);
+    free(factor_ptr->mark);
+    csc_free(&factor_ptr->L);
+    csc_free(&factor_ptr->U);
+    csc_free(&factor_ptr->Lt);
+    csc_free(&factor_ptr->Ut);
+    factor_ptr->LU_block = NULL;
+    factor_ptr->perm_block = NULL;
+    factor_ptr->n = 0;
+    factor_ptr->capacity = 0;
+    factor_ptr->etas = NULL;
+    factor_ptr->eta_indices = NULL;
+    factor_ptr->eta_values = NULL;
+    factor_ptr->work = NULL;
+    factor_ptr->U_diag = NULL;
+    factor_ptr->rhs = NULL;
+    factor_ptr->pattern = NULL;
+    factor_ptr->stack = NULL;
+    factor_ptr->next = NULL;
+    factor_ptr->mark = NULL;
+    factor_ptr->eta_n = 0;
+    factor_ptr->eta_pool_length = 0;
+}
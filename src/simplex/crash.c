@@ -0,0 +1,128 @@
+#include "simplex/crash.h"
+#include "simplex/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Scores column j as a crash candidate. Returns the pivot row, or -1 if the column
+// cannot enter: it touches a covered row or no pivot gives a value within its bounds
+int32_t crash_candidate(const csc_matrix_t* A, uint32_t j, const var_arr_t* var_arr_ptr, const uint32_t* covered,
+                        const gsl_vector* residual, double* pivot_ptr, double* value_ptr) {
+    double col_max = 0.0;
+    for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+        // A nonzero in a covered row would break the triangular structure
+        if (covered[A->row_idx[k]]) {
+            return -1;
+        }
+        col_max = fmax(col_max, fabs(A->values[k]));
+    }
+
+    double lb = var_lb(var_arr_ptr, j);
+    double ub = var_ub(var_arr_ptr, j);
+
+    int32_t pivot_row = -1;
+    for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+        double a = A->values[k];
+        if (fabs(a) < CRASH_PIVOT_RATIO * col_max || (pivot_row != -1 && fabs(a) <= fabs(*pivot_ptr))) {
+            continue;
+        }
+
+        // Value that zeroes the residual of the pivot row
+        uint32_t i = A->row_idx[k];
+        double value = lb + gsl_vector_get(residual, i) / a;
+        if (value < lb - 1e-9 || value > ub + 1e-9) {
+            continue;
+        }
+
+        pivot_row = (int32_t)i;
+        *pivot_ptr = a;
+        *value_ptr = value;
+    }
+
+    return pivot_row;
+}
+
+uint32_t crash_basis(uint32_t n, uint32_t m, const csc_matrix_t* A, const gsl_vector* b, const var_arr_t* var_arr_ptr,
+                     int32_t* B) {
+    for (uint32_t i = 0; i < n; i++) {
+        B[i] = -1;
+    }
+
+    uint32_t covered_n = 0;
+    uint32_t* covered = (uint32_t*)calloc(n, sizeof(uint32_t));
+    uint32_t* is_basic = (uint32_t*)calloc(m, sizeof(uint32_t));
+    gsl_vector* residual = gsl_vector_alloc(n);
+    if (!covered || !is_basic || !residual) {
+        fprintf(stderr, "Failed to allocate the crash basis buffers\n");
+        goto cleanup;
+    }
+
+    // Residual b - A * x with every variable at its lower bound
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(residual, i, gsl_vector_get(b, i));
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        double lb = var_lb(var_arr_ptr, j);
+        if (lb != 0.0) {
+            csc_column_axpy(A, j, -lb, residual);
+        }
+    }
+
+    while (covered_n < n) {
+        int32_t best_j = -1;
+        int32_t best_row = -1;
+        double best_pivot = 0.0;
+        double best_value = 0.0;
+        uint32_t best_nnz = 0;
+        uint32_t best_has_ub = 0;
+
+        for (uint32_t j = 0; j < m; j++) {
+            // Fixed variables would leave the basis at the first pivot
+            if (is_basic[j] || var_lb(var_arr_ptr, j) == var_ub(var_arr_ptr, j)) {
+                continue;
+            }
+
+            double pivot = 0.0;
+            double value = 0.0;
+            int32_t row = crash_candidate(A, j, var_arr_ptr, covered, residual, &pivot, &value);
+            if (row == -1) {
+                continue;
+            }
+
+            // Fewer nonzeros first, then no upper bound, then the largest pivot
+            uint32_t nnz = A->col_ptr[j + 1] - A->col_ptr[j];
+            uint32_t has_ub = var_ub(var_arr_ptr, j) < VARIABLE_INF;
+            uint32_t better = best_j == -1 || nnz < best_nnz ||
+                              (nnz == best_nnz && (has_ub < best_has_ub ||
+                                                   (has_ub == best_has_ub && fabs(pivot) > fabs(best_pivot))));
+            if (better) {
+                best_j = (int32_t)j;
+                best_row = row;
+                best_pivot = pivot;
+                best_value = value;
+                best_nnz = nnz;
+                best_has_ub = has_ub;
+            }
+        }
+
+        if (best_j == -1) {
+            break;
+        }
+
+        // The new basic variable moves away from its lower bound
+        csc_column_axpy(A, (uint32_t)best_j, -(best_value - var_lb(var_arr_ptr, best_j)), residual);
+        gsl_vector_set(residual, (uint32_t)best_row, 0.0);
+
+        B[best_row] = best_j;
+        covered[best_row] = 1;
+        is_basic[best_j] = 1;
+        covered_n++;
+    }
+
+cleanup:
+    free(covered);
+    free(is_basic);
+    gsl_vector_free(residual);
+    return covered_n;
+}
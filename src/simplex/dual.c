@@ -1,10 +1,75 @@
 #include "simplex/dual.h"
+#include "simplex/primal.h"
 #include "simplex/utils.h"
-
+#include "simplex/dual_pricing.h"
+#include "simplex/perturb.h"
+#include "kernels.h"
+#include "parallel.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
 #include <gsl/gsl_linalg.h>
 
-uint32_t simplex_dual(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const gsl_matrix* A,
-                      const gsl_vector* b, int32_t* B, int32_t* N, solution_t* solution_ptr, uint32_t* iter_n_ptr) {
+// Shared by the blocks of a pass over the nonbasic positions
+typedef struct dual_pass {
+    uint32_t is_max;
+    const gsl_vector* c;
+    const gsl_vector* y;
+    const csc_matrix_t* A;
+    const var_arr_t* var_arr_ptr;
+    const int32_t* N;
+    var_state_t* state;
+    gsl_vector* r;
+    const gsl_vector* rho_p;
+    gsl_vector* alpha;
+    gsl_vector* dir;
+    double sign;
+} dual_pass_t;
+
+// Reduced costs of the positions [start, end), moving their boxed variables to the bound the reduced cost asks for
+parallel_best_t dual_reduced_cost_block(void* ctx, uint32_t start, uint32_t end) {
+    const dual_pass_t* pass = (const dual_pass_t*)ctx;
+
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t j = pass->N[i];
+        double ri = compute_reduced_cost(pass->is_max, j, pass->c, pass->y, pass->A);
+        gsl_vector_set(pass->r, i, ri);
+        if (pass->state[j] == VAR_STATE_LOWER && ri > 1e-9 && var_ub(pass->var_arr_ptr, j) < VARIABLE_INF) {
+            pass->state[j] = VAR_STATE_UPPER;
+        } else if (pass->state[j] == VAR_STATE_UPPER && ri < -1e-9) {
+            pass->state[j] = VAR_STATE_LOWER;
+        }
+    }
+
+    parallel_best_t none = {0.0, -1};
+    return none;
+}
+
+// Pivot row entries alpha_pj = rho_p * Aj of the positions [start, end) whose variable can move,
+// and the entering candidate of the ratio test among them
+parallel_best_t dual_pivot_row_block(void* ctx, uint32_t start, uint32_t end) {
+    const dual_pass_t* pass = (const dual_pass_t*)ctx;
+
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t j = pass->N[i];
+        var_state_t state = pass->state[j];
+        double dir_j = state == VAR_STATE_LOWER ? 1.0 : (state == VAR_STATE_UPPER ? -1.0 : 0.0);
+        gsl_vector_set(pass->dir, i, dir_j);
+        gsl_vector_set(pass->alpha, i, dir_j != 0.0 ? csc_column_dot(pass->A, j, pass->rho_p) : 0.0);
+    }
+
+    parallel_best_t best = {1e20, -1};
+    int32_t q = kernel_dual_ratio_test(end - start, pass->r->data + start, pass->alpha->data + start,
+                                       pass->dir->data + start, pass->sign, &best.value);
+    best.index = q == -1 ? -1 : (int32_t)start + q;
+    return best;
+}
+
+uint32_t simplex_dual(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                      const gsl_vector* b, const var_arr_t* var_arr_ptr, int32_t* B, int32_t* N,
+                      var_state_t* state, const options_t* opts_ptr, simplex_workspace_t* workspace_ptr,
+                      solution_t* solution_ptr, uint32_t* iter_n_ptr) {
     if (!c || !A || !B || !N || !solution_ptr || !iter_n_ptr) {
         fprintf(stderr, "Some arguments are NULL in simplex_dual\n");
         return 0;
@@ -12,100 +77,165 @@ uint32_t simplex_dual(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector*
 
     uint32_t ret = 1;
 
-    gsl_matrix* AB = gsl_matrix_alloc(n, n);
-    gsl_matrix* AB_inv = NULL;
-    gsl_vector* xB = gsl_vector_alloc(n);
-    gsl_vector* cB = gsl_vector_alloc(n);
-    gsl_vector* cN = gsl_vector_alloc(m - n);
-    gsl_vector* r = gsl_vector_alloc(m - n);
+    options_t default_opts;
+    if (!opts_ptr) {
+        options_init(&default_opts);
+        opts_ptr = &default_opts;
+    }
+
+    // A one-off solve gets a workspace sized for this problem only
+    simplex_workspace_t own_workspace = {0};
+    if (!workspace_ptr) {
+        if (!simplex_workspace_init(&own_workspace, n, m, opts_ptr)) {
+            return 0;
+        }
+        workspace_ptr = &own_workspace;
+    }
+
+    if (!simplex_workspace_prepare(workspace_ptr, n, m)) {
+        goto fail;
+    }
+
+    basis_factor_t* factor_ptr = &workspace_ptr->factor;
+    dual_pricing_t* pricing_ptr = &workspace_ptr->dual_pricing;
+    gsl_vector* xB = &workspace_ptr->xB.vector;
+    gsl_vector* y = &workspace_ptr->y.vector;
+    gsl_vector* r = &workspace_ptr->r.vector;
+    gsl_vector* rho_p = &workspace_ptr->rho_p.vector;
+    gsl_vector* Aj = &workspace_ptr->d.vector;
+    gsl_vector* alpha = &workspace_ptr->alpha.vector;
+    gsl_vector* dir = &workspace_ptr->dir.vector;
+    gsl_vector* c_pert = &workspace_ptr->c_pert.vector;
+
+    // Without a state every nonbasic variable starts at its lower bound
+    if (!state) {
+        state = workspace_ptr->state;
+        memset(state, 0, sizeof(var_state_t) * m);
+    }
+    normalize_states(n, m, B, N, var_arr_ptr, state);
+
+    // Factorize AB once (unless the caller kept the factors of the last solve), then keep it up to date
+    // with eta updates
+    uint32_t keep_factor = workspace_ptr->keep_factor;
+    workspace_ptr->keep_factor = 0;
+    if (!keep_factor && !basis_factor_refactor(factor_ptr, A, B)) {
+        goto fail;
+    }
 
-    if (!AB || !xB || !cB || !cN || !r) {
+    if (!dual_pricing_init(pricing_ptr, opts_ptr, n, B, factor_ptr)) {
         goto fail;
     }
 
+    // A cleanup solve does not perturb again, nor does a limited one, whose bound must hold for the original costs
+    uint32_t iter_limit = workspace_ptr->iter_limit;
+    workspace_ptr->iter_limit = 0;
+    uint32_t can_perturb = !workspace_ptr->is_cleanup && iter_limit == 0;
+    workspace_ptr->is_cleanup = 0;
+    perturb_t perturb;
+    perturb_init(&perturb);
+    const gsl_vector* c_cur = c;
+
     *iter_n_ptr = 0;
     uint32_t unbounded = 0;
+    uint32_t degenerate_n = 0;
     while (1) {
-        // Extract AB matrix and cB vector
-        extract_basic_objects(n, is_max, B, c, A, cB, AB);
-
-        // Compute AB_inv = AB^-1
-        gsl_matrix* old = AB_inv;
-        AB_inv = inverse(AB, n);
-        gsl_matrix_free(old);
-        if (!AB_inv) {
-            goto fail;
+        // Stalling on degenerate pivots: perturb the costs so that the nonbasic reduced costs leave zero
+        if (can_perturb && degenerate_n >= PERTURB_STALL) {
+            if (perturb.count == 0) {
+                for (uint32_t j = 0; j < m; j++) {
+                    gsl_vector_set(c_pert, j, gsl_vector_get(c, j));
+                }
+                c_cur = c_pert;
+            }
+            perturb_costs(&perturb, n, m, is_max, N, state, c_pert);
+            perturb.count++;
+            degenerate_n = 0;
         }
 
-        // Compute xB = AB_inv * b
-        compute_basic_solution(AB_inv, b, xB);
+        // Simplex multipliers y = AB_inv^T * cB
+        compute_duals(n, is_max, B, c_cur, factor_ptr, y);
+
+        // For all non-basic variables. Boxed variables are kept dual feasible by moving them to
+        // the bound their reduced cost asks for
+        dual_pass_t pass = {is_max, c_cur, y, A, var_arr_ptr, N, state, r, rho_p, alpha, dir, 0.0};
+        parallel_reduce(m - n, PARALLEL_MAX, dual_reduced_cost_block, &pass);
 
-        // For all non-basic variables
-        compute_reduced_costs(n, m, is_max, N, c, cB, cN, A, AB_inv, r);
+        // Compute xB = AB_inv * (b - AN * xN)
+        compute_basic_solution(factor_ptr, A, b, n, m, N, var_arr_ptr, state, xB);
 
         // Choose leaving basic variable (primal-infeasible)
-        int32_t p = -1;
-        double most_negative = -1e-8;
-        for (uint32_t i = 0; i < n; i++) {
-            double xi = gsl_vector_get(xB, i);
-            if (xi < most_negative) {
-                most_negative = xi;
-                p = i;
-            }
-        }
+        int32_t p = dual_pricing_select(pricing_ptr, xB, B, var_arr_ptr);
 
         if (p == -1) {
             break;  // Primal feasible, so optimal
         }
 
-        // Extract leaving row from AB_inv
-        gsl_vector* AB_inv_p = gsl_vector_alloc(n);
-        if (!extract_row(AB_inv, (uint32_t)p, AB_inv_p)) {
-            goto fail;
+        // The basis is still dual feasible, so its value bounds the optimum
+        if (iter_limit > 0 && *iter_n_ptr >= iter_limit) {
+            break;
         }
 
-        // Choose entering variable by computing alpha_pj = AB_inv_p * Aj for each non-basic variable
-        double min_ratio = 1e20;
-        int32_t q = -1;
-        gsl_vector* Aj = gsl_vector_alloc(n);
-        for (uint32_t i = 0; i < m - n; i++) {
-            uint32_t j = N[i];
-
-            // Aj
-            if (!extract_column(A, j, Aj)) {
-                gsl_vector_free(AB_inv_p);
-                gsl_vector_free(Aj);
-                goto fail;
-            }
+        // The leaving variable goes to the bound it violates
+        double delta = dual_pricing_infeasibility(var_arr_ptr, (uint32_t)B[p], gsl_vector_get(xB, p));
+        double sign = delta < 0.0 ? 1.0 : -1.0;
+        var_state_t leaving_state = delta < 0.0 ? VAR_STATE_LOWER : VAR_STATE_UPPER;
+        if (var_lb(var_arr_ptr, B[p]) == var_ub(var_arr_ptr, B[p])) {
+            leaving_state = VAR_STATE_FIXED;
+        }
 
-            double alpha_pj;
-            gsl_blas_ddot(AB_inv_p, Aj, &alpha_pj);
+        // Compute the leaving row of AB_inv as rho_p = AB_inv^T * e_p
+        gsl_vector_set_zero(rho_p);
+        gsl_vector_set(rho_p, (uint32_t)p, 1.0);
+        basis_factor_btran(factor_ptr, rho_p);
 
-            // Only include positive ones
-            if (alpha_pj > 0.0) {
-                double ratio = -gsl_vector_get(r, j) / alpha_pj;
-                if (ratio < min_ratio) {
-                    min_ratio = ratio;
-                    q = i;
-                }
-            }
-        }
-        gsl_vector_free(Aj);
-        gsl_vector_free(AB_inv_p);
+        // Compute the pivot row alpha_pj = rho_p * Aj of the non-basic variables that can move, then choose the
+        // entering variable among those whose move pushes xB[p] back towards the violated bound: increasing ones
+        // need a negative sign * alpha_pj, decreasing ones a positive one
+        pass.sign = sign;
+        parallel_best_t entering = parallel_reduce(m - n, PARALLEL_MIN, dual_pivot_row_block, &pass);
+        int32_t q = entering.index;
 
         if (q == -1) {
             unbounded = 1;
             break;
         }
+        degenerate_n = entering.value < 1e-12 ? degenerate_n + 1 : degenerate_n / 2;
+
+        // Entering column alpha_q = AB_inv * Aq for the basis update
+        if (!extract_column(A, (uint32_t)N[q], Aj)) {
+            goto fail;
+        }
+        basis_factor_ftran(factor_ptr, Aj);
 
+        dual_pricing_update(pricing_ptr, factor_ptr, (uint32_t)p, Aj, rho_p);
+
+        state[B[p]] = leaving_state;
+        state[N[q]] = VAR_STATE_BASIC;
         pivot(q, p, B, N);
 
+        if (!basis_factor_update(factor_ptr, A, B, (uint32_t)p, Aj)) {
+            goto fail;
+        }
+
         (*iter_n_ptr)++;
     }
+    dual_pricing_save(pricing_ptr, B);
+
+    // Remove the perturbation: the basis is still primal feasible for the original costs, so the primal simplex
+    // restores its dual feasibility from the same factors
+    if (perturb.count > 0 && !unbounded) {
+        uint32_t cleanup_n = 0;
+        workspace_ptr->keep_factor = 1;
+        workspace_ptr->is_cleanup = 1;
+        ret = simplex_primal(n, m, is_max, c, A, b, var_arr_ptr, B, N, state, opts_ptr, workspace_ptr, solution_ptr,
+                             &cleanup_n);
+        *iter_n_ptr += cleanup_n;
+        goto cleanup;
+    }
 
     // Extract optimal solution and value
-    if (solution_init(solution_ptr, n, m, unbounded) && !unbounded) {
-        extract_optimal(n, is_max, B, xB, c, solution_ptr);
+    if (solution_init(solution_ptr, n, m + n, unbounded) && !unbounded) {
+        extract_optimal(n, m, is_max, B, N, xB, c, var_arr_ptr, state, solution_ptr);
     }
 
     goto cleanup;
@@ -114,11 +244,6 @@ fail:
     ret = 0;
 
 cleanup:
-    gsl_matrix_free(AB);
-    gsl_matrix_free(AB_inv);
-    gsl_vector_free(xB);
-    gsl_vector_free(cB);
-    gsl_vector_free(cN);
-    gsl_vector_free(r);
+    simplex_workspace_free(&own_workspace);
     return ret;
-}
\ No newline at end of file
+}
@@ -0,0 +1,205 @@
+#include "simplex/dual_pricing.h"
+#include "simplex/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_blas.h>
+
+#define DUAL_PRICING_TOL 1e-8
+#define DUAL_WEIGHT_MIN 1e-12
+#define DUAL_DEVEX_RESET 1e6
+
+// Resets the dual Devex reference framework to the current basic variables
+void dual_pricing_devex_reset(dual_pricing_t* pricing_ptr) {
+    for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+        pricing_ptr->weights[i] = 1.0;
+    }
+}
+
+uint32_t dual_pricing_alloc(dual_pricing_t* pricing_ptr, uint32_t max_n) {
+    if (!pricing_ptr || max_n == 0) {
+        return 0;
+    }
+
+    pricing_ptr->max_n = max_n;
+    pricing_ptr->is_saved = 0;
+    pricing_ptr->weights = (double*)malloc(sizeof(double) * max_n);
+    pricing_ptr->basis = (int32_t*)malloc(sizeof(int32_t) * max_n);
+    pricing_ptr->data = (double*)malloc(sizeof(double) * max_n);
+    if (!pricing_ptr->weights || !pricing_ptr->basis || !pricing_ptr->data) {
+        fprintf(stderr, "Failed to allocate dual pricing buffers\n");
+        dual_pricing_free(pricing_ptr);
+        return 0;
+    }
+
+    return 1;
+}
+
+uint32_t dual_pricing_init(dual_pricing_t* pricing_ptr, const options_t* opts_ptr, uint32_t n, const int32_t* B,
+                           const basis_factor_t* factor_ptr) {
+    if (!pricing_ptr || !opts_ptr || !B || !factor_ptr) {
+        return 0;
+    }
+
+    if (n > pricing_ptr->max_n) {
+        fprintf(stderr, "Problem too big for the dual pricing buffers\n");
+        return 0;
+    }
+
+    // The weights a previous solve left only fit a basis with the same rows
+    uint32_t is_resolve = pricing_ptr->is_saved;
+    uint32_t is_same_size = is_resolve && pricing_ptr->size == n;
+    pricing_ptr->rule = opts_ptr->dual_pricing;
+    pricing_ptr->size = n;
+    pricing_ptr->tau = gsl_vector_view_array(pricing_ptr->data, n);
+
+    if (pricing_ptr->rule == PRICING_DEVEX) {
+        dual_pricing_devex_reset(pricing_ptr);
+    } else if (pricing_ptr->rule == PRICING_STEEPEST_EDGE && is_resolve) {
+        // n BTRANs on every reoptimization would cost more than the pivots they save, so the rows that changed
+        // since the last solve, or whose weight the updates blew up, start over from the Devex reference weight
+        for (uint32_t i = 0; i < n; i++) {
+            if (!is_same_size || pricing_ptr->basis[i] != B[i] || !isfinite(pricing_ptr->weights[i])) {
+                pricing_ptr->weights[i] = 1.0;
+            }
+        }
+    } else if (pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+        // Exact dual steepest edge norms beta_i = ||AB_inv^T * e_i||^2
+        gsl_vector* tau = &pricing_ptr->tau.vector;
+        for (uint32_t i = 0; i < n; i++) {
+            gsl_vector_set_zero(tau);
+            gsl_vector_set(tau, i, 1.0);
+            basis_factor_btran(factor_ptr, tau);
+            double norm = gsl_blas_dnrm2(tau);
+            pricing_ptr->weights[i] = norm * norm;
+        }
+    }
+
+    return 1;
+}
+
+void dual_pricing_save(dual_pricing_t* pricing_ptr, const int32_t* B) {
+    memcpy(pricing_ptr->basis, B, sizeof(int32_t) * pricing_ptr->size);
+    pricing_ptr->is_saved = 1;
+}
+
+// Devex and steepest edge scale the infeasibilities by their weights
+uint32_t dual_pricing_has_weights(const dual_pricing_t* pricing_ptr) {
+    return pricing_ptr->rule == PRICING_DEVEX || pricing_ptr->rule == PRICING_STEEPEST_EDGE;
+}
+
+double dual_pricing_infeasibility(const var_arr_t* var_arr_ptr, uint32_t j, double xj) {
+    double lb = var_lb(var_arr_ptr, j);
+    if (xj < lb - DUAL_PRICING_TOL) {
+        return xj - lb;
+    }
+
+    double ub = var_ub(var_arr_ptr, j);
+    if (ub < VARIABLE_INF && xj > ub + DUAL_PRICING_TOL) {
+        return xj - ub;
+    }
+
+    return 0.0;
+}
+
+int32_t dual_pricing_select(const dual_pricing_t* pricing_ptr, const gsl_vector* xB, const int32_t* B,
+                            const var_arr_t* var_arr_ptr) {
+    // Any infeasible row beats none, even one whose weight is so large that its score is 0
+    int32_t p = -1;
+    double best = -1.0;
+    for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+        double delta = dual_pricing_infeasibility(var_arr_ptr, (uint32_t)B[i], gsl_vector_get(xB, i));
+        if (delta == 0.0) {
+            continue;
+        }
+
+        if (pricing_ptr->rule == PRICING_BLAND) {
+            if (p == -1 || B[i] < B[p]) {
+                p = i;
+            }
+            continue;
+        }
+
+        // Infeasibility scaled by the weight of the row
+        double score = dual_pricing_has_weights(pricing_ptr) ? delta * delta / pricing_ptr->weights[i] : fabs(delta);
+        if (score > best) {
+            best = score;
+            p = i;
+        }
+    }
+
+    return p;
+}
+
+void dual_pricing_update(dual_pricing_t* pricing_ptr, const basis_factor_t* factor_ptr, uint32_t p,
+                         const gsl_vector* alpha_q, const gsl_vector* rho_p) {
+    if (!dual_pricing_has_weights(pricing_ptr)) {
+        return;
+    }
+
+    double alpha_pq = gsl_vector_get(alpha_q, p);
+    double weight_p = pricing_ptr->weights[p];
+    gsl_vector* tau = &pricing_ptr->tau.vector;
+
+    if (pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+        gsl_vector_memcpy(tau, rho_p);
+        basis_factor_ftran(factor_ptr, tau);
+    }
+
+    uint32_t reset = 0;
+    for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+        if (i == p) {
+            continue;
+        }
+
+        double alpha_iq = gsl_vector_get(alpha_q, i);
+        if (alpha_iq == 0.0) {
+            continue;
+        }
+
+        double ratio = alpha_iq / alpha_pq;
+        double* weight = &pricing_ptr->weights[i];
+        if (pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+            // Forrest-Goldfarb recurrence
+            double updated = *weight - 2.0 * ratio * gsl_vector_get(tau, i) + ratio * ratio * weight_p;
+            *weight = updated > DUAL_WEIGHT_MIN ? updated : DUAL_WEIGHT_MIN;
+        } else {
+            double updated = ratio * ratio * weight_p;
+            if (updated > *weight) {
+                *weight = updated;
+            }
+            if (*weight > DUAL_DEVEX_RESET) {
+                reset = 1;
+            }
+        }
+    }
+
+    // The entering variable takes position p in B
+    double entering = weight_p / (alpha_pq * alpha_pq);
+    if (pricing_ptr->rule == PRICING_DEVEX) {
+        pricing_ptr->weights[p] = entering > 1.0 ? entering : 1.0;
+    } else {
+        pricing_ptr->weights[p] = entering > DUAL_WEIGHT_MIN ? entering : DUAL_WEIGHT_MIN;
+    }
+
+    if (reset) {
+        dual_pricing_devex_reset(pricing_ptr);
+    }
+}
+
+void dual_pricing_free(dual_pricing_t* pricing_ptr) {
+    if (!pricing_ptr) {
+        return;
+    }
+
+    free(pricing_ptr->weights);
+    free(pricing_ptr->basis);
+    free(pricing_ptr->data);
+    pricing_ptr->weights = NULL;
+    pricing_ptr->basis = NULL;
+    pricing_ptr->data = NULL;
+    pricing_ptr->is_saved = 0;
+    pricing_ptr->max_n = 0;
+}
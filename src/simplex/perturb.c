@@ -0,0 +1,60 @@
+#include "simplex/perturb.h"
+
+#include <math.h>
+
+void perturb_init(perturb_t* perturb_ptr) {
+    perturb_ptr->rng = 0x9E3779B97F4A7C15ULL;
+    perturb_ptr->count = 0;
+}
+
+double perturb_random(perturb_t* perturb_ptr) {
+    uint64_t x = perturb_ptr->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    perturb_ptr->rng = x;
+
+    // The top 53 bits give a uniform double in [0, 1), mapped to [0.5, 1) so that no shift is close to 0
+    return 0.5 + 0.5 * (double)((x * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+void perturb_rhs(perturb_t* perturb_ptr, uint32_t n, const int32_t* B, const csc_matrix_t* A, const gsl_vector* xB,
+                 const gsl_vector* lbB, const gsl_vector* ubB, gsl_vector* b_pert) {
+    for (uint32_t i = 0; i < n; i++) {
+        double xi = gsl_vector_get(xB, i);
+        double lb = gsl_vector_get(lbB, i);
+        double ub = gsl_vector_get(ubB, i);
+        double range = ub < VARIABLE_INF ? ub - lb : INFINITY;
+
+        // Fixed variables stay where they are
+        double shift = fmin(PERTURB_SCALE * (1.0 + fabs(xi)) * perturb_random(perturb_ptr), 0.5 * range);
+        if (shift <= 0.0) {
+            continue;
+        }
+
+        // Away from the nearest bound, so that the shifted value is still within both
+        if (ub - xi < xi - lb) {
+            shift = -shift;
+        }
+        csc_column_axpy(A, (uint32_t)B[i], shift, b_pert);
+    }
+}
+
+void perturb_costs(perturb_t* perturb_ptr, uint32_t n, uint32_t m, uint32_t is_max, const int32_t* N,
+                   const var_state_t* state, gsl_vector* c_pert) {
+    for (uint32_t i = 0; i < m - n; i++) {
+        uint32_t j = (uint32_t)N[i];
+        if (state[j] != VAR_STATE_LOWER && state[j] != VAR_STATE_UPPER) {
+            continue;
+        }
+
+        double cj = gsl_vector_get(c_pert, j);
+        double shift = PERTURB_SCALE * (1.0 + fabs(cj)) * perturb_random(perturb_ptr);
+
+        // The engines maximize, so a minimized cost moves the other way
+        if (state[j] == VAR_STATE_LOWER) {
+            shift = -shift;
+        }
+        gsl_vector_set(c_pert, j, cj + (is_max ? shift : -shift));
+    }
+}
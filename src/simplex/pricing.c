@@ -0,0 +1,349 @@
+#include "simplex/pricing.h"
+#include "simplex/utils.h"
+#include "parallel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gsl/gsl_blas.h>
+
+#define PRICING_TOL 1e-9
+#define DEVEX_RESET 1e6
+
+// Resets the Devex reference framework to the current nonbasic variables
+void pricing_devex_reset(pricing_t* pricing_ptr) {
+    for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+        pricing_ptr->weights[i] = 1.0;
+    }
+}
+
+uint32_t pricing_alloc(pricing_t* pricing_ptr, uint32_t max_n, uint32_t max_m, uint32_t max_candidates) {
+    if (!pricing_ptr || max_n == 0 || max_m < max_n) {
+        return 0;
+    }
+
+    pricing_ptr->max_n = max_n;
+    pricing_ptr->max_m = max_m;
+    pricing_ptr->max_candidates = max_candidates > 1 ? max_candidates : 1;
+
+    pricing_ptr->weights = (double*)malloc(sizeof(double) * (max_m + 1));
+    pricing_ptr->candidates = (uint32_t*)malloc(sizeof(uint32_t) * pricing_ptr->max_candidates);
+    pricing_ptr->candidate_scores = (double*)malloc(sizeof(double) * pricing_ptr->max_candidates);
+    pricing_ptr->data = (double*)malloc(sizeof(double) * 2 * max_n);
+    if (!pricing_ptr->weights || !pricing_ptr->candidates || !pricing_ptr->candidate_scores || !pricing_ptr->data) {
+        fprintf(stderr, "Failed to allocate pricing buffers\n");
+        pricing_free(pricing_ptr);
+        return 0;
+    }
+
+    return 1;
+}
+
+uint32_t pricing_init(pricing_t* pricing_ptr, const options_t* opts_ptr, uint32_t n, uint32_t m,
+                      const csc_matrix_t* A, const int32_t* N, const basis_factor_t* factor_ptr) {
+    if (!pricing_ptr || !opts_ptr || !A || !N || !factor_ptr) {
+        return 0;
+    }
+
+    if (n > pricing_ptr->max_n || m > pricing_ptr->max_m) {
+        fprintf(stderr, "Problem too big for the pricing buffers\n");
+        return 0;
+    }
+
+    pricing_ptr->rule = opts_ptr->pricing;
+    pricing_ptr->size = m - n;
+    pricing_ptr->segment_start = 0;
+    pricing_ptr->candidate_n = 0;
+    pricing_ptr->rho_p = gsl_vector_view_array(pricing_ptr->data, n);
+    pricing_ptr->w = gsl_vector_view_array(pricing_ptr->data + n, n);
+
+    pricing_ptr->partial_size = opts_ptr->partial_size;
+    if (pricing_ptr->partial_size == 0 || pricing_ptr->partial_size > pricing_ptr->size) {
+        pricing_ptr->partial_size = pricing_ptr->size;
+    }
+    pricing_ptr->candidate_capacity = opts_ptr->multiple_size > 1 ? opts_ptr->multiple_size : 1;
+    if (pricing_ptr->candidate_capacity > pricing_ptr->max_candidates) {
+        pricing_ptr->candidate_capacity = pricing_ptr->max_candidates;
+    }
+
+    if (pricing_ptr->rule == PRICING_DEVEX) {
+        pricing_devex_reset(pricing_ptr);
+    } else if (pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+        // Exact steepest edge norms gamma_j = 1 + ||AB_inv * Aj||^2
+        gsl_vector* w = &pricing_ptr->w.vector;
+        for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+            csc_column_scatter(A, (uint32_t)N[i], w);
+            basis_factor_ftran(factor_ptr, w);
+            double norm = gsl_blas_dnrm2(w);
+            pricing_ptr->weights[i] = 1.0 + norm * norm;
+        }
+    }
+
+    return 1;
+}
+
+// Devex and steepest edge scale the reduced costs by their weights
+uint32_t pricing_has_weights(const pricing_t* pricing_ptr) {
+    return pricing_ptr->rule == PRICING_DEVEX || pricing_ptr->rule == PRICING_STEEPEST_EDGE;
+}
+
+double pricing_score(const pricing_t* pricing_ptr, uint32_t i, double ri) {
+    return pricing_has_weights(pricing_ptr) ? ri * ri / pricing_ptr->weights[i] : fabs(ri);
+}
+
+// A variable at its lower bound improves the objective by increasing, one at its upper bound by decreasing
+uint32_t pricing_is_improving(var_state_t state, double ri) {
+    return (state == VAR_STATE_LOWER && ri > PRICING_TOL) || (state == VAR_STATE_UPPER && ri < -PRICING_TOL);
+}
+
+// Inserts position i in the candidate list if its score is among the best ones
+void pricing_push_candidate(pricing_t* pricing_ptr, uint32_t i, double score) {
+    uint32_t k = pricing_ptr->candidate_n;
+    if (k == pricing_ptr->candidate_capacity) {
+        if (score <= pricing_ptr->candidate_scores[k - 1]) {
+            return;
+        }
+        k--;
+    } else {
+        pricing_ptr->candidate_n++;
+    }
+
+    // Keep the list sorted by decreasing score
+    while (k > 0 && pricing_ptr->candidate_scores[k - 1] < score) {
+        pricing_ptr->candidates[k] = pricing_ptr->candidates[k - 1];
+        pricing_ptr->candidate_scores[k] = pricing_ptr->candidate_scores[k - 1];
+        k--;
+    }
+    pricing_ptr->candidates[k] = i;
+    pricing_ptr->candidate_scores[k] = score;
+}
+
+// Shared by the blocks of a segment scan, whose position k is N[(segment_start + k) % size]
+typedef struct pricing_scan {
+    const pricing_t* pricing_ptr;
+    uint32_t is_max;
+    const gsl_vector* c;
+    const gsl_vector* y;
+    const csc_matrix_t* A;
+    const int32_t* N;
+    const var_state_t* state;
+    gsl_vector* r;
+} pricing_scan_t;
+
+// Prices the segment positions [start, end) and returns the first best improving one
+parallel_best_t pricing_scan_block(void* ctx, uint32_t start, uint32_t end) {
+    const pricing_scan_t* scan = (const pricing_scan_t*)ctx;
+    const pricing_t* pricing_ptr = scan->pricing_ptr;
+
+    parallel_best_t best = {0.0, -1};
+    for (uint32_t k = start; k < end; k++) {
+        uint32_t i = (pricing_ptr->segment_start + k) % pricing_ptr->size;
+        double ri = compute_reduced_cost(scan->is_max, (uint32_t)scan->N[i], scan->c, scan->y, scan->A);
+        scan->r->data[i * scan->r->stride] = ri;
+        if (pricing_is_improving(scan->state[scan->N[i]], ri)) {
+            double score = pricing_score(pricing_ptr, i, ri);
+            if (best.index == -1 || score > best.value) {
+                best.value = score;
+                best.index = (int32_t)i;
+            }
+        }
+    }
+
+    return best;
+}
+
+int32_t pricing_select(pricing_t* pricing_ptr, uint32_t is_max, const gsl_vector* c, const gsl_vector* y,
+                       const csc_matrix_t* A, const int32_t* N, const var_state_t* state, gsl_vector* r,
+                       uint32_t use_bland) {
+    if (use_bland || pricing_ptr->rule == PRICING_BLAND) {
+        // Bland's rule: smallest index with positive reduced cost
+        int32_t q = -1;
+        pricing_ptr->candidate_n = 0;
+        for (uint32_t i = 0; i < pricing_ptr->size; i++) {
+            double ri = compute_reduced_cost(is_max, (uint32_t)N[i], c, y, A);
+            r->data[i * r->stride] = ri;
+            if (pricing_is_improving(state[N[i]], ri) && (q == -1 || N[i] < N[q])) {
+                q = (int32_t)i;
+            }
+        }
+        return q;
+    }
+
+    // Minor iteration: reprice only the candidates left from the last scan
+    if (pricing_ptr->candidate_n > 0) {
+        uint32_t old_n = pricing_ptr->candidate_n;
+        uint32_t old[old_n];
+        for (uint32_t k = 0; k < old_n; k++) {
+            old[k] = pricing_ptr->candidates[k];
+        }
+
+        pricing_ptr->candidate_n = 0;
+        for (uint32_t k = 0; k < old_n; k++) {
+            uint32_t i = old[k];
+            double ri = compute_reduced_cost(is_max, (uint32_t)N[i], c, y, A);
+            r->data[i * r->stride] = ri;
+            if (pricing_is_improving(state[N[i]], ri)) {
+                pricing_push_candidate(pricing_ptr, i, pricing_score(pricing_ptr, i, ri));
+            }
+        }
+
+        if (pricing_ptr->candidate_n > 0) {
+            return (int32_t)pricing_ptr->candidates[0];
+        }
+    }
+
+    // Major iteration: scan segments until one contains an attractive column
+    uint32_t scanned = 0;
+    while (scanned < pricing_ptr->size) {
+        uint32_t length = pricing_ptr->partial_size;
+        if (length > pricing_ptr->size - scanned) {
+            length = pricing_ptr->size - scanned;
+        }
+
+        // A single candidate is the best of the blocks, a list is filled in scan order afterwards
+        pricing_scan_t scan = {pricing_ptr, is_max, c, y, A, N, state, r};
+        parallel_best_t best = parallel_reduce(length, PARALLEL_MAX, pricing_scan_block, &scan);
+        if (pricing_ptr->candidate_capacity == 1) {
+            if (best.index != -1) {
+                pricing_push_candidate(pricing_ptr, (uint32_t)best.index, best.value);
+            }
+        } else {
+            for (uint32_t k = 0; k < length; k++) {
+                uint32_t i = (pricing_ptr->segment_start + k) % pricing_ptr->size;
+                double ri = r->data[i * r->stride];
+                if (pricing_is_improving(state[N[i]], ri)) {
+                    pricing_push_candidate(pricing_ptr, i, pricing_score(pricing_ptr, i, ri));
+                }
+            }
+        }
+
+        pricing_ptr->segment_start = (pricing_ptr->segment_start + length) % pricing_ptr->size;
+        scanned += length;
+
+        if (pricing_ptr->candidate_n > 0) {
+            return (int32_t)pricing_ptr->candidates[0];
+        }
+    }
+
+    // Every column has been priced without finding a positive reduced cost
+    return -1;
+}
+
+// Removes position q from the candidate list
+void pricing_remove_candidate(pricing_t* pricing_ptr, uint32_t q) {
+    for (uint32_t k = 0; k < pricing_ptr->candidate_n; k++) {
+        if (pricing_ptr->candidates[k] == q) {
+            pricing_ptr->candidate_n--;
+            for (; k < pricing_ptr->candidate_n; k++) {
+                pricing_ptr->candidates[k] = pricing_ptr->candidates[k + 1];
+                pricing_ptr->candidate_scores[k] = pricing_ptr->candidate_scores[k + 1];
+            }
+            return;
+        }
+    }
+}
+
+// Shared by the blocks of a weight update
+typedef struct pricing_weights {
+    pricing_t* pricing_ptr;
+    const csc_matrix_t* A;
+    const int32_t* N;
+    const gsl_vector* rho_p;
+    const gsl_vector* w;
+    uint32_t q;
+    double alpha_pq;
+    double weight_q;
+} pricing_weights_t;
+
+// Updates the weights of the positions [start, end) and returns one that asks for a Devex reset, if any
+parallel_best_t pricing_weights_block(void* ctx, uint32_t start, uint32_t end) {
+    const pricing_weights_t* u = (const pricing_weights_t*)ctx;
+
+    parallel_best_t reset = {0.0, -1};
+    for (uint32_t i = start; i < end; i++) {
+        if (i == u->q) {
+            continue;
+        }
+
+        double alpha_pj = csc_column_dot(u->A, (uint32_t)u->N[i], u->rho_p);
+        if (alpha_pj == 0.0) {
+            continue;
+        }
+
+        double ratio = alpha_pj / u->alpha_pq;
+        double* weight = &u->pricing_ptr->weights[i];
+        if (u->pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+            // Goldfarb-Reid recurrence
+            double aj_w = csc_column_dot(u->A, (uint32_t)u->N[i], u->w);
+            double updated = *weight - 2.0 * ratio * aj_w + ratio * ratio * u->weight_q;
+            double lower = 1.0 + ratio * ratio;
+            *weight = updated > lower ? updated : lower;
+        } else {
+            double updated = ratio * ratio * u->weight_q;
+            if (updated > *weight) {
+                *weight = updated;
+            }
+            if (*weight > DEVEX_RESET) {
+                reset.value = 1.0;
+                reset.index = (int32_t)i;
+            }
+        }
+    }
+
+    return reset;
+}
+
+void pricing_update(pricing_t* pricing_ptr, const csc_matrix_t* A, const int32_t* N, const basis_factor_t* factor_ptr,
+                    uint32_t p, uint32_t q, const gsl_vector* alpha_q) {
+    if (!pricing_has_weights(pricing_ptr)) {
+        pricing_remove_candidate(pricing_ptr, q);
+        return;
+    }
+
+    double alpha_pq = gsl_vector_get(alpha_q, p);
+    double weight_q = pricing_ptr->weights[q];
+    gsl_vector* rho_p = &pricing_ptr->rho_p.vector;
+    gsl_vector* w = &pricing_ptr->w.vector;
+
+    // Pivot row of AB_inv
+    gsl_vector_set_zero(rho_p);
+    gsl_vector_set(rho_p, p, 1.0);
+    basis_factor_btran(factor_ptr, rho_p);
+
+    if (pricing_ptr->rule == PRICING_STEEPEST_EDGE) {
+        gsl_vector_memcpy(w, alpha_q);
+        basis_factor_btran(factor_ptr, w);
+    }
+
+    pricing_weights_t update = {pricing_ptr, A, N, rho_p, w, q, alpha_pq, weight_q};
+    uint32_t reset = parallel_reduce(pricing_ptr->size, PARALLEL_MAX, pricing_weights_block, &update).index != -1;
+
+    // The leaving variable takes position q in N
+    pricing_remove_candidate(pricing_ptr, q);
+
+    double leaving = weight_q / (alpha_pq * alpha_pq);
+    pricing_ptr->weights[q] = leaving > 1.0 ? leaving : 1.0;
+
+    if (reset) {
+        pricing_devex_reset(pricing_ptr);
+    }
+}
+
+void pricing_free(pricing_t* pricing_ptr) {
+    if (!pricing_ptr) {
+        return;
+    }
+
+    free(pricing_ptr->weights);
+    free(pricing_ptr->candidates);
+    free(pricing_ptr->candidate_scores);
+    free(pricing_ptr->data);
+    pricing_ptr->weights = NULL;
+    pricing_ptr->candidates = NULL;
+    pricing_ptr->candidate_scores = NULL;
+    pricing_ptr->data = NULL;
+    pricing_ptr->candidate_n = 0;
+    pricing_ptr->max_n = 0;
+    pricing_ptr->max_m = 0;
+    pricing_ptr->max_candidates = 0;
+}
@@ -1,14 +1,100 @@
 #include "simplex/primal.h"
+#include "simplex/dual.h"
 #include "simplex/utils.h"
+#include "simplex/pricing.h"
+#include "simplex/perturb.h"
 #include "utils.h"
+#include "kernels.h"
 
+#include <math.h>
+#include <string.h>
 #include <gsl/gsl_linalg.h>
 
+// Replaces the artificial variables still in the basis at zero level with structural ones.
+// Artificials on redundant rows cannot be replaced and are left in the basis
+uint32_t drive_out_artificials(uint32_t n, uint32_t m, const csc_matrix_t* A, int32_t* B, var_state_t* state,
+                               const options_t* opts_ptr) {
+    uint32_t ret = 1;
+
+    basis_factor_t factor = {0};
+    gsl_vector* rho = gsl_vector_alloc(n);
+    uint32_t* is_basic = (uint32_t*)calloc(m, sizeof(uint32_t));
+    if (!rho || !is_basic || !basis_factor_init(&factor, n, opts_ptr->refactor_period) ||
+        !basis_factor_refactor(&factor, A, B)) {
+        goto fail;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (B[i] < (int32_t)m) {
+            is_basic[B[i]] = 1;
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (B[i] < (int32_t)m) {
+            continue;
+        }
+
+        // Row i of AB_inv * A tells which columns can replace the artificial
+        gsl_vector_set_zero(rho);
+        gsl_vector_set(rho, i, 1.0);
+        basis_factor_btran(&factor, rho);
+
+        for (uint32_t j = 0; j < m; j++) {
+            if (!is_basic[j] && fabs(csc_column_dot(A, j, rho)) > 1e-9) {
+                B[i] = (int32_t)j;
+                is_basic[j] = 1;
+                state[j] = VAR_STATE_BASIC;
+                if (!basis_factor_refactor(&factor, A, B)) {
+                    goto fail;
+                }
+                break;
+            }
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    basis_factor_free(&factor);
+    gsl_vector_free(rho);
+    free(is_basic);
+    return ret;
+}
+
+// Negates the artificial columns (one nonzero each) that are basic at a negative value, so that
+// the starting basis of PhaseI is feasible. xB receives the values of the basic variables
+uint32_t artificial_signs(uint32_t n, uint32_t variables_num, csc_matrix_t* A, const gsl_vector* b,
+                          const var_arr_t* var_arr_ptr, const int32_t* B, const int32_t* N, const var_state_t* state,
+                          const options_t* opts_ptr, gsl_vector* xB) {
+    basis_factor_t factor = {0};
+    if (!basis_factor_init(&factor, n, opts_ptr->refactor_period) || !basis_factor_refactor(&factor, A, B)) {
+        basis_factor_free(&factor);
+        return 0;
+    }
+
+    compute_basic_solution(&factor, A, b, n, variables_num, N, var_arr_ptr, state, xB);
+    for (uint32_t i = 0; i < n; i++) {
+        if (B[i] >= (int32_t)(variables_num - n) && gsl_vector_get(xB, i) < 0.0) {
+            A->values[A->col_ptr[B[i]]] = -1.0;
+            gsl_vector_set(xB, i, -gsl_vector_get(xB, i));
+        }
+    }
+
+    basis_factor_free(&factor);
+    return 1;
+}
+
 // Find problem basis indices with Phase 1 method
-uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, uint32_t is_max, gsl_vector* c, gsl_matrix* A, gsl_vector* b,
-                               int32_t* B, var_arr_t* var_arr_ptr, uint32_t* iter_n_ptr) {
+uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, csc_matrix_t* A, const gsl_vector* b, int32_t* B,
+                               var_arr_t* var_arr_ptr, var_state_t* state, const options_t* opts_ptr,
+                               uint32_t* iter_n_ptr, uint32_t* is_infeasible_ptr) {
     int32_t* artificial_B = NULL;
     int32_t* artificial_N = NULL;
+    gsl_vector* artificial_c = NULL;
+    gsl_vector* artificial_xB = NULL;
 
     // Augmented capacity for phaseI
     uint32_t variables_num = m + n;
@@ -17,15 +103,21 @@ uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, uint32_t is_max, gsl_vect
     solution_t phaseI_solution = {0};
 
     uint32_t ret = 1;
+    *is_infeasible_ptr = 0;
+
+    if (A->cols != m || A->col_capacity < variables_num) {
+        fprintf(stderr, "Not enough room for the artificial variables of PhaseI\n");
+        return 0;
+    }
 
-    // Create artificial base
+    // Create artificial base, keeping the structural columns of the crash basis
     artificial_B = (int32_t*)malloc(sizeof(int32_t) * n);
     if (!artificial_B) {
         fprintf(stderr, "Failed to allocate array of artificial base indices for PhaseI\n");
         goto fail;
     }
     for (uint32_t i = 0; i < n; i++) {
-        artificial_B[i] = (int32_t)(m + i);
+        artificial_B[i] = B[i] >= 0 ? B[i] : (int32_t)(m + i);
     }
 
     artificial_N = calculate_nonbasis(artificial_B, constraints_num, variables_num);
@@ -34,44 +126,67 @@ uint32_t simplex_primal_phaseI(uint32_t n, uint32_t m, uint32_t is_max, gsl_vect
         goto fail;
     }
 
-    // Set the costs for the artificial variables
+    // PhaseI objective: maximize the opposite of the sum of the artificial variables
+    artificial_c = gsl_vector_calloc(variables_num);
+    if (!artificial_c) {
+        goto fail;
+    }
     for (uint32_t i = m; i < variables_num; i++) {
-        gsl_vector_set(c, i, is_max ? -1.0 : 1.0);
+        gsl_vector_set(artificial_c, i, -1.0);
     }
 
-    // Add values for artificial variables on each row of the A matrix
+    // Add an artificial unit column for each row of the A matrix
     for (uint32_t i = 0; i < constraints_num; i++) {
-        gsl_matrix_set(A, i, m + i, 1.0);
+        double one = 1.0;
+        if (!csc_push_column(A, &i, &one, 1)) {
+            goto fail;
+        }
     }
 
     variable_t v;
     for (uint32_t i = m; i < variables_num; i++) {
-        if (!variable_init_real_positive(&v, 10e9) || !var_arr_push(var_arr_ptr, &v)) {
+        if (!variable_init_real_positive(&v, VARIABLE_INF) || !var_arr_push(var_arr_ptr, &v)) {
             goto fail;
         }
     }
 
+    // Every nonbasic variable starts at its lower bound
+    for (uint32_t j = 0; j < variables_num; j++) {
+        state[j] = VAR_STATE_LOWER;
+    }
+
+    // Flip the sign of the artificial columns whose variable would start negative
+    artificial_xB = gsl_vector_alloc(n);
+    if (!artificial_xB || !artificial_signs(n, variables_num, A, b, var_arr_ptr, artificial_B, artificial_N,
+                                            state, opts_ptr, artificial_xB)) {
+        goto fail;
+    }
+
     // The PhaseI problem doesn't need another PhaseI, it always
     // has a feasible base and goes straight to PhaseII
     *iter_n_ptr = 0;
-    if (!simplex_primal(constraints_num, variables_num, is_max, c, A, b, artificial_B, artificial_N, &phaseI_solution,
-                        iter_n_ptr)) {
+    if (!simplex_primal(constraints_num, variables_num, 1, artificial_c, A, b, var_arr_ptr, artificial_B, artificial_N,
+                        state, opts_ptr, NULL, &phaseI_solution, iter_n_ptr)) {
         fprintf(stderr, "Failed to run primal simplex on PhaseI problem\n");
         goto fail;
     }
 
+    // An artificial variable left basic above 0 means the original problem has no feasible base
     const gsl_vector* x = solution_x(&phaseI_solution);
     for (uint32_t i = 0; i < n; i++) {
         int32_t var_idx = artificial_B[i];
-        uint32_t is_var_artificial = var_idx >= (int32_t)m;
-
-        // If the variable in basis is artificial make sure its value is 0
-        if (is_var_artificial && gsl_vector_get(x, var_idx) > 1e-8) {
-            fprintf(stderr, "No feasible base for original problem\n");
-            goto fail;
+        if (var_idx >= (int32_t)m && gsl_vector_get(x, var_idx) > 1e-8) {
+            // Without the artificial columns the problem can be prepared again, e.g. for a new RHS
+            csc_truncate(A, n, m);
+            var_arr_ptr->length = m;
+            *is_infeasible_ptr = 1;
+            goto cleanup;
         }
+    }
+    memcpy(B, artificial_B, sizeof(int32_t) * n);
 
-        B[i] = var_idx;
+    if (!drive_out_artificials(n, m, A, B, state, opts_ptr)) {
+        goto fail;
     }
 
     goto cleanup;
@@ -81,12 +196,50 @@ fail:
 cleanup:
     free(artificial_B);
     free(artificial_N);
+    gsl_vector_free(artificial_c);
+    gsl_vector_free(artificial_xB);
     solution_free(&phaseI_solution);
     return ret;
 }
 
-uint32_t simplex_primal(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const gsl_matrix* A,
-                        const gsl_vector* b, int32_t* B, int32_t* N, solution_t* solution_ptr, uint32_t* iter_n_ptr) {
+// Ratio test of Bland's rule, which breaks ties with the smallest variable index
+int32_t ratio_test_bland(uint32_t n, const int32_t* B, const gsl_vector* xB, const gsl_vector* d, double sign,
+                         const gsl_vector* lbB, const gsl_vector* ubB, double* min_ratio_ptr, uint32_t* to_upper_ptr) {
+    int32_t p = -1;
+    for (uint32_t i = 0; i < n; i++) {
+        double di = sign * gsl_vector_get(d, i);
+        double xi = gsl_vector_get(xB, i);
+
+        double ratio;
+        uint32_t to_upper;
+        if (di > 1e-9) {
+            // Decreasing towards the lower bound
+            ratio = (xi - gsl_vector_get(lbB, i)) / di;
+            to_upper = 0;
+        } else if (di < -1e-9 && gsl_vector_get(ubB, i) < VARIABLE_INF) {
+            // Increasing towards the upper bound
+            ratio = (gsl_vector_get(ubB, i) - xi) / -di;
+            to_upper = 1;
+        } else {
+            continue;
+        }
+        ratio = ratio > 0.0 ? ratio : 0.0;
+
+        uint32_t tie = p != -1 && ratio <= *min_ratio_ptr + 1e-12 && B[i] < B[p];
+        if (ratio < *min_ratio_ptr || tie) {
+            *min_ratio_ptr = ratio;
+            *to_upper_ptr = to_upper;
+            p = i;
+        }
+    }
+
+    return p;
+}
+
+uint32_t simplex_primal(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                        const gsl_vector* b, const var_arr_t* var_arr_ptr, int32_t* B, int32_t* N,
+                        var_state_t* state, const options_t* opts_ptr, simplex_workspace_t* workspace_ptr,
+                        solution_t* solution_ptr, uint32_t* iter_n_ptr) {
     if (!c || !A || !B || !N || !solution_ptr || !iter_n_ptr) {
         fprintf(stderr, "Some arguments are NULL in simplex_primal\n");
         return 0;
@@ -94,94 +247,185 @@ uint32_t simplex_primal(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vecto
 
     uint32_t ret = 1;
 
-    gsl_matrix* AB = gsl_matrix_alloc(n, n);
-    gsl_matrix* AB_inv = NULL;
-    gsl_vector* xB = gsl_vector_alloc(n);
-    gsl_vector* cB = gsl_vector_alloc(n);
-    gsl_vector* cN = gsl_vector_alloc(m - n);
-    gsl_vector* r = gsl_vector_alloc(m - n);
+    options_t default_opts;
+    if (!opts_ptr) {
+        options_init(&default_opts);
+        opts_ptr = &default_opts;
+    }
+
+    // A one-off solve gets a workspace sized for this problem only
+    simplex_workspace_t own_workspace = {0};
+    if (!workspace_ptr) {
+        if (!simplex_workspace_init(&own_workspace, n, m, opts_ptr)) {
+            return 0;
+        }
+        workspace_ptr = &own_workspace;
+    }
+
+    if (!simplex_workspace_prepare(workspace_ptr, n, m)) {
+        goto fail;
+    }
+
+    basis_factor_t* factor_ptr = &workspace_ptr->factor;
+    pricing_t* pricing_ptr = &workspace_ptr->pricing;
+    gsl_vector* xB = &workspace_ptr->xB.vector;
+    gsl_vector* y = &workspace_ptr->y.vector;
+    gsl_vector* r = &workspace_ptr->r.vector;
+    gsl_vector* d = &workspace_ptr->d.vector;
+    gsl_vector* lbB = &workspace_ptr->lbB.vector;
+    gsl_vector* ubB = &workspace_ptr->ubB.vector;
+    gsl_vector* b_pert = &workspace_ptr->b_pert.vector;
+    gsl_vector* c_pert = &workspace_ptr->c_pert.vector;
+
+    // Without a state every nonbasic variable starts at its lower bound
+    if (!state) {
+        state = workspace_ptr->state;
+        memset(state, 0, sizeof(var_state_t) * m);
+    }
+    normalize_states(n, m, B, N, var_arr_ptr, state);
+
+    // Factorize AB once (unless the caller kept the factors of the last solve), then keep it up to date
+    // with eta updates
+    uint32_t keep_factor = workspace_ptr->keep_factor;
+    workspace_ptr->keep_factor = 0;
+    if (!keep_factor && !basis_factor_refactor(factor_ptr, A, B)) {
+        goto fail;
+    }
 
-    if (!AB || !xB || !cB || !cN || !r) {
+    if (!pricing_init(pricing_ptr, opts_ptr, n, m, A, N, factor_ptr)) {
         goto fail;
     }
 
+    // A cleanup solve falls back to Bland's rule instead of perturbing again. It has to end optimal for the
+    // original c and b: a smaller perturbation or shifted bounds would leave it optimal for yet another problem,
+    // whose own cleanup can stall in turn, and nothing bounds that chain. Bland's rule cannot cycle, so the
+    // cleanup terminates; it starts from a nearly optimal basis, so it rarely stalls for PERTURB_STALL pivots
+    uint32_t can_perturb = !workspace_ptr->is_cleanup;
+    workspace_ptr->is_cleanup = 0;
+    workspace_ptr->iter_limit = 0;
+    perturb_t perturb;
+    perturb_init(&perturb);
+    const gsl_vector* c_cur = c;
+    const gsl_vector* b_cur = b;
+
     *iter_n_ptr = 0;
     uint32_t unbounded = 0;
+    uint32_t degenerate_n = 0;
     while (1) {
-        // Extract AB matrix and cB vector
-        extract_basic_objects(n, is_max, B, c, A, cB, AB);
-
-        // Compute AB_inv = AB^-1
-        gsl_matrix* old = AB_inv;
-        AB_inv = inverse(AB, n);
-        gsl_matrix_free(old);
-        if (!AB_inv) {
-            goto fail;
+        // Stalling on degenerate pivots: perturb the costs, which breaks the ties of pricing, and the RHS,
+        // which moves the basic variables off their bounds
+        if (can_perturb && degenerate_n >= PERTURB_STALL) {
+            if (perturb.count == 0) {
+                for (uint32_t j = 0; j < m; j++) {
+                    gsl_vector_set(c_pert, j, gsl_vector_get(c, j));
+                }
+                gsl_vector_memcpy(b_pert, b);
+                c_cur = c_pert;
+                b_cur = b_pert;
+            }
+            perturb_costs(&perturb, n, m, is_max, N, state, c_pert);
+            compute_basic_solution(factor_ptr, A, b_cur, n, m, N, var_arr_ptr, state, xB);
+            basic_bounds(n, B, var_arr_ptr, lbB, ubB);
+            perturb_rhs(&perturb, n, B, A, xB, lbB, ubB, b_pert);
+            perturb.count++;
+            degenerate_n = 0;
         }
 
-        // Compute xB = AB_inv * b
-        compute_basic_solution(AB_inv, b, xB);
+        // Simplex multipliers y = AB_inv^T * cB, so that pricing only needs a dot product per column
+        compute_duals(n, is_max, B, c_cur, factor_ptr, y);
 
-        // For all non-basic variables
-        compute_reduced_costs(n, m, is_max, N, c, cB, cN, A, AB_inv, r);
+        // Compute xB = AB_inv * (b - AN * xN)
+        compute_basic_solution(factor_ptr, A, b_cur, n, m, N, var_arr_ptr, state, xB);
 
-        // Choose the entering variable
-        int32_t q = -1;
-        for (uint32_t i = 0; i < (m - n); i++) {
-            if (gsl_vector_get(r, i) > 0) {
-                q = i;
-                break;  // Bland's rule: choose first positive reduced cost
-            }
-        }
+        // Price the non-basic variables and choose the entering one. A stall that is not perturbed away, that is
+        // one of a cleanup solve, is left to Bland's rule
+        uint32_t use_bland = opts_ptr->pricing == PRICING_BLAND || degenerate_n >= PERTURB_STALL;
+        int32_t q = pricing_select(pricing_ptr, is_max, c_cur, y, A, N, state, r, use_bland);
 
         if (q == -1) {
             break;  // Optimal
         }
 
-        // Aq
-        gsl_vector* Aq = gsl_vector_alloc(n);
-        if (!extract_column(A, (uint32_t)N[q], Aq)) {
+        // Compute alpha_q = AB_inv * Aq (the direction vector is d = -alpha_q)
+        uint32_t entering = (uint32_t)N[q];
+        if (!extract_column(A, entering, d)) {
             goto fail;
         }
+        basis_factor_ftran(factor_ptr, d);
 
-        // Compute direction vector d = -AB_inv * Aq
-        gsl_vector* d = gsl_vector_alloc(n);
-        gsl_blas_dgemv(CblasNoTrans, -1.0, AB_inv, Aq, 0.0, d);
+        // The entering variable increases from its lower bound or decreases from its upper one
+        double sign = state[entering] == VAR_STATE_UPPER ? -1.0 : 1.0;
 
-        // Choose leaving variable
+        // Choose leaving variable, the first basic one to reach a bound
+        basic_bounds(n, B, var_arr_ptr, lbB, ubB);
         double min_ratio = 1e20;
-        int32_t p = -1;
-        for (uint32_t i = 0; i < n; i++) {
-            double di = gsl_vector_get(d, i);
-            // Only include variables with negative direction coefficient
-            if (di < 0.0) {
-                double ratio = -gsl_vector_get(xB, i) / di;
-                if (ratio < min_ratio) {
-                    min_ratio = ratio;
-                    p = i;
-                }
-            }
+        uint32_t to_upper = 0;
+        int32_t p = use_bland ? ratio_test_bland(n, B, xB, d, sign, lbB, ubB, &min_ratio, &to_upper)
+                              : kernel_ratio_test(n, xB->data, d->data, sign, lbB->data, ubB->data, &min_ratio,
+                                                  &to_upper);
+        var_state_t leaving_state = to_upper ? VAR_STATE_UPPER : VAR_STATE_LOWER;
+        if (p != -1 && var_lb(var_arr_ptr, B[p]) == var_ub(var_arr_ptr, B[p])) {
+            leaving_state = VAR_STATE_FIXED;
+        }
+
+        // The entering variable can reach its other bound first: flip it without changing the basis
+        double range = var_ub(var_arr_ptr, entering) - var_lb(var_arr_ptr, entering);
+        if (var_ub(var_arr_ptr, entering) < VARIABLE_INF && range <= min_ratio) {
+            state[entering] = state[entering] == VAR_STATE_UPPER ? VAR_STATE_LOWER : VAR_STATE_UPPER;
+            degenerate_n = 0;
+            (*iter_n_ptr)++;
+            continue;
         }
 
         // Unbounded
         if (p == -1) {
             unbounded = 1;
-            gsl_vector_free(Aq);
-            gsl_vector_free(d);
             break;
         }
 
+        degenerate_n = min_ratio < 1e-12 ? degenerate_n + 1 : degenerate_n / 2;
+
+        pricing_update(pricing_ptr, A, N, factor_ptr, (uint32_t)p, (uint32_t)q, d);
+
+        state[B[p]] = leaving_state;
+        state[entering] = VAR_STATE_BASIC;
         pivot(q, p, B, N);
 
-        gsl_vector_free(Aq);
-        gsl_vector_free(d);
+        if (!basis_factor_update(factor_ptr, A, B, (uint32_t)p, d)) {
+            goto fail;
+        }
 
         (*iter_n_ptr)++;
     }
 
+    // Remove the perturbation from the same factors. The basis is optimal for the perturbed problem, so it is
+    // dual feasible for the original RHS: the dual simplex restores primal feasibility, then the primal
+    // simplex restores the optimality for the original costs
+    if (perturb.count > 0 && !unbounded) {
+        uint32_t cleanup_n = 0;
+        solution_t feasible = {0};
+        workspace_ptr->keep_factor = 1;
+        workspace_ptr->is_cleanup = 1;
+        ret = simplex_dual(n, m, is_max, c_pert, A, b, var_arr_ptr, B, N, state, opts_ptr, workspace_ptr, &feasible,
+                           &cleanup_n);
+        *iter_n_ptr += cleanup_n;
+        if (!ret || feasible.is_unbounded) {
+            *solution_ptr = feasible;
+            goto cleanup;
+        }
+        solution_free(&feasible);
+
+        workspace_ptr->keep_factor = 1;
+        workspace_ptr->is_cleanup = 1;
+        ret = simplex_primal(n, m, is_max, c, A, b, var_arr_ptr, B, N, state, opts_ptr, workspace_ptr, solution_ptr,
+                             &cleanup_n);
+        *iter_n_ptr += cleanup_n;
+        goto cleanup;
+    }
+
     // Extract optimal solution and value
     if (solution_init(solution_ptr, n, m + n, unbounded) && !unbounded) {
-        extract_optimal(n, is_max, B, xB, c, solution_ptr);
+        extract_optimal(n, m, is_max, B, N, xB, c, var_arr_ptr, state, solution_ptr);
     }
 
     goto cleanup;
@@ -190,11 +434,6 @@ fail:
     ret = 0;
 
 cleanup:
-    gsl_matrix_free(AB);
-    gsl_matrix_free(AB_inv);
-    gsl_vector_free(xB);
-    gsl_vector_free(cB);
-    gsl_vector_free(cN);
-    gsl_vector_free(r);
+    simplex_workspace_free(&own_workspace);
     return ret;
-}
\ No newline at end of file
+}
@@ -3,93 +3,92 @@
 
 #include <gsl/gsl_linalg.h>
 
-void extract_basic_objects(uint32_t n, uint32_t is_max, int32_t* B, const gsl_vector* c, const gsl_matrix* A,
-                           gsl_vector* cB, gsl_matrix* AB) {
+void extract_basic_costs(uint32_t n, uint32_t is_max, const int32_t* B, const gsl_vector* c, gsl_vector* cB) {
     for (uint32_t i = 0; i < n; i++) {
-        for (uint32_t j = 0; j < n; j++) {
-            // Basis indices must be valid column indices
-            gsl_matrix_set(AB, i, j, gsl_matrix_get(A, i, B[j]));
-        }
         double ci = gsl_vector_get(c, B[i]);
         gsl_vector_set(cB, i, is_max ? ci : -ci);
     }
 }
 
-gsl_matrix* inverse(const gsl_matrix* base, size_t size) {
-    gsl_matrix* inverse = gsl_matrix_alloc(size, size);
-    if (!inverse) {
-        return NULL;
-    }
-
-    gsl_permutation* p = gsl_permutation_alloc(size);
-    if (!p) {
-        gsl_matrix_free(inverse);
-        return NULL;
-    }
-
-    int signum;
-    gsl_matrix_memcpy(inverse, base);
-    gsl_linalg_LU_decomp(inverse, p, &signum);
-    gsl_linalg_LU_invert(inverse, p, inverse);
+double var_lb(const var_arr_t* var_arr_ptr, uint32_t j) {
+    return var_arr_ptr ? var_arr_get(var_arr_ptr, j)->lb : 0.0;
+}
 
-    gsl_permutation_free(p);
+double var_ub(const var_arr_t* var_arr_ptr, uint32_t j) {
+    return var_arr_ptr ? var_arr_get(var_arr_ptr, j)->ub : VARIABLE_INF;
+}
 
-    return inverse;
+double nonbasic_value(const var_arr_t* var_arr_ptr, const var_state_t* state, uint32_t j) {
+    return state[j] == VAR_STATE_UPPER ? var_ub(var_arr_ptr, j) : var_lb(var_arr_ptr, j);
 }
 
-void compute_basic_solution(const gsl_matrix* AB_inv, const gsl_vector* b, gsl_vector* xB) {
-    gsl_blas_dgemv(CblasNoTrans, 1.0, AB_inv, b, 0.0, xB);
+void basic_bounds(uint32_t n, const int32_t* B, const var_arr_t* var_arr_ptr, gsl_vector* lbB, gsl_vector* ubB) {
+    for (uint32_t i = 0; i < n; i++) {
+        gsl_vector_set(lbB, i, var_lb(var_arr_ptr, B[i]));
+        gsl_vector_set(ubB, i, var_ub(var_arr_ptr, B[i]));
+    }
 }
 
-void compute_reduced_costs(uint32_t n, uint32_t m, uint32_t is_max, int32_t* N, const gsl_vector* c, gsl_vector* cB,
-                           gsl_vector* cN, const gsl_matrix* A, const gsl_matrix* AB_inv, gsl_vector* r) {
-    for (uint32_t i = 0; i < (m - n); i++) {
+void normalize_states(uint32_t n, uint32_t m, const int32_t* B, const int32_t* N, const var_arr_t* var_arr_ptr,
+                      var_state_t* state) {
+    for (uint32_t i = 0; i < n; i++) {
+        state[B[i]] = VAR_STATE_BASIC;
+    }
+
+    for (uint32_t i = 0; i < m - n; i++) {
         uint32_t j = N[i];
+        double lb = var_lb(var_arr_ptr, j);
+        double ub = var_ub(var_arr_ptr, j);
+        if (lb == ub) {
+            state[j] = VAR_STATE_FIXED;
+        } else if (state[j] != VAR_STATE_UPPER || ub >= VARIABLE_INF) {
+            state[j] = VAR_STATE_LOWER;
+        }
+    }
+}
 
-        // cN[i] = cj
-        double cj = gsl_vector_get(c, j);
-        gsl_vector_set(cN, i, is_max ? cj : -cj);
+void compute_basic_solution(const basis_factor_t* factor_ptr, const csc_matrix_t* A, const gsl_vector* b, uint32_t n,
+                            uint32_t m, const int32_t* N, const var_arr_t* var_arr_ptr, const var_state_t* state,
+                            gsl_vector* xB) {
+    gsl_vector_memcpy(xB, b);
 
-        // Aj
-        gsl_vector* Aj = gsl_vector_alloc(n);
-        for (uint32_t k = 0; k < n; k++) {
-            gsl_vector_set(Aj, k, gsl_matrix_get(A, k, j));
+    // Move the nonbasic variables that are not at zero to the right hand side
+    for (uint32_t i = 0; i < m - n; i++) {
+        double xj = nonbasic_value(var_arr_ptr, state, (uint32_t)N[i]);
+        if (xj != 0.0) {
+            csc_column_axpy(A, (uint32_t)N[i], -xj, xB);
         }
+    }
 
-        // AB_inv * Aj
-        gsl_vector* Ab_inv_aj = gsl_vector_alloc(n);
-        gsl_blas_dgemv(CblasNoTrans, 1.0, AB_inv, Aj, 0.0, Ab_inv_aj);
-
-        // r[i] = rj = cj - cB * AB_inv * Aj
-        double res;
-        gsl_blas_ddot(cB, Ab_inv_aj, &res);
-        gsl_vector_set(r, i, gsl_vector_get(cN, i) - res);
+    basis_factor_ftran(factor_ptr, xB);
+}
 
-        gsl_vector_free(Aj);
-        gsl_vector_free(Ab_inv_aj);
-    }
+void compute_duals(uint32_t n, uint32_t is_max, const int32_t* B, const gsl_vector* c,
+                   const basis_factor_t* factor_ptr, gsl_vector* y) {
+    extract_basic_costs(n, is_max, B, c, y);
+    basis_factor_btran(factor_ptr, y);
 }
 
-uint32_t extract_column(const gsl_matrix* m, uint32_t j, gsl_vector* col) {
-    if (!m || !col) {
-        return 0;
-    }
+// rj = cj - y * Aj
+double compute_reduced_cost(uint32_t is_max, uint32_t j, const gsl_vector* c, const gsl_vector* y,
+                            const csc_matrix_t* A) {
+    double cj = c->data[j * c->stride];
+    return (is_max ? cj : -cj) - csc_column_dot(A, j, y);
+}
 
-    for (uint32_t i = 0; i < col->size; i++) {
-        gsl_vector_set(col, i, gsl_matrix_get(m, i, j));
+void compute_reduced_costs(uint32_t n, uint32_t m, uint32_t is_max, const int32_t* N, const gsl_vector* c,
+                           const gsl_vector* y, const csc_matrix_t* A, gsl_vector* r) {
+    for (uint32_t i = 0; i < (m - n); i++) {
+        r->data[i * r->stride] = compute_reduced_cost(is_max, (uint32_t)N[i], c, y, A);
     }
-
-    return 1;
 }
 
-uint32_t extract_row(const gsl_matrix* m, uint32_t i, gsl_vector* row) {
-    if (!m || !row) {
+uint32_t extract_column(const csc_matrix_t* A, uint32_t j, gsl_vector* col) {
+    if (!A || !col || j >= A->cols) {
         return 0;
     }
 
-    for (uint32_t j = 0; j < row->size; j++) {
-        gsl_vector_set(row, j, gsl_matrix_get(m, i, j));
-    }
+    csc_column_scatter(A, j, col);
 
     return 1;
 }
@@ -100,14 +99,23 @@ void pivot(int32_t entering, int32_t leaving, int32_t* B, int32_t* N) {
     N[entering] = tmp;
 }
 
-void extract_optimal(uint32_t n, uint32_t is_max, int32_t* B, gsl_vector* xB, const gsl_vector* c,
+void extract_optimal(uint32_t n, uint32_t m, uint32_t is_max, const int32_t* B, const int32_t* N, const gsl_vector* xB,
+                     const gsl_vector* c, const var_arr_t* var_arr_ptr, const var_state_t* state,
                      solution_t* solution_ptr) {
     gsl_vector* x = solution_x_mut(solution_ptr);
     double z = 0.0;
     for (uint32_t i = 0; i < n; i++) {
-        gsl_vector_set(x, B[i], gsl_vector_get(xB, i));
+        double xi = gsl_vector_get(xB, i);
+        gsl_vector_set(x, B[i], xi);
+        z += gsl_vector_get(c, B[i]) * xi;
+    }
+
+    // Nonbasic variables sit on one of their bounds
+    for (uint32_t i = 0; i < m - n; i++) {
+        double xj = nonbasic_value(var_arr_ptr, state, (uint32_t)N[i]);
+        gsl_vector_set(x, N[i], xj);
+        z += gsl_vector_get(c, N[i]) * xj;
     }
 
-    gsl_blas_ddot(c, x, &z);
     solution_set_z(solution_ptr, is_max ? z : -z);
 }
@@ -0,0 +1,376 @@
+#include "simplex/warm.h"
+#include "simplex/utils.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_linalg.h>
+
+/* BASIS FILE */
+
+char var_state_to_char(var_state_t state) {
+    switch (state) {
+        case VAR_STATE_BASIC:
+            return 'B';
+        case VAR_STATE_UPPER:
+            return 'U';
+        case VAR_STATE_FIXED:
+            return 'F';
+        case VAR_STATE_LOWER:
+        default:
+            return 'L';
+    }
+}
+
+uint32_t basis_write(const char* filename, uint32_t n, uint32_t m, const var_state_t* state) {
+    if (!filename || !state) {
+        return 0;
+    }
+
+    FILE* stream = fopen(filename, "w");
+    if (!stream) {
+        fprintf(stderr, "Failed to open basis file %s\n", filename);
+        return 0;
+    }
+
+    fprintf(stream, "%u %u\n", n, m);
+    for (uint32_t j = 0; j < m; j++) {
+        fputc(var_state_to_char(state[j]), stream);
+    }
+    fputc('\n', stream);
+
+    return fclose(stream) == 0;
+}
+
+uint32_t basis_read(const char* filename, uint32_t n, uint32_t m, var_state_t* state) {
+    if (!filename || !state) {
+        return 0;
+    }
+
+    FILE* stream = fopen(filename, "r");
+    if (!stream) {
+        fprintf(stderr, "Failed to open basis file %s\n", filename);
+        return 0;
+    }
+
+    uint32_t ret = 1;
+    uint32_t file_n;
+    uint32_t file_m;
+    if (fscanf(stream, "%u %u", &file_n, &file_m) != 2 || file_n != n || file_m != m) {
+        fprintf(stderr, "Basis file %s does not belong to a problem with %u rows and %u columns\n", filename, n, m);
+        goto fail;
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+        char s;
+        if (fscanf(stream, " %c", &s) != 1) {
+            fprintf(stderr, "Failed to read the state of variable %u from basis file %s\n", j, filename);
+            goto fail;
+        }
+
+        switch (s) {
+            case 'B':
+                state[j] = VAR_STATE_BASIC;
+                break;
+            case 'U':
+                state[j] = VAR_STATE_UPPER;
+                break;
+            case 'F':
+                state[j] = VAR_STATE_FIXED;
+                break;
+            case 'L':
+                state[j] = VAR_STATE_LOWER;
+                break;
+            default:
+                fprintf(stderr, "Unknown state '%c' of variable %u in basis file %s\n", s, j, filename);
+                goto fail;
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    fclose(stream);
+    return ret;
+}
+
+/* REPAIR */
+
+// Eliminates column j against the columns already in the basis (stored in L after their own
+// elimination) and, if a large enough pivot is left on an uncovered row, adds it to the basis
+uint32_t basis_repair_try(const csc_matrix_t* A, uint32_t j, gsl_matrix* L, int32_t* pivot_rows, uint32_t* covered,
+                          uint32_t covered_n, gsl_vector* a, int32_t* B) {
+    uint32_t n = a->size;
+    gsl_vector_set_zero(a);
+    csc_column_scatter(A, j, a);
+
+    double col_max = 0.0;
+    for (uint32_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+        col_max = fmax(col_max, fabs(A->values[k]));
+    }
+    if (col_max == 0.0) {
+        return 0;
+    }
+
+    for (uint32_t k = 0; k < covered_n; k++) {
+        uint32_t r = (uint32_t)pivot_rows[k];
+        double f = gsl_vector_get(a, r) / gsl_matrix_get(L, r, k);
+        if (f == 0.0) {
+            continue;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            gsl_vector_set(a, i, gsl_vector_get(a, i) - f * gsl_matrix_get(L, i, k));
+        }
+    }
+
+    int32_t best = -1;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!covered[i] && (best == -1 || fabs(gsl_vector_get(a, i)) > fabs(gsl_vector_get(a, best)))) {
+            best = (int32_t)i;
+        }
+    }
+    if (best == -1 || fabs(gsl_vector_get(a, best)) <= WARM_PIVOT_RATIO * col_max) {
+        return 0;
+    }
+
+    gsl_vector_view Lk = gsl_matrix_column(L, covered_n);
+    gsl_vector_memcpy(&Lk.vector, a);
+    pivot_rows[covered_n] = best;
+    covered[best] = 1;
+    B[best] = (int32_t)j;
+    return 1;
+}
+
+uint32_t basis_repair(uint32_t n, uint32_t m, const csc_matrix_t* A, const var_arr_t* var_arr_ptr,
+                      const var_state_t* start, const uint32_t* order, uint32_t fill, int32_t* B) {
+    for (uint32_t i = 0; i < n; i++) {
+        B[i] = -1;
+    }
+
+    uint32_t covered_n = 0;
+    gsl_matrix* L = gsl_matrix_alloc(n, n);
+    gsl_vector* a = gsl_vector_alloc(n);
+    int32_t* pivot_rows = (int32_t*)malloc(sizeof(int32_t) * n);
+    uint32_t* covered = (uint32_t*)calloc(n, sizeof(uint32_t));
+    uint32_t* is_basic = (uint32_t*)calloc(m, sizeof(uint32_t));
+    if (!L || !a || !pivot_rows || !covered || !is_basic) {
+        fprintf(stderr, "Failed to allocate the basis repair buffers\n");
+        goto cleanup;
+    }
+
+    // The basic columns of start first, then the other ones (fixed variables excluded) for the rows left
+    for (uint32_t pass = 0; pass < (fill ? 2 : 1); pass++) {
+        for (uint32_t k = 0; k < m && covered_n < n; k++) {
+            uint32_t j = order ? order[k] : k;
+            uint32_t was_basic = start[j] == VAR_STATE_BASIC;
+            if (is_basic[j] || was_basic != (pass == 0)) {
+                continue;
+            }
+            if (pass == 1 && var_lb(var_arr_ptr, j) == var_ub(var_arr_ptr, j)) {
+                continue;
+            }
+
+            if (basis_repair_try(A, j, L, pivot_rows, covered, covered_n, a, B)) {
+                is_basic[j] = 1;
+                covered_n++;
+            }
+        }
+    }
+
+cleanup:
+    gsl_matrix_free(L);
+    gsl_vector_free(a);
+    free(pivot_rows);
+    free(covered);
+    free(is_basic);
+    return covered_n;
+}
+
+// Values of the basic variables of B, where B[i] = -1 stands for the artificial unit column of row i,
+// with every nonbasic variable at its lower bound as PhaseI starts
+uint32_t warm_artificial_solution(uint32_t n, uint32_t m, const csc_matrix_t* A, const gsl_vector* b,
+                                  const var_arr_t* var_arr_ptr, const int32_t* B, gsl_matrix* AB,
+                                  gsl_permutation* perm, gsl_vector* rhs, gsl_vector* xB) {
+    gsl_vector_memcpy(rhs, b);
+    gsl_matrix_set_zero(AB);
+    uint32_t* is_basic = (uint32_t*)calloc(m, sizeof(uint32_t));
+    if (!is_basic) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (B[i] < 0) {
+            gsl_matrix_set(AB, i, i, 1.0);
+            continue;
+        }
+        is_basic[B[i]] = 1;
+        for (uint32_t k = A->col_ptr[B[i]]; k < A->col_ptr[B[i] + 1]; k++) {
+            gsl_matrix_set(AB, A->row_idx[k], i, A->values[k]);
+        }
+    }
+    for (uint32_t j = 0; j < m; j++) {
+        double lb = var_lb(var_arr_ptr, j);
+        if (!is_basic[j] && lb != 0.0) {
+            csc_column_axpy(A, j, -lb, rhs);
+        }
+    }
+    free(is_basic);
+
+    int signum;
+    gsl_linalg_LU_decomp(AB, perm, &signum);
+    gsl_linalg_LU_solve(AB, perm, rhs, xB);
+    return 1;
+}
+
+// Slack swaps: the basic variables out of their bounds leave the basis and their rows get an
+// artificial variable, until the structural part of the basis is feasible and PhaseI can start
+// from it. B receives the basis, -1 on the rows of the artificial variables
+uint32_t warm_swap_artificials(uint32_t n, uint32_t m, const csc_matrix_t* A, const gsl_vector* b,
+                               const var_arr_t* var_arr_ptr, const var_state_t* start, int32_t* B) {
+    uint32_t ret = 1;
+    var_state_t* kept = (var_state_t*)malloc(sizeof(var_state_t) * m);
+    gsl_matrix* AB = gsl_matrix_alloc(n, n);
+    gsl_permutation* perm = gsl_permutation_alloc(n);
+    gsl_vector* rhs = gsl_vector_alloc(n);
+    gsl_vector* xB = gsl_vector_alloc(n);
+    if (!kept || !AB || !perm || !rhs || !xB) {
+        fprintf(stderr, "Failed to allocate the slack swap buffers\n");
+        goto fail;
+    }
+
+    for (uint32_t j = 0; j < m; j++) {
+        kept[j] = start[j];
+    }
+
+    // Every round drops at least one column, so it ends within n rounds
+    uint32_t swapped_n = 1;
+    while (swapped_n > 0) {
+        basis_repair(n, m, A, var_arr_ptr, kept, NULL, 0, B);
+        if (!warm_artificial_solution(n, m, A, b, var_arr_ptr, B, AB, perm, rhs, xB)) {
+            goto fail;
+        }
+
+        swapped_n = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            if (B[i] < 0) {
+                continue;
+            }
+
+            double xi = gsl_vector_get(xB, i);
+            if (xi < var_lb(var_arr_ptr, B[i]) - WARM_FEAS_TOL || xi > var_ub(var_arr_ptr, B[i]) + WARM_FEAS_TOL) {
+                kept[B[i]] = VAR_STATE_LOWER;
+                swapped_n++;
+            }
+        }
+    }
+
+    goto cleanup;
+
+fail:
+    ret = 0;
+cleanup:
+    free(kept);
+    gsl_matrix_free(AB);
+    gsl_permutation_free(perm);
+    gsl_vector_free(rhs);
+    gsl_vector_free(xB);
+    return ret;
+}
+
+warm_start_t warm_start(uint32_t n, uint32_t m, uint32_t is_max, const gsl_vector* c, const csc_matrix_t* A,
+                        const gsl_vector* b, const var_arr_t* var_arr_ptr, const var_state_t* start,
+                        uint32_t allow_dual, const options_t* opts_ptr, int32_t* B, var_state_t* state) {
+    warm_start_t ret = WARM_START_NONE;
+    basis_factor_t factor = {0};
+    int32_t* N = NULL;
+    gsl_vector* xB = gsl_vector_alloc(n);
+    gsl_vector* y = gsl_vector_alloc(n);
+    gsl_vector* r = gsl_vector_alloc(m);
+    if (!xB || !y || !r || !basis_factor_init(&factor, n, opts_ptr->refactor_period)) {
+        goto cleanup;
+    }
+
+    // A singular basis is completed with other columns, one that stays singular goes to the slack swaps
+    if (basis_repair(n, m, A, var_arr_ptr, start, NULL, 1, B) < n) {
+        goto swap;
+    }
+    N = calculate_nonbasis(B, n, m);
+    if (!N) {
+        goto cleanup;
+    }
+    if (!basis_factor_refactor(&factor, A, B)) {
+        goto swap;
+    }
+
+    // Columns dropped from the basis by the repair start at their lower bound
+    for (uint32_t j = 0; j < m; j++) {
+        state[j] = start[j] == VAR_STATE_UPPER ? VAR_STATE_UPPER : VAR_STATE_LOWER;
+    }
+    normalize_states(n, m, B, N, var_arr_ptr, state);
+
+    compute_basic_solution(&factor, A, b, n, m, N, var_arr_ptr, state, xB);
+    uint32_t is_primal_feasible = 1;
+    for (uint32_t i = 0; i < n && is_primal_feasible; i++) {
+        double xi = gsl_vector_get(xB, i);
+        is_primal_feasible = xi >= var_lb(var_arr_ptr, B[i]) - WARM_FEAS_TOL &&
+                             xi <= var_ub(var_arr_ptr, B[i]) + WARM_FEAS_TOL;
+    }
+    if (is_primal_feasible) {
+        ret = WARM_START_PRIMAL;
+        goto cleanup;
+    }
+
+    if (!allow_dual) {
+        goto swap;
+    }
+
+    // The dual simplex moves boxed variables to the right bound by itself, so only the
+    // nonbasic variables without an upper bound need a nonpositive reduced cost
+    compute_duals(n, is_max, B, c, &factor, y);
+    compute_reduced_costs(n, m, is_max, N, c, y, A, r);
+    uint32_t is_dual_feasible = 1;
+    for (uint32_t i = 0; i < m - n && is_dual_feasible; i++) {
+        uint32_t j = (uint32_t)N[i];
+        is_dual_feasible = state[j] == VAR_STATE_FIXED || var_ub(var_arr_ptr, j) < VARIABLE_INF ||
+                           gsl_vector_get(r, i) <= WARM_FEAS_TOL;
+    }
+    if (is_dual_feasible) {
+        ret = WARM_START_DUAL;
+        goto cleanup;
+    }
+
+swap:
+    if (!warm_swap_artificials(n, m, A, b, var_arr_ptr, start, B)) {
+        goto cleanup;
+    }
+    ret = WARM_START_PHASE_I;
+
+    // Without swaps the basis is feasible once every nonbasic variable is at its lower bound
+    uint32_t swapped_n = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        swapped_n += B[i] < 0;
+    }
+    if (swapped_n == 0) {
+        free(N);
+        N = calculate_nonbasis(B, n, m);
+        if (N) {
+            for (uint32_t j = 0; j < m; j++) {
+                state[j] = VAR_STATE_LOWER;
+            }
+            normalize_states(n, m, B, N, var_arr_ptr, state);
+            ret = WARM_START_PRIMAL;
+        }
+    }
+
+cleanup:
+    basis_factor_free(&factor);
+    free(N);
+    gsl_vector_free(xB);
+    gsl_vector_free(y);
+    gsl_vector_free(r);
+    return ret;
+}
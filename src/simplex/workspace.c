@@ -0,0 +1,86 @@
+#include "simplex/workspace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Number of doubles reserved for a vector of at most len elements, a whole number of cache lines
+size_t workspace_stride(size_t len) {
+    size_t per_line = WORKSPACE_ALIGNMENT / sizeof(double);
+    return (len + per_line - 1) / per_line * per_line;
+}
+
+uint32_t simplex_workspace_init(simplex_workspace_t* workspace_ptr, uint32_t max_n, uint32_t max_m,
+                                const options_t* opts_ptr) {
+    if (!workspace_ptr || !opts_ptr || max_n == 0 || max_m < max_n) {
+        return 0;
+    }
+
+    workspace_ptr->max_n = max_n;
+    workspace_ptr->max_m = max_m;
+    workspace_ptr->keep_factor = 0;
+    workspace_ptr->is_cleanup = 0;
+    workspace_ptr->iter_limit = 0;
+
+    // Memory layout: [xB][y][d][rho_p][lbB][ubB][b_pert][r][alpha][dir][c_pert],
+    // each segment starting on a cache line
+    size_t size = sizeof(double) * (7 * workspace_stride(max_n) + 4 * workspace_stride(max_m));
+    workspace_ptr->data = (double*)aligned_alloc(WORKSPACE_ALIGNMENT, size);
+    workspace_ptr->state = (var_state_t*)malloc(sizeof(var_state_t) * max_m);
+    if (!workspace_ptr->data || !workspace_ptr->state ||
+        !basis_factor_init(&workspace_ptr->factor, max_n, opts_ptr->refactor_period) ||
+        !pricing_alloc(&workspace_ptr->pricing, max_n, max_m, opts_ptr->multiple_size) ||
+        !dual_pricing_alloc(&workspace_ptr->dual_pricing, max_n)) {
+        fprintf(stderr, "Failed to allocate the simplex workspace\n");
+        simplex_workspace_free(workspace_ptr);
+        return 0;
+    }
+
+    return 1;
+}
+
+uint32_t simplex_workspace_prepare(simplex_workspace_t* workspace_ptr, uint32_t n, uint32_t m) {
+    if (!workspace_ptr || n > workspace_ptr->max_n || m > workspace_ptr->max_m || m < n) {
+        fprintf(stderr, "Problem too big for the simplex workspace\n");
+        return 0;
+    }
+
+    double* data = workspace_ptr->data;
+    size_t ld_n = workspace_stride(workspace_ptr->max_n);
+    size_t ld_m = workspace_stride(workspace_ptr->max_m);
+    workspace_ptr->xB = gsl_vector_view_array(data, n);
+    workspace_ptr->y = gsl_vector_view_array(data + ld_n, n);
+    workspace_ptr->d = gsl_vector_view_array(data + 2 * ld_n, n);
+    workspace_ptr->rho_p = gsl_vector_view_array(data + 3 * ld_n, n);
+    workspace_ptr->lbB = gsl_vector_view_array(data + 4 * ld_n, n);
+    workspace_ptr->ubB = gsl_vector_view_array(data + 5 * ld_n, n);
+    workspace_ptr->b_pert = gsl_vector_view_array(data + 6 * ld_n, n);
+
+    // The views need at least one element
+    size_t nonbasic_n = m > n ? m - n : 1;
+    workspace_ptr->r = gsl_vector_view_array(data + 7 * ld_n, nonbasic_n);
+    workspace_ptr->alpha = gsl_vector_view_array(data + 7 * ld_n + ld_m, nonbasic_n);
+    workspace_ptr->dir = gsl_vector_view_array(data + 7 * ld_n + 2 * ld_m, nonbasic_n);
+    workspace_ptr->c_pert = gsl_vector_view_array(data + 7 * ld_n + 3 * ld_m, m);
+
+    if (workspace_ptr->keep_factor && workspace_ptr->factor.n == n) {
+        return 1;
+    }
+    workspace_ptr->keep_factor = 0;
+    return basis_factor_resize(&workspace_ptr->factor, n);
+}
+
+void simplex_workspace_free(simplex_workspace_t* workspace_ptr) {
+    if (!workspace_ptr) {
+        return;
+    }
+
+    basis_factor_free(&workspace_ptr->factor);
+    pricing_free(&workspace_ptr->pricing);
+    dual_pricing_free(&workspace_ptr->dual_pricing);
+    free(workspace_ptr->data);
+    free(workspace_ptr->state);
+    workspace_ptr->data = NULL;
+    workspace_ptr->state = NULL;
+    workspace_ptr->max_n = 0;
+    workspace_ptr->max_m = 0;
+}
@@ -1,5 +1,6 @@
 #include "solution.h"
 #include "utils.h"
+#include "kernels.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -19,6 +20,7 @@ uint32_t solution_init(solution_t* solution_ptr, uint32_t n, uint32_t m, uint32_
     solution_ptr->x = x;
     solution_ptr->z = 0.0;
     solution_ptr->is_unbounded = is_unbounded;
+    solution_ptr->is_infeasible = 0;
     solution_ptr->pI_iter = 0;
     solution_ptr->pII_iter = 0;
 
@@ -33,12 +35,17 @@ uint32_t solution_var_is_integer(const solution_t* solution_ptr, uint32_t i) {
 
     double xi = gsl_vector_get(solution_ptr->x, i);
     double diff = fabs(xi - round(xi));
-    return diff < 1e-8;
+    return diff < INTEGER_TOL;
 }
 
 uint32_t solution_is_integer(const solution_t* solution_ptr) {
+    const gsl_vector* x = solution_ptr->x;
+    if (x->stride == 1) {
+        return kernel_first_fractional(x->data, x->size, INTEGER_TOL) == -1;
+    }
+
     uint32_t is_integer = 1;
-    for (uint32_t i = 0; is_integer && i < solution_ptr->x->size; i++) {
+    for (uint32_t i = 0; is_integer && i < x->size; i++) {
         if (!solution_var_is_integer(solution_ptr, i)) {
             is_integer = 0;
         }
@@ -54,6 +61,11 @@ void solution_print(const solution_t* solution_ptr, const char* name) {
     }
 
     printf("\n================== %s ==================\n", name);
+    if (solution_ptr->is_infeasible) {
+        printf("infeasible\n");
+        return;
+    }
+
     if (solution_ptr->is_unbounded) {
         printf("infinite\n");
     } else {
@@ -82,6 +94,24 @@ void solution_free(solution_t* solution_ptr) {
     gsl_vector_free(solution_ptr->x);
 }
 
+uint32_t solution_truncate(solution_t* solution_ptr, uint32_t m) {
+    if (!solution_ptr || !solution_ptr->x || solution_ptr->m <= m) {
+        return 1;
+    }
+
+    gsl_vector* x = gsl_vector_alloc(m);
+    if (!x) {
+        return 0;
+    }
+    gsl_vector_const_view head = gsl_vector_const_subvector(solution_ptr->x, 0, m);
+    gsl_vector_memcpy(x, &head.vector);
+
+    gsl_vector_free(solution_ptr->x);
+    solution_ptr->x = x;
+    solution_ptr->m = m;
+    return 1;
+}
+
 /* GETTERS */
 const gsl_vector* solution_x(const solution_t* solution_ptr) {
     return solution_ptr ? solution_ptr->x : NULL;
@@ -99,6 +129,10 @@ uint32_t solution_is_unbounded(const solution_t* solution_ptr) {
     return solution_ptr ? solution_ptr->is_unbounded : 0;
 }
 
+uint32_t solution_is_infeasible(const solution_t* solution_ptr) {
+    return solution_ptr ? solution_ptr->is_infeasible : 0;
+}
+
 uint32_t solution_pI_iterations(const solution_t* solution_ptr) {
     return solution_ptr ? solution_ptr->pI_iter : 0;
 }
@@ -143,4 +177,13 @@ uint32_t solution_set_pII_iter(solution_t* solution_ptr, uint32_t pII_iter) {
 
     solution_ptr->pII_iter = pII_iter;
     return 1;
-}
\ No newline at end of file
+}
+
+uint32_t solution_set_infeasible(solution_t* solution_ptr, uint32_t is_infeasible) {
+    if (!solution_ptr) {
+        return 0;
+    }
+
+    solution_ptr->is_infeasible = is_infeasible;
+    return 1;
+}
@@ -0,0 +1,425 @@
+#include "sparse.h"
+#include "kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_NNZ_CAPACITY 16
+
+/* CSC */
+
+uint32_t csc_init(csc_matrix_t* A_ptr, uint32_t rows, uint32_t col_capacity, uint32_t nnz_capacity) {
+    if (!A_ptr) {
+        return 0;
+    }
+
+    if (nnz_capacity < MIN_NNZ_CAPACITY) {
+        nnz_capacity = MIN_NNZ_CAPACITY;
+    }
+
+    A_ptr->col_ptr = (uint32_t*)calloc(col_capacity + 1, sizeof(uint32_t));
+    A_ptr->row_idx = (uint32_t*)malloc(sizeof(uint32_t) * nnz_capacity);
+    A_ptr->values = (double*)malloc(sizeof(double) * nnz_capacity);
+    if (!A_ptr->col_ptr || !A_ptr->row_idx || !A_ptr->values) {
+        fprintf(stderr, "Failed to allocate csc matrix\n");
+        csc_free(A_ptr);
+        return 0;
+    }
+
+    A_ptr->rows = rows;
+    A_ptr->cols = 0;
+    A_ptr->col_capacity = col_capacity;
+    A_ptr->nnz_capacity = nnz_capacity;
+
+    return 1;
+}
+
+uint32_t csc_reserve(csc_matrix_t* A_ptr, uint32_t nnz) {
+    if (nnz <= A_ptr->nnz_capacity) {
+        return 1;
+    }
+
+    uint32_t capacity = A_ptr->nnz_capacity * 2;
+    if (capacity < nnz) {
+        capacity = nnz;
+    }
+
+    uint32_t* row_idx = (uint32_t*)realloc(A_ptr->row_idx, sizeof(uint32_t) * capacity);
+    if (!row_idx) {
+        return 0;
+    }
+    A_ptr->row_idx = row_idx;
+
+    double* values = (double*)realloc(A_ptr->values, sizeof(double) * capacity);
+    if (!values) {
+        return 0;
+    }
+    A_ptr->values = values;
+
+    A_ptr->nnz_capacity = capacity;
+    return 1;
+}
+
+uint32_t csc_copy(csc_matrix_t* dst_ptr, const csc_matrix_t* src_ptr, uint32_t cols, uint32_t col_capacity) {
+    if (!dst_ptr || !src_ptr || cols > src_ptr->cols || cols > col_capacity) {
+        return 0;
+    }
+
+    uint32_t nnz = src_ptr->col_ptr[cols];
+    if (!csc_init(dst_ptr, src_ptr->rows, col_capacity, nnz)) {
+        return 0;
+    }
+
+    memcpy(dst_ptr->col_ptr, src_ptr->col_ptr, sizeof(uint32_t) * (cols + 1));
+    memcpy(dst_ptr->row_idx, src_ptr->row_idx, sizeof(uint32_t) * nnz);
+    memcpy(dst_ptr->values, src_ptr->values, sizeof(double) * nnz);
+    dst_ptr->cols = cols;
+
+    return 1;
+}
+
+uint32_t csc_nnz(const csc_matrix_t* A_ptr) {
+    return A_ptr ? A_ptr->col_ptr[A_ptr->cols] : 0;
+}
+
+uint32_t csc_push_column(csc_matrix_t* A_ptr, const uint32_t* rows, const double* values, uint32_t length) {
+    if (!A_ptr || A_ptr->cols >= A_ptr->col_capacity || (length > 0 && (!rows || !values))) {
+        return 0;
+    }
+
+    uint32_t start = A_ptr->col_ptr[A_ptr->cols];
+    if (!csc_reserve(A_ptr, start + length)) {
+        fprintf(stderr, "Failed to grow csc matrix\n");
+        return 0;
+    }
+
+    memcpy(A_ptr->row_idx + start, rows, sizeof(uint32_t) * length);
+    memcpy(A_ptr->values + start, values, sizeof(double) * length);
+    A_ptr->cols++;
+    A_ptr->col_ptr[A_ptr->cols] = start + length;
+
+    return 1;
+}
+
+uint32_t csc_insert(csc_matrix_t* A_ptr, uint32_t i, uint32_t j, double value) {
+    if (!A_ptr || i >= A_ptr->rows || j >= A_ptr->cols) {
+        return 0;
+    }
+
+    // Find the position of row i inside column j
+    uint32_t k = A_ptr->col_ptr[j];
+    uint32_t end = A_ptr->col_ptr[j + 1];
+    while (k < end && A_ptr->row_idx[k] < i) {
+        k++;
+    }
+
+    if (k < end && A_ptr->row_idx[k] == i) {
+        A_ptr->values[k] = value;
+        return 1;
+    }
+
+    uint32_t nnz = csc_nnz(A_ptr);
+    if (!csc_reserve(A_ptr, nnz + 1)) {
+        fprintf(stderr, "Failed to grow csc matrix\n");
+        return 0;
+    }
+
+    memmove(A_ptr->row_idx + k + 1, A_ptr->row_idx + k, sizeof(uint32_t) * (nnz - k));
+    memmove(A_ptr->values + k + 1, A_ptr->values + k, sizeof(double) * (nnz - k));
+    A_ptr->row_idx[k] = i;
+    A_ptr->values[k] = value;
+
+    for (uint32_t c = j + 1; c <= A_ptr->cols; c++) {
+        A_ptr->col_ptr[c]++;
+    }
+
+    return 1;
+}
+
+void csc_truncate(csc_matrix_t* A_ptr, uint32_t rows, uint32_t cols) {
+    if (!A_ptr) {
+        return;
+    }
+
+    if (cols < A_ptr->cols) {
+        A_ptr->cols = cols;
+    }
+
+    if (rows < A_ptr->rows) {
+        // Compact the columns dropping the entries on the removed rows
+        uint32_t k = 0;
+        uint32_t start = A_ptr->col_ptr[0];
+        for (uint32_t j = 0; j < A_ptr->cols; j++) {
+            uint32_t end = A_ptr->col_ptr[j + 1];
+            for (uint32_t s = start; s < end; s++) {
+                if (A_ptr->row_idx[s] < rows) {
+                    A_ptr->row_idx[k] = A_ptr->row_idx[s];
+                    A_ptr->values[k] = A_ptr->values[s];
+                    k++;
+                }
+            }
+            start = end;
+            A_ptr->col_ptr[j + 1] = k;
+        }
+        A_ptr->rows = rows;
+    }
+}
+
+void csc_keep_columns(csc_matrix_t* A_ptr, const uint8_t* keep) {
+    if (!A_ptr || !keep) {
+        return;
+    }
+
+    uint32_t k = 0;
+    uint32_t cols = 0;
+    uint32_t start = A_ptr->col_ptr[0];
+    for (uint32_t j = 0; j < A_ptr->cols; j++) {
+        uint32_t end = A_ptr->col_ptr[j + 1];
+        if (keep[j]) {
+            for (uint32_t s = start; s < end; s++) {
+                A_ptr->row_idx[k] = A_ptr->row_idx[s];
+                A_ptr->values[k] = A_ptr->values[s];
+                k++;
+            }
+            A_ptr->col_ptr[++cols] = k;
+        }
+        start = end;
+    }
+    A_ptr->cols = cols;
+}
+
+double csc_get(const csc_matrix_t* A_ptr, uint32_t i, uint32_t j) {
+    if (!A_ptr || j >= A_ptr->cols) {
+        return 0.0;
+    }
+
+    // Binary search inside the column
+    uint32_t lo = A_ptr->col_ptr[j];
+    uint32_t hi = A_ptr->col_ptr[j + 1];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (A_ptr->row_idx[mid] < i) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < A_ptr->col_ptr[j + 1] && A_ptr->row_idx[lo] == i) {
+        return A_ptr->values[lo];
+    }
+
+    return 0.0;
+}
+
+void csc_column_scatter(const csc_matrix_t* A_ptr, uint32_t j, gsl_vector* v) {
+    gsl_vector_set_zero(v);
+    for (uint32_t k = A_ptr->col_ptr[j]; k < A_ptr->col_ptr[j + 1]; k++) {
+        gsl_vector_set(v, A_ptr->row_idx[k], A_ptr->values[k]);
+    }
+}
+
+double csc_column_dot(const csc_matrix_t* A_ptr, uint32_t j, const gsl_vector* v) {
+    uint32_t start = A_ptr->col_ptr[j];
+    if (v->stride == 1) {
+        return kernel_gather_dot(A_ptr->values + start, A_ptr->row_idx + start, A_ptr->col_ptr[j + 1] - start,
+                                 v->data);
+    }
+
+    double res = 0.0;
+    for (uint32_t k = A_ptr->col_ptr[j]; k < A_ptr->col_ptr[j + 1]; k++) {
+        res += A_ptr->values[k] * v->data[A_ptr->row_idx[k] * v->stride];
+    }
+
+    return res;
+}
+
+void csc_column_axpy(const csc_matrix_t* A_ptr, uint32_t j, double alpha, gsl_vector* v) {
+    for (uint32_t k = A_ptr->col_ptr[j]; k < A_ptr->col_ptr[j + 1]; k++) {
+        v->data[A_ptr->row_idx[k] * v->stride] += alpha * A_ptr->values[k];
+    }
+}
+
+void csc_scale_rows(csc_matrix_t* A_ptr, const gsl_vector* s) {
+    uint32_t nnz = csc_nnz(A_ptr);
+    for (uint32_t k = 0; k < nnz; k++) {
+        A_ptr->values[k] *= gsl_vector_get(s, A_ptr->row_idx[k]);
+    }
+}
+
+void csc_free(csc_matrix_t* A_ptr) {
+    if (!A_ptr) {
+        return;
+    }
+
+    free(A_ptr->col_ptr);
+    free(A_ptr->row_idx);
+    free(A_ptr->values);
+    A_ptr->col_ptr = NULL;
+    A_ptr->row_idx = NULL;
+    A_ptr->values = NULL;
+    A_ptr->rows = 0;
+    A_ptr->cols = 0;
+    A_ptr->col_capacity = 0;
+    A_ptr->nnz_capacity = 0;
+}
+
+/* CSR */
+
+uint32_t csr_init(csr_matrix_t* A_ptr, uint32_t cols, uint32_t row_capacity, uint32_t nnz_capacity) {
+    if (!A_ptr) {
+        return 0;
+    }
+
+    if (nnz_capacity < MIN_NNZ_CAPACITY) {
+        nnz_capacity = MIN_NNZ_CAPACITY;
+    }
+
+    A_ptr->row_ptr = (uint32_t*)calloc(row_capacity + 1, sizeof(uint32_t));
+    A_ptr->col_idx = (uint32_t*)malloc(sizeof(uint32_t) * nnz_capacity);
+    A_ptr->values = (double*)malloc(sizeof(double) * nnz_capacity);
+    if (!A_ptr->row_ptr || !A_ptr->col_idx || !A_ptr->values) {
+        fprintf(stderr, "Failed to allocate csr matrix\n");
+        csr_free(A_ptr);
+        return 0;
+    }
+
+    A_ptr->rows = 0;
+    A_ptr->cols = cols;
+    A_ptr->row_capacity = row_capacity;
+    A_ptr->nnz_capacity = nnz_capacity;
+
+    return 1;
+}
+
+uint32_t csr_push_row(csr_matrix_t* A_ptr, const uint32_t* cols, const double* values, uint32_t length) {
+    if (!A_ptr || A_ptr->rows >= A_ptr->row_capacity || (length > 0 && (!cols || !values))) {
+        return 0;
+    }
+
+    uint32_t start = A_ptr->row_ptr[A_ptr->rows];
+    if (start + length > A_ptr->nnz_capacity) {
+        uint32_t capacity = A_ptr->nnz_capacity * 2;
+        if (capacity < start + length) {
+            capacity = start + length;
+        }
+
+        uint32_t* col_idx = (uint32_t*)realloc(A_ptr->col_idx, sizeof(uint32_t) * capacity);
+        if (!col_idx) {
+            return 0;
+        }
+        A_ptr->col_idx = col_idx;
+
+        double* new_values = (double*)realloc(A_ptr->values, sizeof(double) * capacity);
+        if (!new_values) {
+            return 0;
+        }
+        A_ptr->values = new_values;
+
+        A_ptr->nnz_capacity = capacity;
+    }
+
+    memcpy(A_ptr->col_idx + start, cols, sizeof(uint32_t) * length);
+    memcpy(A_ptr->values + start, values, sizeof(double) * length);
+    A_ptr->rows++;
+    A_ptr->row_ptr[A_ptr->rows] = start + length;
+
+    return 1;
+}
+
+uint32_t csc_from_csr(csc_matrix_t* dst_ptr, const csr_matrix_t* src_ptr, uint32_t col_capacity) {
+    if (!dst_ptr || !src_ptr || src_ptr->cols > col_capacity) {
+        return 0;
+    }
+
+    uint32_t nnz = src_ptr->row_ptr[src_ptr->rows];
+    if (!csc_init(dst_ptr, src_ptr->rows, col_capacity, nnz)) {
+        return 0;
+    }
+
+    // Count the entries of each column
+    for (uint32_t k = 0; k < nnz; k++) {
+        dst_ptr->col_ptr[src_ptr->col_idx[k] + 1]++;
+    }
+    for (uint32_t j = 0; j < src_ptr->cols; j++) {
+        dst_ptr->col_ptr[j + 1] += dst_ptr->col_ptr[j];
+    }
+
+    // Scatter the rows in order, so every column comes out sorted
+    uint32_t* next = (uint32_t*)malloc(sizeof(uint32_t) * (src_ptr->cols + 1));
+    if (!next) {
+        csc_free(dst_ptr);
+        return 0;
+    }
+    memcpy(next, dst_ptr->col_ptr, sizeof(uint32_t) * (src_ptr->cols + 1));
+
+    for (uint32_t i = 0; i < src_ptr->rows; i++) {
+        for (uint32_t k = src_ptr->row_ptr[i]; k < src_ptr->row_ptr[i + 1]; k++) {
+            uint32_t pos = next[src_ptr->col_idx[k]]++;
+            dst_ptr->row_idx[pos] = i;
+            dst_ptr->values[pos] = src_ptr->values[k];
+        }
+    }
+
+    free(next);
+    dst_ptr->cols = src_ptr->cols;
+
+    return 1;
+}
+
+uint32_t csr_from_csc(csr_matrix_t* dst_ptr, const csc_matrix_t* src_ptr) {
+    if (!dst_ptr || !src_ptr) {
+        return 0;
+    }
+
+    uint32_t nnz = csc_nnz(src_ptr);
+    if (!csr_init(dst_ptr, src_ptr->cols, src_ptr->rows, nnz)) {
+        return 0;
+    }
+
+    // Count the entries of each row
+    for (uint32_t k = 0; k < nnz; k++) {
+        dst_ptr->row_ptr[src_ptr->row_idx[k] + 1]++;
+    }
+    for (uint32_t i = 0; i < src_ptr->rows; i++) {
+        dst_ptr->row_ptr[i + 1] += dst_ptr->row_ptr[i];
+    }
+
+    uint32_t* next = (uint32_t*)malloc(sizeof(uint32_t) * (src_ptr->rows + 1));
+    if (!next) {
+        csr_free(dst_ptr);
+        return 0;
+    }
+    memcpy(next, dst_ptr->row_ptr, sizeof(uint32_t) * (src_ptr->rows + 1));
+
+    for (uint32_t j = 0; j < src_ptr->cols; j++) {
+        for (uint32_t k = src_ptr->col_ptr[j]; k < src_ptr->col_ptr[j + 1]; k++) {
+            uint32_t pos = next[src_ptr->row_idx[k]]++;
+            dst_ptr->col_idx[pos] = j;
+            dst_ptr->values[pos] = src_ptr->values[k];
+        }
+    }
+
+    free(next);
+    dst_ptr->rows = src_ptr->rows;
+
+    return 1;
+}
+
+void csr_free(csr_matrix_t* A_ptr) {
+    if (!A_ptr) {
+        return;
+    }
+
+    free(A_ptr->row_ptr);
+    free(A_ptr->col_idx);
+    free(A_ptr->values);
+    A_ptr->row_ptr = NULL;
+    A_ptr->col_idx = NULL;
+    A_ptr->values = NULL;
+    A_ptr->rows = 0;
+    A_ptr->cols = 0;
+    A_ptr->row_capacity = 0;
+    A_ptr->nnz_capacity = 0;
+}
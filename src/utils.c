@@ -16,8 +16,8 @@ int32_t* calculate_nonbasis(int32_t* B, uint32_t n, uint32_t m) {
     }
 
     for (uint32_t i = 0; i < n; i++) {
-        if (B[i] >= (int32_t)m || used[B[i]]) {
-            fprintf(stderr, "Duplicate or invalid basis index %u\n", B[i]);
+        if (B[i] < 0 || B[i] >= (int32_t)m || used[B[i]]) {
+            fprintf(stderr, "Duplicate or invalid basis index %d\n", B[i]);
             free(used);
             return NULL;
         }
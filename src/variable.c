@@ -57,13 +57,17 @@ uint32_t variable_is_real(const variable_t* variable_ptr) {
 }
 
 uint32_t variable_is_integer(const variable_t* variable_ptr) {
-    return variable_ptr->type == VAR_INTEGER;
+    return variable_ptr->type == VAR_INTEGER || variable_ptr->type == VAR_BINARY;
 }
 
 uint32_t variable_is_binary(const variable_t* variable_ptr) {
     return variable_ptr->type == VAR_BINARY;
 }
 
+uint32_t variable_has_ub(const variable_t* variable_ptr) {
+    return variable_ptr->ub < VARIABLE_INF;
+}
+
 void variable_print(const variable_t* v) {
     if (!v) {
         return;
@@ -121,13 +125,13 @@ uint32_t var_arr_from_stream(var_arr_t* var_arr_ptr, FILE* stream, uint32_t capa
         } else {
             switch (type) {
                 case 0: {
-                    if (!variable_init_real_positive(&v, 10e9) || !var_arr_push(var_arr_ptr, &v)) {
+                    if (!variable_init_real_positive(&v, VARIABLE_INF) || !var_arr_push(var_arr_ptr, &v)) {
                         goto fail;
                     }
                     break;
                 }
                 case 1: {
-                    if (!variable_init_integer_positive(&v, 10e9) || !var_arr_push(var_arr_ptr, &v)) {
+                    if (!variable_init_integer_positive(&v, VARIABLE_INF) || !var_arr_push(var_arr_ptr, &v)) {
                         goto fail;
                     }
                     break;
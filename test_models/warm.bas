@@ -0,0 +1,2 @@
+2 4
+BBLL